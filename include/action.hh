@@ -23,10 +23,14 @@
 #include <Geant4/G4VUserActionInitialization.hh>
 #include <Geant4/G4UserEventAction.hh>
 #include <Geant4/G4UserRunAction.hh>
+#include <Geant4/G4UserStackingAction.hh>
 #include <Geant4/G4VUserPrimaryGeneratorAction.hh>
 #include <Geant4/G4Event.hh>
 #include <Geant4/G4Run.hh>
 
+#include <functional>
+
+#include "analysis.hh"
 #include "physics/Generator.hh"
 #include "ui.hh"
 
@@ -36,7 +40,8 @@ namespace MATHUSLA { namespace MU {
 class ActionInitialization : public G4VUserActionInitialization {
 public:
   ActionInitialization(const std::string& generator="",
-                       const std::string& data_dir="");
+                       const std::string& data_dir="",
+                       const bool quiet=false);
   void BuildForMaster() const;
   void Build() const;
 };
@@ -45,22 +50,97 @@ public:
 //__Event Action Manager________________________________________________________________________
 class EventAction : public G4UserEventAction {
 public:
-  EventAction(const size_t print_modulo);
+  EventAction(const double print_interval);
   void BeginOfEventAction(const G4Event* event);
+  void EndOfEventAction(const G4Event*);
   static const G4Event* GetEvent();
   static size_t EventID();
+
+  static void SetQuiet(const bool quiet);
+  static bool IsQuiet();
+  static void StartProgress(const size_t total);
+  static void StopProgress();
+
+  static bool FillDetectorData(const std::string& name,
+                               const Analysis::ROOT::DataKeyTypeList& types,
+                               const bool save_all,
+                               const std::function<double(int)>& threshold,
+                               const std::function<void(const std::string&)>& extend=nullptr);
 };
 //----------------------------------------------------------------------------------------------
 
 //__Run Action Manager__________________________________________________________________________
-class RunAction : public G4UserRunAction {
+class RunAction : public G4UserRunAction, public G4UImessenger {
 public:
   RunAction(const std::string& data_dir="");
+  ~RunAction();
   void BeginOfRunAction(const G4Run* run);
   void EndOfRunAction(const G4Run*);
+  void SetNewValue(G4UIcommand* command, G4String value);
   static const G4Run* GetRun();
   static size_t RunID();
   static size_t EventCount();
+
+  static void SetOutputFile(const std::string& path);
+  static void SetShard(const size_t index,
+                       const size_t count);
+  static size_t ShardIndex();
+  static size_t ShardCount();
+  static std::pair<size_t, size_t> ShardRange(const size_t total,
+                                              const size_t granularity=1UL);
+
+  static void RecordEvent(const int event_id);
+  static bool IsEventCompleted(const int event_id);
+  static bool IsResumed();
+  static bool Resume(const std::string& manifest);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::StringArg* _merge;
+  Command::StringArg* _digitize;
+  Command::DoubleUnitArg* _digi_window;
+  Command::StringArg* _aggregate;
+  Command::DoubleUnitArg* _aggregate_window;
+  Command::StringArg* _aggregate_position;
+  Command::StringArg* _columns;
+  Command::StringArg* _compression;
+  Command::IntegerArg* _compression_level;
+  Command::IntegerArg* _basket_size;
+  Command::BoolArg* _async;
+  Command::IntegerArg* _async_queue;
+  Command::IntegerArg* _checkpoint;
+  Command::DoubleArg* _checkpoint_time;
+  Command::StringArg* _format;
+  Command::IntegerArg* _row_group;
+  Command::IntegerArg* _batch;
+  Command::IntegerArg* _overlay;
+  Command::DoubleUnitArg* _overlay_rate;
+  Command::IntegerArg* _overlay_trigger;
+  Command::IntegerArg* _trigger_hits;
+  Command::IntegerArg* _trigger_layers;
+  Command::DoubleUnitArg* _trigger_deposit;
+  Command::DoubleUnitArg* _trigger_window;
+  Command::NoArg* _memory;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Stacking Action Manager_____________________________________________________________________
+class StackingAction : public G4UserStackingAction, public G4UImessenger {
+public:
+  StackingAction();
+  G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+  void NewStage();
+  void PrepareNewEvent();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::BoolArg*       _enable;
+  Command::BoolArg*       _early_abort;
+  Command::DoubleUnitArg* _em_threshold;
+  Command::DoubleUnitArg* _safety;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -71,13 +151,17 @@ public:
   void GeneratePrimaries(G4Event* event);
   void SetNewValue(G4UIcommand* command, G4String value);
   static const Physics::Generator* GetGenerator();
-  static Physics::ParticleVector GetLastEvent();
+  static Physics::ParticleView GetLastEvent();
   static void SetGenerator(const std::string& generator);
+  static void BeginOfRun();
+  static void SeedEvent(std::size_t run_id,
+                        int event_id);
 
 private:
   Command::NoArg*     _list;
   Command::NoArg*     _current;
   Command::StringArg* _select;
+  Command::StringArg* _replay;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -25,6 +25,8 @@
 
 #include <Geant4/g4root.hh>
 
+class TFile;
+
 namespace MATHUSLA { namespace MU {
 
 namespace Analysis { ///////////////////////////////////////////////////////////////////////////
@@ -178,6 +180,11 @@ bool Save(const std::string& path,
           SimSettingList entries);
 //----------------------------------------------------------------------------------------------
 
+//__Save Simulation Entries To Open File as Entries and Metadata Tree___________________________
+bool Save(TFile* file,
+          const SimSettingList& entries);
+//----------------------------------------------------------------------------------------------
+
 namespace ROOT { ///////////////////////////////////////////////////////////////////////////////
 
 //__Setup ROOT Analysis Tool____________________________________________________________________
@@ -192,14 +199,23 @@ bool Open(const std::string& path);
 bool Save();
 //----------------------------------------------------------------------------------------------
 
+//__Close Output Segment and Reopen Output File_________________________________________________
+bool Rotate(const std::string& path,
+            const std::string& segment);
+//----------------------------------------------------------------------------------------------
+
 //__Data Entry Types____________________________________________________________________________
 using DataEntryValueType = double;
 using DataEntry = std::vector<DataEntryValueType>;
 using DataEntryList = std::vector<DataEntry>;
+using IntegerDataEntry = std::vector<int>;
+using IntegerDataEntryList = std::vector<IntegerDataEntry>;
+using FloatDataEntry = std::vector<float>;
+using FloatDataEntryList = std::vector<FloatDataEntry>;
 using NameToDataMap = std::unordered_map<std::string, DataEntryValueType>;
 using DataKey = std::string;
 using DataKeyList = std::vector<DataKey>;
-enum class DataKeyType { Single, Vector };
+enum class DataKeyType { Single, Vector, Integer, IntegerVector, Float, FloatVector };
 using DataKeyTypeList = std::vector<DataKeyType>;
 static const DataKeyList DefaultDataKeyList{
   "N_HITS",
@@ -234,14 +250,14 @@ static const DataKeyList DefaultDataKeyList{
   "EXTRA_11", "EXTRA_12", "EXTRA_13", "EXTRA_14", "EXTRA_15"
 };
 static const DataKeyTypeList DefaultDataKeyTypeList{
-  DataKeyType::Single,
+  DataKeyType::Integer,
 
   DataKeyType::Vector,
   DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
+  DataKeyType::IntegerVector,
+  DataKeyType::IntegerVector,
+  DataKeyType::IntegerVector,
+  DataKeyType::IntegerVector,
   DataKeyType::Vector,
   DataKeyType::Vector,
   DataKeyType::Vector,
@@ -251,11 +267,11 @@ static const DataKeyTypeList DefaultDataKeyTypeList{
   DataKeyType::Vector,
   DataKeyType::Vector,
 
-  DataKeyType::Single,
+  DataKeyType::Integer,
 
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
+  DataKeyType::IntegerVector,
+  DataKeyType::IntegerVector,
+  DataKeyType::IntegerVector,
   DataKeyType::Vector,
   DataKeyType::Vector,
   DataKeyType::Vector,
@@ -285,17 +301,171 @@ static const DataKeyTypeList DefaultDataKeyTypeList{
 };
 //----------------------------------------------------------------------------------------------
 
+//__Default Data Column Offsets_________________________________________________________________
+constexpr std::size_t DefaultHitColumn       = 1UL;
+constexpr std::size_t DefaultGeneratorColumn = 16UL;
+constexpr std::size_t DefaultExtraColumn     = 28UL;
+//----------------------------------------------------------------------------------------------
+
+//__Store Floating Point Columns in Single Precision____________________________________________
+void SetSinglePrecision(const bool option);
+bool IsSinglePrecision();
+//----------------------------------------------------------------------------------------------
+
+//__Select NTuple Columns Written to File_______________________________________________________
+void SetColumnSelection(const DataKeyList& columns);
+const DataKeyList& GetColumnSelection();
+bool IsColumnSelected(const DataKey& column);
+//----------------------------------------------------------------------------------------------
+
+//__Write NTuple Rows on Background Thread______________________________________________________
+void SetAsyncWriting(const bool option);
+bool IsAsyncWriting();
+void SetAsyncQueueSize(const std::size_t size);
+std::size_t GetAsyncQueueSize();
+//----------------------------------------------------------------------------------------------
+
+//__Add RUN Column to NTuples for Batch Runs____________________________________________________
+void SetRunColumn(const bool option);
+bool HasRunColumn();
+void SetRunNumber(const int run);
+//----------------------------------------------------------------------------------------------
+
+//__Output File Compression and Basket Size_____________________________________________________
+bool SetCompressionAlgorithm(const std::string& algorithm);
+const std::string& GetCompressionAlgorithm();
+void SetCompressionLevel(const int level);
+int GetCompressionLevel();
+void SetBasketSize(const std::size_t size);
+std::size_t GetBasketSize();
+void ApplyCompression(TFile* file);
+//----------------------------------------------------------------------------------------------
+
 //__NTuple Initializer__________________________________________________________________________
 bool CreateNTuple(const std::string& name,
                   const DataKeyList& columns,
                   const DataKeyTypeList& types);
 //----------------------------------------------------------------------------------------------
 
+//__NTuple Real Vector Column___________________________________________________________________
+struct RealColumn {
+  DataEntry* real;
+  FloatDataEntry* real_float;
+
+  void reserve(const std::size_t size) {
+    if (real) real->reserve(size);
+    else if (real_float) real_float->reserve(size);
+  }
+
+  void push_back(const DataEntryValueType value) {
+    if (real) real->push_back(value);
+    else if (real_float) real_float->push_back(static_cast<float>(value));
+  }
+
+  template<class Iterator>
+  void append(Iterator first,
+              Iterator last) {
+    if (real) real->insert(real->end(), first, last);
+    else if (real_float) real_float->insert(real_float->end(), first, last);
+  }
+
+  void clear() {
+    if (real) real->clear();
+    else if (real_float) real_float->clear();
+  }
+
+  std::size_t size() const {
+    return real ? real->size() : real_float ? real_float->size() : 0UL;
+  }
+
+  std::size_t capacity_bytes() const {
+    return real       ? real->capacity() * sizeof(DataEntryValueType)
+         : real_float ? real_float->capacity() * sizeof(float) : 0UL;
+  }
+
+  DataEntryValueType operator[](const std::size_t index) const {
+    return real ? (*real)[index] : static_cast<DataEntryValueType>((*real_float)[index]);
+  }
+
+  void set(const std::size_t index,
+           const DataEntryValueType value) {
+    if (real) (*real)[index] = value;
+    else if (real_float) (*real_float)[index] = static_cast<float>(value);
+  }
+};
+//----------------------------------------------------------------------------------------------
+
+//__Get NTuple Vector Columns for In-Place Filling______________________________________________
+RealColumn GetRealColumn(const std::string& name,
+                         const std::size_t column);
+IntegerDataEntry* GetIntegerColumn(const std::string& name,
+                                   const std::size_t column);
+//----------------------------------------------------------------------------------------------
+
 //__Add Data to NTuple__________________________________________________________________________
 bool FillNTuple(const std::string& name,
                 const DataKeyTypeList& types,
-                const DataEntry& single_values,
-                const DataEntryList& vector_values);
+                const DataEntry& single_values);
+//----------------------------------------------------------------------------------------------
+
+//__Histogram Axis Binning______________________________________________________________________
+struct HistogramAxis {
+  std::size_t bins;
+  double min, max;
+
+  std::size_t bin(const double value) const {
+    if (!(value >= min)) return 0UL;
+    if (value >= max) return bins + 1UL;
+    const auto out = 1UL + static_cast<std::size_t>((value - min) / (max - min) * bins);
+    return out > bins ? bins : out;
+  }
+};
+//----------------------------------------------------------------------------------------------
+
+//__Thread-Local 2D Histogram Accumulator_______________________________________________________
+struct Histogram2D {
+  std::string name;
+  HistogramAxis x, y;
+  std::vector<double> counts;
+  std::size_t entries;
+  bool active;
+
+  void Fill(const double x_value,
+            const double y_value,
+            const double weight=1.0) {
+    counts[x.bin(x_value) + (x.bins + 2UL) * y.bin(y_value)] += weight;
+    ++entries;
+  }
+};
+//----------------------------------------------------------------------------------------------
+
+//__Histogram Initializer_______________________________________________________________________
+bool CreateHistogram(const std::string& name,
+                     const HistogramAxis& x,
+                     const HistogramAxis& y);
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread-Local Histogram for Filling______________________________________________________
+Histogram2D* GetHistogram(const std::string& name);
+//----------------------------------------------------------------------------------------------
+
+//__Reset Histograms of All Threads_____________________________________________________________
+void ResetHistograms();
+//----------------------------------------------------------------------------------------------
+
+//__Merge Histogram of All Threads______________________________________________________________
+bool MergeHistogram(const std::string& name,
+                    Histogram2D& out);
+//----------------------------------------------------------------------------------------------
+
+//__Write Histogram to File_____________________________________________________________________
+bool WriteHistogram(TFile* file,
+                    const Histogram2D& histogram,
+                    const std::string& name);
+//----------------------------------------------------------------------------------------------
+
+//__Merge Histograms of All Threads and Write to File___________________________________________
+std::size_t WriteHistograms(TFile* file);
 //----------------------------------------------------------------------------------------------
 
 } /* namespace ROOT */ /////////////////////////////////////////////////////////////////////////
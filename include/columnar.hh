@@ -0,0 +1,94 @@
+/*
+ * include/columnar.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__COLUMNAR_HH
+#define MU__COLUMNAR_HH
+#pragma once
+
+#include "analysis.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Analysis { ///////////////////////////////////////////////////////////////////////////
+
+namespace Columnar { ///////////////////////////////////////////////////////////////////////////
+
+//__Output Backend Format_______________________________________________________________________
+enum class Format { ROOT, Arrow, Parquet };
+//----------------------------------------------------------------------------------------------
+
+//__Columnar Backend Availability_______________________________________________________________
+bool Available();
+//----------------------------------------------------------------------------------------------
+
+//__Output Backend Format Selection_____________________________________________________________
+bool SetFormat(const Format format);
+Format GetFormat();
+const std::string FormatName(const Format format);
+const std::string Extension();
+//----------------------------------------------------------------------------------------------
+
+//__Rows per Record Batch or Row Group__________________________________________________________
+void SetRowGroupSize(const std::size_t rows);
+std::size_t GetRowGroupSize();
+//----------------------------------------------------------------------------------------------
+
+//__Path of Columnar Output Table_______________________________________________________________
+const std::string TablePath(const std::string& base,
+                            const std::string& name);
+//----------------------------------------------------------------------------------------------
+
+//__Open Columnar Output for Current Thread_____________________________________________________
+bool Open(const std::string& base);
+//----------------------------------------------------------------------------------------------
+
+//__Close Columnar Output for Current Thread____________________________________________________
+bool Close();
+//----------------------------------------------------------------------------------------------
+
+//__Close Current Output Segment for Current Thread_____________________________________________
+bool Rotate(const std::string& segment_base);
+//----------------------------------------------------------------------------------------------
+
+//__Columnar Table Initializer__________________________________________________________________
+bool CreateTable(const std::string& name,
+                 const ROOT::DataKeyList& columns,
+                 const ROOT::DataKeyTypeList& types,
+                 const std::vector<bool>& selected);
+//----------------------------------------------------------------------------------------------
+
+//__Attach Simulation Settings to Columnar File Metadata________________________________________
+void SetMetadata(const SimSettingList& entries);
+//----------------------------------------------------------------------------------------------
+
+//__Add Row to Columnar Table___________________________________________________________________
+bool AppendRow(const std::string& name,
+               const std::vector<std::size_t>& index,
+               const ROOT::DataEntry& single_values,
+               const ROOT::DataEntryList& real,
+               const ROOT::FloatDataEntryList& real_float,
+               const ROOT::IntegerDataEntryList& integer);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Columnar */ /////////////////////////////////////////////////////////////////////
+
+} /* namespace Analysis */ /////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__COLUMNAR_HH */
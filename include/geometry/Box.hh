@@ -32,7 +32,9 @@ public:
                const double length,
                const double height,
                const double width,
-               const double thickness);
+               const double thickness,
+               const double x_pitch=0.0,
+               const double y_pitch=0.0);
 
   struct Material {
     static G4Material* Casing;
@@ -48,6 +50,7 @@ public:
   double GetCasingThickness() const { return _thickness; }
   G4LogicalVolume* GetVolume() const { return _lvolume; }
   G4VPhysicalVolume* GetSensitiveVolume() const { return _sensitive; }
+  G4LogicalVolume* GetTileVolume() const { return _tile; }
 
   void Register(G4VSensitiveDetector* detector);
 
@@ -57,6 +60,7 @@ public:
 private:
   G4LogicalVolume* _lvolume;
   G4VPhysicalVolume* _sensitive;
+  G4LogicalVolume* _tile;
   std::string _name;
   double _length, _height, _width, _thickness;
 };
@@ -74,10 +78,18 @@ public:
   static const Analysis::ROOT::DataKeyList DataKeys;
   static const Analysis::ROOT::DataKeyTypeList DataKeyTypes;
 
+  static int EncodeDetector(const int x_index,
+                            const int y_index,
+                            const int z_index);
+  static int DetectorLayer(const int id);
+
   static G4VPhysicalVolume* Construct(G4LogicalVolume* world);
   static G4VPhysicalVolume* ConstructEarth(G4LogicalVolume* world);
+  static void Reset();
 
   static bool SaveAll;
+
+  constexpr static auto DigiThreshold = 0.69*MeV;
 };
 
 } /* namespace Box */ //////////////////////////////////////////////////////////////////////////
@@ -65,6 +65,37 @@ long double rotate_to_P1_z(long double x, long double z);
 std::pair<long double, long double> rotate_to_P1(long double x, long double z);
 //----------------------------------------------------------------------------------------------
 
+//__Fused Rotation and Translation______________________________________________________________
+struct Transform {
+  double rotation[3][3];
+  double translation[3];
+
+  template<class Point>
+  void apply(Point& point) const {
+    const auto x = point.x, y = point.y, z = point.z;
+    point.x = rotation[0][0] * x + rotation[0][1] * y + rotation[0][2] * z + translation[0];
+    point.y = rotation[1][0] * x + rotation[1][1] * y + rotation[1][2] * z + translation[1];
+    point.z = rotation[2][0] * x + rotation[2][1] * y + rotation[2][2] * z + translation[2];
+  }
+
+  template<class Iterator>
+  void apply(Iterator first,
+             Iterator last) const {
+    for (; first != last; ++first)
+      apply(*first);
+  }
+
+  void apply(std::size_t count,
+             double* x,
+             double* y,
+             double* z) const;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Transform from Collision Frame at IP to World Frame_________________________________________
+const Transform& CollisionTransform();
+//----------------------------------------------------------------------------------------------
+
 //__Cavern Logical Volumes______________________________________________________________________
 G4LogicalVolume* Volume();
 G4LogicalVolume* RingVolume();
@@ -19,11 +19,14 @@
 #define MU__GEOMETRY_CONSTRUCTION_HH
 #pragma once
 
+#include <functional>
+
 #include <Geant4/G4VSensitiveDetector.hh>
 #include <Geant4/G4VUserDetectorConstruction.hh>
 #include <Geant4/G4LogicalVolume.hh>
 #include <Geant4/G4VPhysicalVolume.hh>
 #include <Geant4/G4VisAttributes.hh>
+#include <Geant4/G4VisExtent.hh>
 #include <Geant4/G4Transform3D.hh>
 #include <Geant4/G4Box.hh>
 #include <Geant4/G4Trap.hh>
@@ -56,12 +59,26 @@ extern G4Material* Copper;
 extern G4Material* Iron;
 extern G4Material* PolystyreneFoam;
 extern G4Material* Polyvinyltoluene;
+
+//__Find or Define Process-Wide Material________________________________________________________
+G4Material* Intern(const std::string& name,
+                   const std::function<G4Material*(const std::string&)>& define);
+//----------------------------------------------------------------------------------------------
 } /* namespace Material */ /////////////////////////////////////////////////////////////////////
 
 //__Size of The World___________________________________________________________________________
 static constexpr const auto WorldLength = 1600*m;
 //----------------------------------------------------------------------------------------------
 
+//__Rock Region Names___________________________________________________________________________
+const std::vector<std::string>& RockRegions();
+//----------------------------------------------------------------------------------------------
+
+//__Layered Solid Construction Mode_____________________________________________________________
+bool LayeredSolids();
+bool LayeredSolids(const bool value);
+//----------------------------------------------------------------------------------------------
+
 //__Geometry Builder Class______________________________________________________________________
 class Builder : public G4VUserDetectorConstruction, public G4UImessenger {
 public:
@@ -77,17 +94,27 @@ public:
 
   static void SetDetector(const std::string& detector);
   static void SetSaveOption(const bool option);
+  static void SetCacheDirectory(const std::string& dir);
+  static void SetMaterialDump(const bool option);
+  static void SetQuiet(const bool quiet);
 
   static const std::string& GetDetectorName();
   static bool IsDetectorDataPerEvent();
   static const std::string& GetDetectorDataName();
   static const Analysis::ROOT::DataKeyList& GetDetectorDataKeys();
   static const Analysis::ROOT::DataKeyTypeList& GetDetectorDataKeyTypes();
+  static const G4VisExtent& GetDetectorExtent();
 
 private:
   Command::NoArg*     _list;
   Command::NoArg*     _current;
   Command::StringArg* _select;
+  Command::StringArg* _cache;
+  Command::BoolArg*   _layered;
+  Command::DoubleUnitArg* _sandstone_cut;
+  Command::DoubleUnitArg* _marl_cut;
+  Command::DoubleUnitArg* _mix_cut;
+  Command::DoubleUnitArg* _cavern_cut;
 };
 //----------------------------------------------------------------------------------------------
 
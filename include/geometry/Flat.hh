@@ -110,10 +110,16 @@ public:
   static const Analysis::ROOT::DataKeyList DataKeys;
   static const Analysis::ROOT::DataKeyTypeList DataKeyTypes;
 
+  static int DetectorLayer(const int id);
+
   static G4VPhysicalVolume* Construct(G4LogicalVolume* world);
   static G4VPhysicalVolume* ConstructEarth(G4LogicalVolume* world);
+  static void Reset();
 
   static bool SaveAll;
+
+  constexpr static auto MinDeposit    = 0*keV;
+  constexpr static auto DigiThreshold = 0.69*MeV;
 };
 
 } /* namespace Flat */ /////////////////////////////////////////////////////////////////////////
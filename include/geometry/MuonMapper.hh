@@ -46,9 +46,37 @@ public:
 
   static G4VPhysicalVolume* Construct(G4LogicalVolume* world);
   static G4VPhysicalVolume* ConstructEarth(G4LogicalVolume* world);
+  static void Reset();
 
   static bool SaveAll;
+
+  static const std::string& MapName;
+  constexpr static std::size_t MapRBins    = 500;
+  constexpr static double      MapRMax     = 500;
+  constexpr static std::size_t MapLogBBins = 120;
+  constexpr static double      MapLogBMax  = 6;
+};
+
+//__Adaptive Energy-Angle Sweep Driver__________________________________________________________
+class Sweep : public G4UImessenger {
+public:
+  Sweep();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  void Run();
+
+  Command::StringArg*  _energies;
+  Command::StringArg*  _angles;
+  Command::IntegerArg* _events;
+  Command::IntegerArg* _max_events;
+  Command::DoubleArg*  _target;
+  Command::StringArg*  _output;
+  Command::NoArg*      _start;
 };
+//----------------------------------------------------------------------------------------------
 
 } /* namespace MuonMapper */ ///////////////////////////////////////////////////////////////////
 
@@ -21,6 +21,7 @@
 
 #include <vector>
 
+#include "Geant4/G4Transform3D.hh"
 #include "Geant4/G4VSensitiveDetector.hh"
 
 #include "geometry/Construction.hh"
@@ -63,6 +64,8 @@ public:
                               const Scintillator* sci,
                               const G4ThreeVector translation,
                               const G4RotationMatrix rotation);
+  static PMTPoint PMTDistance(const G4ThreeVector& local_position,
+                              const Scintillator* sci);
 
   static Scintillator* Clone(const Scintillator* other);
 
@@ -81,6 +84,9 @@ public:
 
   const static Info InfoArray[Count];
 
+  static PMTPoint PMTDistance(const G4ThreeVector& local_position,
+                              const Info& info);
+
   constexpr static auto Thickness =  1.0*mm;
   constexpr static auto Spacing   = 0.15*mm;
   constexpr static auto Depth     = 15.0*mm;
@@ -90,6 +96,8 @@ public:
 
   constexpr static auto MinDeposit =  0*keV;
   constexpr static auto MaxDeposit = 10*MeV;
+
+  constexpr static auto DigiThreshold = 0.69*MeV;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -178,6 +186,8 @@ public:
   constexpr static auto MinDeposit =  0*keV;
   constexpr static auto MaxDeposit = 10*MeV;
 
+  constexpr static auto DigiThreshold = 0.17*keV;
+
 private:
   G4LogicalVolume* _volume;
   std::vector<Pad*> _pads;
@@ -188,6 +198,18 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+//__Sensitive Volume with Cached Global Transform_______________________________________________
+struct SensitiveVolume {
+  int id;
+  std::string name;
+  const G4VPhysicalVolume* volume;
+  const Scintillator* scintillator;
+  G4Transform3D global, to_local;
+};
+//----------------------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
 class Detector : public G4VSensitiveDetector {
 public:
   Detector();
@@ -198,6 +220,7 @@ public:
 
   static int EncodeDetector(const std::string& name);
   static const std::string DecodeDetector(int id);
+  static int DetectorLayer(const int id);
 
   static const bool DataPerEvent = true;
   static const std::string& DataName;
@@ -206,6 +229,11 @@ public:
 
   static G4VPhysicalVolume* Construct(G4LogicalVolume* world);
   static G4VPhysicalVolume* ConstructEarth(G4LogicalVolume* world);
+  static void Reset();
+  static void IndexVolumes(const G4VPhysicalVolume* world,
+                           const std::vector<G4LogicalVolume*>& sensitive);
+
+  static const std::vector<SensitiveVolume>& SensitiveVolumes();
 
   static bool SaveAll;
 };
@@ -0,0 +1,167 @@
+/*
+ * include/perf.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PERF_HH
+#define MU__PERF_HH
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace MATHUSLA { namespace MU {
+
+namespace Perf { ///////////////////////////////////////////////////////////////////////////////
+
+//__Timed Stages________________________________________________________________________________
+enum Stage : std::size_t {
+  Generator,
+  Event,
+  Conversion,
+  Fill,
+  Merge,
+  StageCount
+};
+//----------------------------------------------------------------------------------------------
+
+//__Counted Quantities__________________________________________________________________________
+enum Counter : std::size_t {
+  Events,
+  ProcessHits,
+  Hits,
+  EarlyAborts,
+  WriteStalls,
+  Frames,
+  RejectedFrames,
+  TriggerAccepted,
+  TriggerRejected,
+  CounterCount
+};
+//----------------------------------------------------------------------------------------------
+
+//__Memory Categories___________________________________________________________________________
+enum Memory : std::size_t {
+  GeometryMemory,
+  PhysicsMemory,
+  HitMemory,
+  GeneratorMemory,
+  MemoryCount
+};
+//----------------------------------------------------------------------------------------------
+
+//__Stage, Counter, and Memory Names____________________________________________________________
+extern const std::array<std::string, StageCount> StageNames;
+extern const std::array<std::string, CounterCount> CounterNames;
+extern const std::array<std::string, MemoryCount> MemoryNames;
+//----------------------------------------------------------------------------------------------
+
+//__Clock Type__________________________________________________________________________________
+using Clock = std::chrono::steady_clock;
+//----------------------------------------------------------------------------------------------
+
+//__Thread Local Performance Record_____________________________________________________________
+struct Record {
+  std::array<Clock::duration, StageCount> time{};
+  std::array<std::size_t, StageCount> calls{};
+  std::array<std::size_t, CounterCount> counts{};
+  std::array<Clock::time_point, StageCount> start{};
+  std::array<std::size_t, MemoryCount> memory{};
+  std::size_t resident_mark{};
+  int thread{};
+};
+//----------------------------------------------------------------------------------------------
+
+//__Performance Record for Current Thread_______________________________________________________
+Record& Local();
+//----------------------------------------------------------------------------------------------
+
+//__Begin and End Stage Timer___________________________________________________________________
+inline void Begin(const Stage stage) {
+  Local().start[stage] = Clock::now();
+}
+inline void End(const Stage stage) {
+  auto& record = Local();
+  record.time[stage] += Clock::now() - record.start[stage];
+  ++record.calls[stage];
+}
+//----------------------------------------------------------------------------------------------
+
+//__Increment Counter___________________________________________________________________________
+inline void Count(const Counter counter,
+                  const std::size_t amount=1UL) {
+  Local().counts[counter] += amount;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Scoped Stage Timer__________________________________________________________________________
+class Scope {
+public:
+  explicit Scope(const Stage stage) : _stage(stage) { Begin(stage); }
+  ~Scope() { End(_stage); }
+private:
+  Stage _stage;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Reset Current Thread Record_________________________________________________________________
+void Reset();
+//----------------------------------------------------------------------------------------------
+
+//__Resident Memory of Process in Bytes_________________________________________________________
+std::size_t ResidentBytes();
+//----------------------------------------------------------------------------------------------
+
+//__Mark Resident Memory for Current Thread_____________________________________________________
+void MarkMemory();
+//----------------------------------------------------------------------------------------------
+
+//__Attribute Resident Growth since Mark to Category____________________________________________
+void MeasureMemory(const Memory category,
+                   const bool accumulate=false);
+//----------------------------------------------------------------------------------------------
+
+//__Set Memory in Category for Current Thread___________________________________________________
+void SetMemory(const Memory category,
+               const std::size_t bytes);
+//----------------------------------------------------------------------------------------------
+
+//__Sum Records over All Threads________________________________________________________________
+const Record Collect();
+//----------------------------------------------------------------------------------------------
+
+//__Seconds Spent in Stage______________________________________________________________________
+double Seconds(const Record& record,
+               const Stage stage);
+//----------------------------------------------------------------------------------------------
+
+//__Print Performance Summary Table_____________________________________________________________
+void Print(std::ostream& os,
+           const Record& record);
+//----------------------------------------------------------------------------------------------
+
+//__Print Memory Table per Thread_______________________________________________________________
+void PrintMemory(std::ostream& os);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Perf */ /////////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PERF_HH */
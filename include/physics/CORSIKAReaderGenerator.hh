@@ -20,6 +20,9 @@
 #define MU__PHYSICS_CORSIKA_READER_GENERATOR_HH
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include "Generator.hh"
 
 namespace MATHUSLA { namespace MU {
@@ -64,6 +67,24 @@ struct CORSIKAEvent {
                  double new_weight);
   void push_back(const Particle& particle, double weight);
   const Particle operator[](const std::size_t index) const;
+
+  void build_index();
+  void select(double x_min,
+              double x_max,
+              double y_min,
+              double y_max,
+              std::vector<std::size_t>& out) const;
+
+  double cell_x0, cell_y0, cell_size;
+  std::size_t cell_nx, cell_ny;
+  std::vector<std::size_t> cell_offset, cell_index;
+};
+//----------------------------------------------------------------------------------------------
+
+//__CORSIKA Shower with Configuration__________________________________________________________
+struct CORSIKAShower {
+  CORSIKAConfig config;
+  CORSIKAEvent event;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -71,29 +92,54 @@ struct CORSIKAEvent {
 using CORSIKAEventVector = std::vector<CORSIKAEvent>;
 //----------------------------------------------------------------------------------------------
 
+//__Read CORSIKA Shower from ROOT File__________________________________________________________
+void ReadCORSIKAShower(const std::string& path,
+                       const Particle& origin,
+                       CORSIKAConfig& config,
+                       CORSIKAEvent& event);
+//----------------------------------------------------------------------------------------------
+
 //__CORSIKA Simulation Generator________________________________________________________________
 class CORSIKAReaderGenerator : public Generator {
 public:
   CORSIKAReaderGenerator(const std::string& path);
 
   void GeneratePrimaryVertex(G4Event* event);
-  virtual ParticleVector GetLastEvent() const;
+  virtual ParticleView GetLastEvent() const;
   void SetNewValue(G4UIcommand* command,
                    G4String value);
   void SetFile(const std::string& path);
+  bool NextShower();
+  virtual std::size_t SubEventCount() const { return _split; }
+  virtual bool IsEventIndexed() const { return !_stream || _split > 1UL; }
+  virtual void BeginOfRun();
+  virtual std::size_t BufferBytes() const;
 
   virtual const Analysis::SimSettingList GetSpecification() const;
-  virtual const std::vector<std::vector<double>> ExtraDetails() const;
+  virtual const std::vector<std::vector<double>>& ExtraDetails() const;
 
 private:
   ParticleVector _last_event;
-  CORSIKAEvent _event;
+  std::vector<std::vector<double>> _extra;
+  std::shared_ptr<const CORSIKAEvent> _event;
   CORSIKAConfig _config;
   std::pair<double, double> _translation;
   std::string _path;
+  bool _stream;
+  std::size_t _read_ahead;
+  std::deque<CORSIKAShower> _stream_buffer;
+  bool _cull;
+  double _cull_margin;
+  std::size_t _split;
+  std::vector<std::size_t> _selection;
   Command::StringArg* _read_file;
   Command::DoubleUnitArg* _set_max_radius;
   Command::IntegerArg* _set_event_id;
+  Command::BoolArg* _set_stream;
+  Command::IntegerArg* _set_read_ahead;
+  Command::BoolArg* _set_cull;
+  Command::DoubleUnitArg* _set_cull_margin;
+  Command::IntegerArg* _set_split;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -9,10 +9,45 @@
 #include <string>
 #include <iostream>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace MATHUSLA { namespace MU { namespace Physics {
 
+// On-disk record of the binary particle parameters format. A binary file is the
+// 8-byte ParticleFile::Magic, a std::uint64_t record count, and then the records.
+struct ParticleRecord {
+  std::int64_t id;
+  double x, y, z, px, py, pz;
+};
+
+// Read-only particle parameters, memory-mapped for binary files or parsed once for
+// text files, and shared by every worker thread reading the same path.
+class ParticleFile {
+public:
+  static const char Magic[8];
+
+  static std::shared_ptr<ParticleFile> Open(const std::string &pathname);
+
+  ~ParticleFile();
+
+  std::size_t size() const { return _size; }
+  const Particle operator[](const std::size_t index) const;
+
+private:
+  ParticleFile();
+
+  void *_mapping = nullptr;
+  std::size_t _mapping_size = 0;
+  std::vector<ParticleRecord> _owned;
+  const ParticleRecord *_records = nullptr;
+  std::size_t _size = 0;
+};
+
+std::vector<ParticleRecord> ReadParticleTextFile(const std::string &pathname);
+void WriteParticleBinaryFile(const std::string &pathname, const std::vector<ParticleRecord> &records);
+
 class FileReaderGenerator : public Generator {
 public:
   FileReaderGenerator(const std::string &name, const std::string &description);
@@ -27,8 +62,7 @@ public:
 protected:
   virtual void GenerateCommands();
 
-  std::size_t _event_counter = 0;
-  std::vector<Particle> _particle_parameters;
+  std::shared_ptr<ParticleFile> _particle_file;
 
   Command::StringArg *_ui_pathname;
 };
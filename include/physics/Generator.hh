@@ -20,6 +20,10 @@
 #define MU__PHYSICS_GENERATOR_HH
 #pragma once
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 #include <Geant4/G4Event.hh>
 #include <Geant4/G4PrimaryVertex.hh>
 #include <Geant4/G4PrimaryParticle.hh>
@@ -68,6 +72,27 @@ bool InPropagationList(const PropagationList& list,
                        const BasicParticle& particle);
 //----------------------------------------------------------------------------------------------
 
+//__Compiled Propagation List Filter____________________________________________________________
+class PropagationFilter {
+public:
+  PropagationFilter() = default;
+  PropagationFilter(const PropagationList& list);
+
+  bool empty() const { return _windows.empty(); }
+  bool contains(int id) const;
+  bool operator()(int id,
+                  const PseudoLorentzTriplet& triplet) const;
+  bool operator()(const BasicParticle& particle) const;
+
+private:
+  struct Window {
+    PseudoLorentzTriplet min, max;
+    bool pT, eta, phi;
+  };
+  std::unordered_map<int, std::vector<Window>> _windows;
+};
+//----------------------------------------------------------------------------------------------
+
 //__Default Vertex for IP_______________________________________________________________________
 G4PrimaryVertex* DefaultVertex();
 //----------------------------------------------------------------------------------------------
@@ -82,12 +107,17 @@ public:
   virtual ~Generator() = default;
 
   virtual void GeneratePrimaryVertex(G4Event* event);
-  virtual ParticleVector GetLastEvent() const;
+  virtual ParticleView GetLastEvent() const;
   virtual void SetNewValue(G4UIcommand* command,
                            G4String value);
   virtual std::ostream& Print(std::ostream& os=std::cout) const;
   virtual const Analysis::SimSettingList GetSpecification() const;
-  virtual const std::vector<std::vector<double>> ExtraDetails() const;
+  virtual const std::vector<std::vector<double>>& ExtraDetails() const;
+  virtual void SetEventSeed(std::uint64_t) {}
+  virtual void BeginOfRun() {}
+  virtual std::size_t SubEventCount() const { return 1UL; }
+  virtual bool IsEventIndexed() const { return true; }
+  virtual std::size_t BufferBytes() const { return GetLastEvent().size() * sizeof(Particle); }
 
   const Particle& particle() const { return _particle; }
   const std::string& name() const { return _name; }
@@ -113,6 +143,7 @@ protected:
   Command::DoubleUnitArg*      _ui_p_mag;
   Command::DoubleUnitArg*      _ui_t0;
   Command::ThreeVectorUnitArg* _ui_vertex;
+  Command::DoubleArg*          _ui_weight;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -130,7 +161,7 @@ public:
   virtual ~RangeGenerator() = default;
 
   virtual void GeneratePrimaryVertex(G4Event* event);
-  virtual ParticleVector GetLastEvent() const;
+  virtual ParticleView GetLastEvent() const;
   virtual void SetNewValue(G4UIcommand* command,
                            G4String value);
   virtual std::ostream& Print(std::ostream& os=std::cout) const;
@@ -142,8 +173,15 @@ public:
 protected:
   virtual void GenerateCommands();
 
+  struct BiasWindow {
+    double min, max;
+    bool on;
+  };
+
   Particle _min, _max;
   bool _using_range_ke;
+  double _bias_fraction;
+  BiasWindow _pT_bias, _eta_bias, _phi_bias, _ke_bias;
   Command::DoubleUnitArg* _ui_pT_min;
   Command::DoubleUnitArg* _ui_pT_max;
   Command::DoubleArg*     _ui_eta_min;
@@ -152,6 +190,15 @@ protected:
   Command::DoubleUnitArg* _ui_phi_max;
   Command::DoubleUnitArg* _ui_ke_min;
   Command::DoubleUnitArg* _ui_ke_max;
+  Command::DoubleArg*     _ui_bias_fraction;
+  Command::DoubleUnitArg* _ui_pT_bias_min;
+  Command::DoubleUnitArg* _ui_pT_bias_max;
+  Command::DoubleArg*     _ui_eta_bias_min;
+  Command::DoubleArg*     _ui_eta_bias_max;
+  Command::DoubleUnitArg* _ui_phi_bias_min;
+  Command::DoubleUnitArg* _ui_phi_bias_max;
+  Command::DoubleUnitArg* _ui_ke_bias_min;
+  Command::DoubleUnitArg* _ui_ke_bias_max;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -20,41 +20,39 @@
 #define MU__PHYSICS_HEPMCGENERATOR_HH
 #pragma once
 
-// #include <HepMC/HepMC.h>
-// #include <HepMC/ReaderAscii.h>
-// #include <HepMC/ReaderRoot.h>
-
 #include "physics/Generator.hh"
 
 namespace MATHUSLA { namespace MU {
 
 namespace Physics { ////////////////////////////////////////////////////////////////////////////
 
-/*
-
+//__HepMC3 File Reader Generator________________________________________________________________
 class HepMCGenerator : public Generator {
 public:
-  HepMCGenerator(const PropagationList& propagation,
-                 bool unique_events=true);
+  HepMCGenerator(const PropagationList& propagation);
 
-  const PropagationList GetPropagationList() const { return _propagation_list; };
-  bool UsingUniqueEvents() const { return _unique; }
-  void SetNewValue(G4UIcommand* command, G4String value);
   void GeneratePrimaryVertex(G4Event* event);
+  ParticleView GetLastEvent() const;
+  void SetNewValue(G4UIcommand* command,
+                   G4String value);
+  void SetFile(const std::string& path);
+  bool IsEventIndexed() const { return false; }
 
   virtual const Analysis::SimSettingList GetSpecification() const;
 
-protected:
-  // TODO: union { HepMC::ReaderAscii* ascii; HepMC::ReaderRoot* root; } _reader;
-  // HepMC::ReaderAscii* _reader;
-  bool _using_root_reader;
+private:
+  ParticleVector _last_event;
   PropagationList _propagation_list;
-  // HepMC::GenEvent _current_event;
-  bool _unique;
-  Command::StringArg* _read_file;
+  PropagationFilter _propagation_filter;
+  std::string _path;
+  std::size_t _read_ahead;
+  int _event_number;
+  Command::StringArg*  _read_file;
+  Command::IntegerArg* _set_read_ahead;
+  Command::StringArg*  _add_cut;
+  Command::NoArg*      _clear_cuts;
 };
-
-*/
+//----------------------------------------------------------------------------------------------
 
 } /* namespace Physics */ //////////////////////////////////////////////////////////////////////
 
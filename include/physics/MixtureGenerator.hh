@@ -0,0 +1,76 @@
+/*
+ * include/physics/MixtureGenerator.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_MIXTUREGENERATOR_HH
+#define MU__PHYSICS_MIXTUREGENERATOR_HH
+#pragma once
+
+#include <unordered_map>
+
+#include "physics/Generator.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+//__Map of Named Generators_____________________________________________________________________
+using GeneratorMap = std::unordered_map<std::string, Generator*>;
+//----------------------------------------------------------------------------------------------
+
+//__Rate-Weighted Mixture of Generators_________________________________________________________
+class MixtureGenerator : public Generator {
+public:
+  MixtureGenerator(const GeneratorMap& generators);
+
+  void GeneratePrimaryVertex(G4Event* event);
+  ParticleView GetLastEvent() const;
+  void SetNewValue(G4UIcommand* command,
+                   G4String value);
+  std::ostream& Print(std::ostream& os=std::cout) const;
+  void SetEventSeed(std::uint64_t seed);
+  std::size_t BufferBytes() const;
+  bool IsEventIndexed() const;
+  void BeginOfRun();
+
+  virtual const Analysis::SimSettingList GetSpecification() const;
+  virtual const std::vector<std::vector<double>>& ExtraDetails() const;
+
+  bool AddComponent(const std::string& name,
+                    const double rate);
+  void ClearComponents();
+
+private:
+  struct Component {
+    std::string name;
+    Generator* generator;
+    double rate, cumulative;
+  };
+
+  const GeneratorMap& _generators;
+  std::vector<Component> _components;
+  Generator* _current;
+  Command::StringArg* _add;
+  Command::NoArg*     _clear;
+};
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_MIXTUREGENERATOR_HH */
@@ -0,0 +1,82 @@
+/* include/physics/MuonTransport.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_MUONTRANSPORT_HH
+#define MU__PHYSICS_MUONTRANSPORT_HH
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <Geant4/G4VFastSimulationModel.hh>
+
+#include "ui.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+//__Tabulated Muon Transport Through Rock_______________________________________________________
+// Table rows are "E_in[GeV] X[g/cm2] E_out[GeV] R[m] theta[rad]", one detailed-simulation
+// sample per muon, where X is the column density crossed, R the lateral displacement at exit
+// and theta the angular deflection. E_out <= 0 marks a muon which stopped in the rock.
+class MuonTransportModel : public G4VFastSimulationModel, public G4UImessenger {
+public:
+  MuonTransportModel();
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle);
+  G4bool ModelTrigger(const G4FastTrack& track);
+  void DoIt(const G4FastTrack& track, G4FastStep& step);
+
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  bool Load(const std::string& path);
+  static void SetRegistered(const bool registered);
+  static void Attach(const std::vector<std::string>& regions);
+
+  static const std::string MessengerDirectory;
+
+  struct Sample {
+    double energy_in, depth, energy_out, displacement, deflection;
+  };
+
+  struct Transport {
+    bool stopped;
+    double loss, displacement, deflection;
+  };
+
+  Transport Interpolate(const double energy, const double depth) const;
+
+private:
+  const Sample& _sample(const std::size_t energy_bin, const double depth) const;
+
+  bool _enabled;
+  std::vector<Sample> _samples;
+  std::vector<std::vector<std::size_t>> _bins;
+  double _log_energy_min, _log_energy_width;
+  double _depth_min, _depth_width;
+
+  Command::BoolArg*   _enable;
+  Command::StringArg* _table;
+};
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_MUONTRANSPORT_HH */
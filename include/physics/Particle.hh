@@ -125,6 +125,7 @@ struct Vertex {
 //__Momentum Vertex Particle____________________________________________________________________
 struct Particle : BasicParticle {
   double t, x, y, z;
+  double weight = 1.0;
 
   Particle() = default;
 
@@ -184,11 +185,39 @@ struct Particle : BasicParticle {
 using ParticleVector = std::vector<Particle>;
 //----------------------------------------------------------------------------------------------
 
+//__Non-Owning View of Contiguous Particles_____________________________________________________
+class ParticleView {
+public:
+  ParticleView() : _first(nullptr), _size(0UL) {}
+  ParticleView(const Particle* first,
+               const std::size_t size) : _first(first), _size(size) {}
+  ParticleView(const ParticleVector& particles) : ParticleView(particles.data(), particles.size()) {}
+
+  const Particle* begin() const { return _first; }
+  const Particle* end() const { return _first + _size; }
+  std::size_t size() const { return _size; }
+  bool empty() const { return !_size; }
+  const Particle& operator[](const std::size_t index) const { return _first[index]; }
+
+private:
+  const Particle* _first;
+  std::size_t _size;
+};
+//----------------------------------------------------------------------------------------------
+
 //__Add Momentum and Vertex Particle To Event___________________________________________________
 void AddParticle(const Particle& particle,
                  G4Event& event);
 //----------------------------------------------------------------------------------------------
 
+//__Add Range of Particles To Event Sharing Vertices____________________________________________
+void AddParticles(const Particle* first,
+                  const Particle* last,
+                  G4Event& event);
+void AddParticles(const ParticleVector& particles,
+                  G4Event& event);
+//----------------------------------------------------------------------------------------------
+
 namespace Filter { /////////////////////////////////////////////////////////////////////////////
 
 //__Sign Enum___________________________________________________________________________________
@@ -20,13 +20,17 @@
 #define MU__PHYSICS_PYTHIAGENERATOR_HH
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <Pythia8/Pythia.h>
 #include <Pythia8/Event.h>
 
 #include "physics/Generator.hh"
+#include "util/queue.hh"
 
 namespace MATHUSLA { namespace MU {
 
@@ -44,13 +48,18 @@ public:
   PythiaGenerator(Pythia8::Pythia* pythia=nullptr);
   PythiaGenerator(const std::vector<std::string>& settings);
   PythiaGenerator(const std::string& path);
+  ~PythiaGenerator();
 
   void GeneratePrimaryVertex(G4Event* event);
-  ParticleVector GetLastEvent() const;
+  ParticleView GetLastEvent() const;
   void SetNewValue(G4UIcommand* command, G4String value);
   void SetPythia(Pythia8::Pythia* pythia);
   void SetPythia(const std::vector<std::string>& settings);
   void SetPythia(const std::string& path);
+  void StartProducer();
+  void StopProducer();
+  void SetEventSeed(std::uint64_t seed);
+  bool IsEventIndexed() const { return !_async; }
 
   virtual const Analysis::SimSettingList GetSpecification() const;
 
@@ -58,16 +67,37 @@ private:
   static G4ThreadLocal Pythia8::Pythia* _pythia;
   static G4ThreadLocal std::vector<std::string>* _pythia_settings;
   static G4ThreadLocal bool _settings_on;
+
+  struct ProducedEvent {
+    ParticleVector last_event;
+    ParticleVector propagate;
+    std::uint_fast64_t trials;
+  };
+
   PropagationList _propagation_list;
+  PropagationFilter _propagation_filter;
   ParticleVector _last_event;
+  std::vector<std::size_t> _selected;
   std::uint_fast64_t _counter;
+  std::uint64_t _event_seed;
   std::string _path;
+  std::vector<std::string> _built_settings;
+  std::string _built_path;
+  std::string _cache_dir;
   std::string _process_string;
+  bool _async;
+  std::size_t _queue_size;
+  std::unique_ptr<util::queue::blocking<ProducedEvent>> _queue;
+  std::atomic<bool> _producing;
+  std::thread _producer;
   Command::StringArg* _add_cut;
   Command::NoArg*     _clear_cuts;
   Command::StringArg* _read_string;
   Command::StringArg* _read_file;
   Command::StringArg* _process;
+  Command::BoolArg*    _set_async;
+  Command::IntegerArg* _set_queue_size;
+  Command::StringArg*  _set_cache;
 };
 //----------------------------------------------------------------------------------------------
 
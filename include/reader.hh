@@ -0,0 +1,119 @@
+/*
+ * include/reader.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__READER_HH
+#define MU__READER_HH
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MATHUSLA { namespace MU {
+
+namespace Reader { /////////////////////////////////////////////////////////////////////////////
+
+//__Ntuple Column Types_________________________________________________________________________
+enum class ColumnType { Unknown, Real, Float, Integer, RealVector, FloatVector, IntegerVector };
+//----------------------------------------------------------------------------------------------
+
+//__Ntuple Column Description___________________________________________________________________
+struct Column {
+  std::string name;
+  ColumnType type;
+};
+using Schema = std::vector<Column>;
+//----------------------------------------------------------------------------------------------
+
+//__Missing Column Index________________________________________________________________________
+constexpr auto npos = static_cast<std::size_t>(-1);
+//----------------------------------------------------------------------------------------------
+
+//__Typed Column Values of Current Entry________________________________________________________
+// Columns are in the order they were requested. Float columns are widened to double, and
+// missing columns are Unknown and stay empty.
+struct Row {
+  Schema schema;
+  std::vector<double> real;
+  std::vector<std::vector<double>> reals;
+  std::vector<std::vector<int>> integers;
+  std::string path;
+  std::size_t file, worker;
+  long long entry;
+
+  std::size_t Index(const std::string& name) const;
+  double Real(const std::size_t column) const { return real[column]; }
+  int Integer(const std::size_t column) const { return static_cast<int>(real[column]); }
+  const std::vector<double>& Reals(const std::size_t column) const { return reals[column]; }
+  const std::vector<int>& Integers(const std::size_t column) const { return integers[column]; }
+  std::size_t Size(const std::size_t column) const;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Row Function Type___________________________________________________________________________
+using RowFunction = std::function<void(const Row&)>;
+//----------------------------------------------------------------------------------------------
+
+//__Simulation Metadata Entries_________________________________________________________________
+using Metadata = std::vector<std::pair<std::string, std::string>>;
+//----------------------------------------------------------------------------------------------
+
+//__Collect Simulation Files under Path_________________________________________________________
+std::vector<std::string> FindFiles(const std::string& path,
+                                   const std::string& extension="root");
+//----------------------------------------------------------------------------------------------
+
+//__Name of First Detector Tree in File_________________________________________________________
+const std::string DefaultTree(const std::string& path);
+//----------------------------------------------------------------------------------------------
+
+//__Read Column Types of Tree___________________________________________________________________
+Schema ReadSchema(const std::string& path,
+                  const std::string& tree);
+//----------------------------------------------------------------------------------------------
+
+//__Read Simulation Metadata____________________________________________________________________
+Metadata ReadMetadata(const std::string& path);
+//----------------------------------------------------------------------------------------------
+
+//__TTree Cache Size in Bytes___________________________________________________________________
+void SetCacheSize(const long long bytes);
+long long GetCacheSize();
+//----------------------------------------------------------------------------------------------
+
+//__Traverse Tree Entries of Files in Parallel__________________________________________________
+// Files are handed out to the worker threads one at a time, and every worker reads only the
+// requested columns through its own tree cache. The function is called concurrently from all
+// workers, keep one accumulator per Row::worker. Returns the number of entries read.
+std::size_t Traverse(const std::vector<std::string>& paths,
+                     const std::string& tree,
+                     const std::vector<std::string>& columns,
+                     const RowFunction& function,
+                     const std::size_t threads=1UL);
+//----------------------------------------------------------------------------------------------
+
+//__Column Type Name____________________________________________________________________________
+const std::string TypeName(const ColumnType type);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Reader */ ///////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__READER_HH */
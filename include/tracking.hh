@@ -20,7 +20,10 @@
 #define MU__TRACKING_HH
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <ostream>
+#include <vector>
 
 #include <Geant4/G4Allocator.hh>
 #include <Geant4/G4THitsCollection.hh>
@@ -57,13 +60,16 @@ public:
   Hit(const G4ParticleDefinition* particle,
       const int track,
       const int parent,
-      const std::string& chamber,
+      const int detector,
       const double deposit,
       const G4LorentzVector position,
       const G4LorentzVector momentum);
 
   Hit(const G4Step* step, bool post=true);
 
+  void Absorb(const Hit& other,
+              const bool weighted=false);
+
   void Draw();
   void Print(std::ostream& os=std::cout) const;
   void Print();
@@ -72,7 +78,7 @@ public:
   int                    GetPDGEncoding()  const { return _particle->GetPDGEncoding();  }
   int                    GetTrackID()      const { return _trackID;                     }
   int                    GetParentID()     const { return _parentID;                    }
-  const std::string&     GetChamberID()    const { return _chamberID;                   }
+  int                    GetDetectorID()   const { return _detectorID;                  }
   double                 GetDeposit()      const { return _deposit;                     }
   const G4LorentzVector& GetPosition()     const { return _position;                    }
   const G4LorentzVector& GetMomentum()     const { return _momentum;                    }
@@ -94,7 +100,7 @@ private:
   const G4ParticleDefinition* _particle;
   int _trackID;
   int _parentID;
-  std::string _chamberID;
+  int _detectorID;
   double _deposit;
   G4LorentzVector _position;
   G4LorentzVector _momentum;
@@ -116,25 +122,237 @@ HitCollection* GenerateHitCollection(G4VSensitiveDetector* detector,
                                      G4HCofThisEvent* event);
 //----------------------------------------------------------------------------------------------
 
-//__Convert HitCollection to Analysis Form______________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const HitCollection* collection);
+//__Check if Hit Collection is Required for Printing or Visualization___________________________
+bool IsHitCollectionRequired(const int verbose_level);
+//----------------------------------------------------------------------------------------------
+
+//__Hit Aggregation Mode________________________________________________________________________
+enum class AggregationMode { Off, Track, Window };
+void SetAggregationMode(const AggregationMode mode);
+AggregationMode GetAggregationMode();
+//----------------------------------------------------------------------------------------------
+
+//__Hit Aggregation Time Window_________________________________________________________________
+void SetAggregationWindow(const double window);
+double GetAggregationWindow();
+//----------------------------------------------------------------------------------------------
+
+//__Hit Aggregation Energy-Weighted Position____________________________________________________
+void SetAggregationWeighted(const bool weighted);
+bool IsAggregationWeighted();
+//----------------------------------------------------------------------------------------------
+
+//__Per-Event Index of Aggregated Hits__________________________________________________________
+class HitAggregator {
+public:
+  static constexpr auto npos = static_cast<std::size_t>(-1);
+
+  std::size_t Find(const int detector,
+                   const int track,
+                   const double time) const;
+  void Insert(const int detector,
+              const int track,
+              const double time,
+              const std::size_t index);
+  void Clear() { ++_generation; _size = 0UL; }
+  std::size_t GetMemoryBytes() const { return _slots.capacity() * sizeof(Slot); }
+
+private:
+  struct Slot {
+    std::uint64_t key;
+    std::size_t index;
+    double time;
+    std::uint64_t generation;
+  };
+  std::size_t Probe(const std::uint64_t key) const;
+  void Grow();
+
+  std::vector<Slot> _slots;
+  std::size_t _size{};
+  std::uint64_t _generation = 1ULL;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Hit Buffer Contents Detached from NTuple Columns____________________________________________
+struct HitData {
+  std::vector<double> deposit, time;
+  std::vector<int> detector, pdg, track, parent;
+  std::vector<double> x, y, z, e, px, py, pz, weight;
+
+  void clear() {
+    for (auto column : {&deposit, &time, &x, &y, &z, &e, &px, &py, &pz, &weight})
+      column->clear();
+    for (auto column : {&detector, &pdg, &track, &parent})
+      column->clear();
+  }
+};
+//----------------------------------------------------------------------------------------------
+
+//__Struct-of-Arrays Event Hit Buffer___________________________________________________________
+class HitBuffer {
+public:
+  void Attach(const std::string& name,
+              const std::size_t first_column=Analysis::ROOT::DefaultHitColumn);
+  void Clear();
+
+  void Append(const int pdg,
+              const int track,
+              const int parent,
+              const int detector,
+              const double deposit,
+              const G4LorentzVector& position,
+              const G4LorentzVector& momentum,
+              const double weight=1.0);
+
+  void Append(const G4Step* step,
+              const int detector,
+              const bool post=true);
+
+  std::size_t GetSize() const { return _size; }
+  double GetDeposit(const std::size_t index) const { return _deposit[index]; }
+  double GetTime(const std::size_t index) const { return _time[index]; }
+  int GetDetector(const std::size_t index) const { return _detector ? (*_detector)[index] : 0; }
+  std::size_t GetMemoryBytes() const;
+
+  void Extract(HitData& out) const;
+  void Restore(const HitData& data);
+
+private:
+  void Merge(const std::size_t index,
+             const int pdg,
+             const int track,
+             const int parent,
+             const double deposit,
+             const G4LorentzVector& position,
+             const G4LorentzVector& momentum,
+             const double weight);
+
+  HitAggregator _aggregator;
+  Analysis::ROOT::RealColumn _deposit, _time;
+  Analysis::ROOT::IntegerDataEntry *_detector, *_pdg, *_track, *_parent;
+  Analysis::ROOT::RealColumn _x, _y, _z, _e, _px, _py, _pz, _weight;
+  std::size_t _size;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread-Local Event Hit Buffer___________________________________________________________
+HitBuffer& GetHitBuffer();
+//----------------------------------------------------------------------------------------------
+
+//__Attach Thread-Local Hit Buffers to Detector NTuples_________________________________________
+void AttachHitBuffers(const std::string& name);
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread-Local Digitized Hit Buffer_______________________________________________________
+HitBuffer& GetDigitizedHitBuffer();
+//----------------------------------------------------------------------------------------------
+
+//__Digitization Mode___________________________________________________________________________
+enum class DigitizationMode { Off, Beside, Instead };
+void SetDigitizationMode(const DigitizationMode mode);
+DigitizationMode GetDigitizationMode();
+//----------------------------------------------------------------------------------------------
+
+//__Digitization Time Window____________________________________________________________________
+void SetDigitizationWindow(const double window);
+double GetDigitizationWindow();
+//----------------------------------------------------------------------------------------------
+
+//__Name of Digitized Data Tree_________________________________________________________________
+const std::string DigitizedDataName(const std::string& name);
+//----------------------------------------------------------------------------------------------
+
+//__Digitize Hits by Detector and Time Window___________________________________________________
+void Digitize(const HitData& hits,
+              const std::function<double(int)>& threshold,
+              HitData& out);
+//----------------------------------------------------------------------------------------------
+
+//__Mark Current Event as Part of Split Logical Event___________________________________________
+void SetSubEvent(const std::size_t key,
+                 const std::size_t count,
+                 const std::size_t part=0UL);
+bool InSubEvent();
+//----------------------------------------------------------------------------------------------
+
+//__Merge Sub-Event Hits and Particles into Logical Event_______________________________________
+bool MergeSubEvent(Physics::ParticleVector& particles);
+//----------------------------------------------------------------------------------------------
+
+//__Drop Incomplete Logical Events______________________________________________________________
+void ClearSubEvents();
+//----------------------------------------------------------------------------------------------
+
+//__Events Overlaid into One Readout Frame______________________________________________________
+void SetOverlayEvents(const std::size_t count);
+std::size_t GetOverlayEvents();
+bool InOverlay();
+//----------------------------------------------------------------------------------------------
+
+//__Overlay Event Rate__________________________________________________________________________
+void SetOverlayRate(const double rate);
+double GetOverlayRate();
+//----------------------------------------------------------------------------------------------
+
+//__Minimum Hits in Written Readout Frame_______________________________________________________
+void SetOverlayTrigger(const std::size_t hits);
+std::size_t GetOverlayTrigger();
+//----------------------------------------------------------------------------------------------
+
+//__Overlay Event into Thread-Local Readout Frame_______________________________________________
+bool OverlayEvent(Physics::ParticleVector& particles,
+                  const std::uint64_t stream);
+//----------------------------------------------------------------------------------------------
+
+//__Drop Incomplete Readout Frame of Current Thread_____________________________________________
+void ClearOverlay();
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Hit Multiplicity and Distinct Layers________________________________________________
+void SetTriggerHits(const std::size_t hits);
+std::size_t GetTriggerHits();
+void SetTriggerLayers(const std::size_t layers);
+std::size_t GetTriggerLayers();
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Hit Deposit Threshold_______________________________________________________________
+void SetTriggerDeposit(const double deposit);
+double GetTriggerDeposit();
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Coincidence Time Window_____________________________________________________________
+void SetTriggerWindow(const double window);
+double GetTriggerWindow();
+//----------------------------------------------------------------------------------------------
+
+//__Detector Layer Function for Trigger_________________________________________________________
+void SetTriggerLayerFunction(const std::function<int(int)>& layer);
+//----------------------------------------------------------------------------------------------
+
+//__Check if Trigger Selects More than Any Hit__________________________________________________
+bool IsTriggerEnabled();
 //----------------------------------------------------------------------------------------------
 
-//__Convert HitCollection to Analysis Form______________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const HitCollection* collection,
-                                                      const Analysis::ROOT::NameToDataMap& map);
+//__Evaluate Trigger on Hit Buffer______________________________________________________________
+bool Trigger(const HitBuffer& buffer);
 //----------------------------------------------------------------------------------------------
 
 //__Convert G4Event to Analysis Form____________________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const G4Event* event);
+std::size_t ConvertToAnalysis(const G4Event* event,
+                              const std::string& name,
+                              const std::size_t first_column=Analysis::ROOT::DefaultGeneratorColumn);
 //----------------------------------------------------------------------------------------------
 
 //__Convert ParticleVector to Analysis Form_____________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const Physics::ParticleVector& particles);
+std::size_t ConvertToAnalysis(const Physics::ParticleView particles,
+                              const std::string& name,
+                              const std::size_t first_column=Analysis::ROOT::DefaultGeneratorColumn);
 //----------------------------------------------------------------------------------------------
 
 //__Convert Extra to Analysis Form______________________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const std::vector<std::vector<double>>& extra);
+std::size_t ConvertToAnalysis(const std::vector<std::vector<double>>& extra,
+                              const std::string& name,
+                              const std::size_t first_column=Analysis::ROOT::DefaultExtraColumn);
 //----------------------------------------------------------------------------------------------
 
 //__Empty Extra Vector__________________________________________________________________________
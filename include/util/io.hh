@@ -21,10 +21,13 @@
 #pragma once
 
 #include <cstdio>
+#include <string>
 #include <sys/stat.h>
 
 #if defined(_WIN32)
 #include <windows.h>
+#else
+#include <unistd.h>
 #endif
 
 namespace MATHUSLA {
@@ -60,6 +63,25 @@ inline bool rename_file(const std::string& path, const std::string& new_path) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Unique Token of Current Process_____________________________________________________________
+inline std::string process_token() {
+  char host[256] = {};
+  #if defined(_WIN32)
+    DWORD size = sizeof(host);
+    GetComputerNameA(host, &size);
+    const auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+  #else
+    gethostname(host, sizeof(host) - 1);
+    const auto pid = static_cast<unsigned long>(getpid());
+  #endif
+  std::string out(host);
+  for (auto& c : out)
+    if (c == '/' || c == '\\' || c == ' ' || c == '.')
+      c = '-';
+  return (out.empty() ? "" : out + '_') + std::to_string(pid);
+}
+//----------------------------------------------------------------------------------------------
+
 } } /* namespace util::io */ ///////////////////////////////////////////////////////////////////
 
 } /* namespace MATHUSLA */
@@ -0,0 +1,110 @@
+/*
+ * include/util/queue.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL__QUEUE_HH
+#define UTIL__QUEUE_HH
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+namespace MATHUSLA {
+
+namespace util { namespace queue { /////////////////////////////////////////////////////////////
+
+//__Bounded Blocking Queue______________________________________________________________________
+// Producers and consumers sleep on condition variables instead of spinning. Closing the
+// queue wakes both sides: push then fails, and pop fails once the queue is drained, or
+// rethrows the error the queue was closed with.
+template<class T>
+class blocking {
+public:
+  explicit blocking(std::size_t capacity) : _capacity(capacity), _closed(false) {}
+
+  bool push(T&& value) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_full.wait(lock, [&]() { return _closed || _items.size() < _capacity; });
+    if (_closed)
+      return false;
+    _items.push_back(std::move(value));
+    lock.unlock();
+    _not_empty.notify_one();
+    return true;
+  }
+
+  bool pop(T& value) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_empty.wait(lock, [&]() { return _closed || !_items.empty(); });
+    if (_items.empty()) {
+      if (_error)
+        std::rethrow_exception(_error);
+      return false;
+    }
+    value = std::move(_items.front());
+    _items.pop_front();
+    lock.unlock();
+    _not_full.notify_one();
+    return true;
+  }
+
+  void close(std::exception_ptr error=nullptr) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _closed = true;
+      if (error && !_error)
+        _error = error;
+    }
+    _not_full.notify_all();
+    _not_empty.notify_all();
+  }
+
+  bool try_pop(T& value) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_items.empty())
+      return false;
+    value = std::move(_items.front());
+    _items.pop_front();
+    lock.unlock();
+    _not_full.notify_one();
+    return true;
+  }
+
+  std::size_t capacity() const {
+    return _capacity;
+  }
+
+private:
+  const std::size_t _capacity;
+  std::deque<T> _items;
+  bool _closed;
+  std::exception_ptr _error;
+  std::mutex _mutex;
+  std::condition_variable _not_full;
+  std::condition_variable _not_empty;
+};
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace util::queue */ ////////////////////////////////////////////////////////////////
+
+} /* namespace MATHUSLA */
+
+#endif /* UTIL__QUEUE_HH */
@@ -20,15 +20,163 @@
 #define UTIL__RANDOM_HH
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <random>
+#include <vector>
 
 namespace MATHUSLA {
 
 namespace util { namespace random { ////////////////////////////////////////////////////////////
 
-//__Get Default Mersene Twister_________________________________________________________________
+//__Philox4x32-10 Counter-Based Random Engine__________________________________________________
+class philox {
+public:
+  using result_type = std::uint32_t;
+
+  explicit philox(std::uint64_t key=0ULL,
+                  std::uint64_t stream=0ULL) {
+    seed(key, stream);
+  }
+
+  void seed(std::uint64_t key,
+            std::uint64_t stream=0ULL) {
+    _key = {static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)};
+    _counter = {0U, 0U, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)};
+    _index = 4U;
+  }
+
+  result_type operator()() {
+    if (_index == 4U) {
+      _output = _block(_counter, _key);
+      if (++_counter[0] == 0U)
+        ++_counter[1];
+      _index = 0U;
+    }
+    return _output[_index++];
+  }
+
+  void discard(std::uint64_t count) {
+    for (; count; --count)
+      (*this)();
+  }
+
+  static constexpr result_type min() { return 0U; }
+  static constexpr result_type max() { return 0xFFFFFFFFU; }
+
+private:
+  using block = std::array<std::uint32_t, 4>;
+  using key   = std::array<std::uint32_t, 2>;
+
+  static block _round(const block& counter,
+                      const key& k) {
+    const auto product0 = static_cast<std::uint64_t>(0xD2511F53U) * counter[0];
+    const auto product1 = static_cast<std::uint64_t>(0xCD9E8D57U) * counter[2];
+    return {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ k[0],
+            static_cast<std::uint32_t>(product1),
+            static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ k[1],
+            static_cast<std::uint32_t>(product0)};
+  }
+
+  static block _block(block counter,
+                      key k) {
+    for (int round = 0; round < 10; ++round) {
+      counter = _round(counter, k);
+      k[0] += 0x9E3779B9U;
+      k[1] += 0xBB67AE85U;
+    }
+    return counter;
+  }
+
+  key _key;
+  block _counter;
+  block _output;
+  unsigned _index;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Mix Seed Components into Stream Key_________________________________________________________
+inline std::uint64_t mix(std::uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+template<class... Ts>
+std::uint64_t mix(std::uint64_t x,
+                  std::uint64_t y,
+                  Ts... rest) {
+  return mix(mix(x) ^ y, rest...);
+}
+//----------------------------------------------------------------------------------------------
+
+namespace detail { /////////////////////////////////////////////////////////////////////////////
+
+//__Global Run Seed and Stream Counter__________________________________________________________
+inline std::atomic<std::uint64_t>& run_seed_storage() {
+  static std::atomic<std::uint64_t> seed{0ULL};
+  return seed;
+}
+inline std::atomic<std::uint64_t>& stream_counter() {
+  static std::atomic<std::uint64_t> counter{0ULL};
+  return counter;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Thread-Local Stream Engine__________________________________________________________________
+struct thread_state {
+  std::uint64_t stream = stream_counter().fetch_add(1ULL);
+  philox engine{run_seed_storage().load(), stream};
+};
+inline thread_state& local_state() {
+  thread_local thread_state state;
+  return state;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace detail */ ///////////////////////////////////////////////////////////////////////
+
+//__Set and Get Global Run Seed_________________________________________________________________
+inline void set_run_seed(std::uint64_t seed) {
+  detail::run_seed_storage() = seed;
+}
+inline std::uint64_t run_seed() {
+  return detail::run_seed_storage().load();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread-Local Counter-Based Engine_______________________________________________________
+inline philox& engine() {
+  return detail::local_state().engine;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Thread-Local Engine to Stream Derived From Run Seed___________________________________
+inline void set_thread_stream(std::uint64_t stream) {
+  auto& state = detail::local_state();
+  state.stream = stream;
+  state.engine.seed(run_seed(), stream);
+}
+template<class... Ts>
+void seed_stream(std::uint64_t first,
+                 Ts... rest) {
+  detail::local_state().engine.seed(run_seed(), mix(first, static_cast<std::uint64_t>(rest)...));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Convert Engine Output to Double in [0, 1)___________________________________________________
+template<class Generator>
+double canonical(Generator&& gen) {
+  const auto high = static_cast<std::uint64_t>(gen()) << 21;
+  const auto low  = static_cast<std::uint64_t>(gen()) >> 11;
+  return (high ^ low) * (1.0 / 9007199254740992.0);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread-Local Mersene Twister____________________________________________________________
 inline std::mt19937& mersene_twister() {
-  static std::mt19937 mt(std::random_device{}());
+  thread_local std::mt19937 mt(static_cast<std::mt19937::result_type>(mix(run_seed(), detail::local_state().stream)));
   return mt;
 }
 //----------------------------------------------------------------------------------------------
@@ -70,25 +218,33 @@ const std::vector<typename Distribution::result_type> sample_many(std::size_t co
 //----------------------------------------------------------------------------------------------
 
 //__Sample a Uniform Distribution Once__________________________________________________________
-template<class Generator=std::mt19937>
-double uniform(double a = 0.0,
-               double b = 1.0,
-               Generator&& gen=std::forward<Generator>(mersene_twister())) {
-  static std::uniform_real_distribution<> distribution(0, 1);
-  using Dist = decltype(distribution);
-  return sample(std::forward<Dist>(distribution), typename Dist::param_type{a, b}, std::forward<Generator>(gen));
+template<class Generator>
+double uniform(double a,
+               double b,
+               Generator&& gen) {
+  return a + (b - a) * canonical(gen);
+}
+inline double uniform(double a = 0.0,
+                      double b = 1.0) {
+  return uniform(a, b, engine());
 }
 //----------------------------------------------------------------------------------------------
 
 //__Sample a Uniform Distribution Many Times____________________________________________________
-template<class Generator=std::mt19937>
-double uniform_vector(std::size_t n,
-                      double a = 0.0,
-                      double b = 1.0,
-                      Generator&& gen=std::forward<Generator>(mersene_twister())) {
-  static std::uniform_real_distribution<> distribution(0, 1);
-  using Dist = decltype(distribution);
-  return sample_many(n, std::forward<Dist>(distribution), typename Dist::param_type{a, b}, std::forward<Generator>(gen));
+template<class Generator>
+const std::vector<double> uniform_vector(std::size_t n,
+                                         double a,
+                                         double b,
+                                         Generator&& gen) {
+  std::vector<double> out(n);
+  for (auto& x : out)
+    x = a + (b - a) * canonical(gen);
+  return out;
+}
+inline const std::vector<double> uniform_vector(std::size_t n,
+                                                double a = 0.0,
+                                                double b = 1.0) {
+  return uniform_vector(n, a, b, engine());
 }
 //----------------------------------------------------------------------------------------------
 
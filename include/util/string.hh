@@ -20,6 +20,7 @@
 #define UTIL__STRING_HH
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace MATHUSLA {
@@ -114,6 +115,43 @@ inline std::string toupper(const std::string& string) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Parse Whole String as Integer_______________________________________________________________
+inline bool to_long(const std::string& string,
+                    long& out) {
+  try {
+    std::size_t end{};
+    out = std::stol(string, &end);
+    return end == string.size();
+  } catch (...) {
+    return false;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Parse Whole String as Floating Point________________________________________________________
+inline bool to_double(const std::string& string,
+                      double& out) {
+  try {
+    std::size_t end{};
+    out = std::stod(string, &end);
+    return end == string.size();
+  } catch (...) {
+    return false;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stable 64-bit FNV-1a Hash of String_________________________________________________________
+inline std::uint64_t fnv1a(const std::string& string) {
+  std::uint64_t out = 0xCBF29CE484222325ULL;
+  for (const unsigned char c : string) {
+    out ^= c;
+    out *= 0x100000001B3ULL;
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
 } } /* namespace util::string */ ///////////////////////////////////////////////////////////////
 
 } /* namespace MATHUSLA */
@@ -1,6 +1,8 @@
 #!/usr/bin/env python3
 # -*- coding: utf-8 -*- #
 
+# NOTE: superseded by the in-simulation '/data/digitize' command, kept for existing data files.
+
 import os
 import sys
 
@@ -52,7 +54,7 @@ def digitize(path, file, tree):
 DTYPE = [
     ("Deposit", "float64"),
     ("Time", "float64"),
-    ("Detector", "float64"),
+    ("Detector", "int"),
     ("PDG", "int"),
     ("Track", "int"),
     ("Parent", "int"),
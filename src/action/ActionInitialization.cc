@@ -26,27 +26,36 @@ namespace { ////////////////////////////////////////////////////////////////////
 std::string _generator;
 std::string _data_dir;
 //----------------------------------------------------------------------------------------------
+
+//__Generator State of Master Thread____________________________________________________________
+GeneratorAction* _master_generator = nullptr;
+//----------------------------------------------------------------------------------------------
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Action Initialization Constructor___________________________________________________________
 ActionInitialization::ActionInitialization(const std::string& generator,
-                                           const std::string& data_dir)
+                                           const std::string& data_dir,
+                                           const bool quiet)
     : G4VUserActionInitialization() {
   _generator = generator;
   _data_dir = data_dir;
+  EventAction::SetQuiet(quiet);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Build for Thread Master_____________________________________________________________________
 void ActionInitialization::BuildForMaster() const {
   SetUserAction(new RunAction(_data_dir));
+  if (!_master_generator)
+    _master_generator = new GeneratorAction(_generator);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Build for Threads___________________________________________________________________________
 void ActionInitialization::Build() const {
   SetUserAction(new RunAction(_data_dir));
-  SetUserAction(new EventAction(100));
+  SetUserAction(new EventAction(5.0));
+  SetUserAction(new StackingAction);
   SetUserAction(new GeneratorAction(_generator));
 }
 //----------------------------------------------------------------------------------------------
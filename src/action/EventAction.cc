@@ -17,33 +17,117 @@
 
 #include "action.hh"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <Geant4/G4AutoLock.hh>
 #include <Geant4/G4MTRunManager.hh>
 #include <Geant4/tls.hh>
 
+#include "perf.hh"
+#include "tracking.hh"
+
+#include "util/random.hh"
+
 namespace MATHUSLA { namespace MU {
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
-//__Printing Frequency for Event Count__________________________________________________________
-G4ThreadLocal size_t _print_modulo;
+
+//__Progress Reporting Interval_________________________________________________________________
+std::chrono::duration<double> _print_interval{5.0};
 G4ThreadLocal uint_fast64_t _event_id{};
+bool _quiet{};
+//----------------------------------------------------------------------------------------------
+
+//__Per-Thread Event Counters___________________________________________________________________
+std::vector<std::atomic<std::size_t>*> _counters;
+G4ThreadLocal std::atomic<std::size_t>* _counter = nullptr;
+G4Mutex _counter_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Get Counter for Current Thread______________________________________________________________
+std::atomic<std::size_t>& _local_counter() {
+  if (!_counter) {
+    _counter = new std::atomic<std::size_t>{0UL};
+    G4AutoLock lock(&_counter_mutex);
+    _counters.push_back(_counter);
+  }
+  return *_counter;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sum Counters over All Threads_______________________________________________________________
+std::size_t _completed_events() {
+  std::size_t out{};
+  G4AutoLock lock(&_counter_mutex);
+  for (const auto counter : _counters)
+    out += counter->load(std::memory_order_relaxed);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Progress Reporter Thread____________________________________________________________________
+std::thread _reporter;
+std::mutex _reporter_mutex;
+std::condition_variable _reporter_wake;
+bool _reporter_stop{};
+//----------------------------------------------------------------------------------------------
+
+//__Print Progress Line_________________________________________________________________________
+void _print_progress(const std::size_t total,
+                     const std::chrono::steady_clock::time_point start) {
+  const auto done = _completed_events();
+  const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const auto rate = elapsed > 0 ? done / elapsed : 0.0;
+  std::stringstream line;
+  line << "\r  Events [ " << done << " / " << total << " ] @ "
+       << std::fixed << std::setprecision(1) << rate << " events/s";
+  if (rate > 0 && done < total)
+    line << ", ETA " << std::setprecision(0) << (total - done) / rate << " s";
+  line << "        ";
+  std::cout << line.str() << std::flush;
+}
 //----------------------------------------------------------------------------------------------
+
+//__Progress Reporter Loop______________________________________________________________________
+void _report(const std::size_t total) {
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(_reporter_mutex);
+  while (!_reporter_wake.wait_for(lock, _print_interval, [] { return _reporter_stop; }))
+    _print_progress(total, start);
+  _print_progress(total, start);
+  std::cout << "\n";
+}
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Event Action Constructor____________________________________________________________________
-EventAction::EventAction(const size_t print_modulo) : G4UserEventAction() {
-  _print_modulo = print_modulo;
+EventAction::EventAction(const double print_interval) : G4UserEventAction() {
+  _print_interval = std::chrono::duration<double>(print_interval);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Event Initialization________________________________________________________________________
 void EventAction::BeginOfEventAction(const G4Event* event) {
+  Perf::Begin(Perf::Event);
   _event_id = event->GetEventID();
-  std::cout << "\r  Event [ "
-             + std::to_string(_event_id)
-             + " ] @ ("
-             + std::to_string(event->GetNumberOfPrimaryVertex())
-             + " primaries)"
-             + (!(_event_id % _print_modulo) ? "\n\n" : "");
+}
+//----------------------------------------------------------------------------------------------
+
+//__Event Finalization__________________________________________________________________________
+void EventAction::EndOfEventAction(const G4Event* event) {
+  Perf::End(Perf::Event);
+  Perf::Count(Perf::Events);
+  _local_counter().fetch_add(1UL, std::memory_order_relaxed);
+  if (!event->IsAborted())
+    RunAction::RecordEvent(event->GetEventID());
 }
 //----------------------------------------------------------------------------------------------
 
@@ -59,4 +143,122 @@ size_t EventAction::EventID() {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Set Quiet Mode______________________________________________________________________________
+void EventAction::SetQuiet(const bool quiet) {
+  _quiet = quiet;
+}
+bool EventAction::IsQuiet() {
+  return _quiet;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Start Progress Reporter_____________________________________________________________________
+void EventAction::StartProgress(const size_t total) {
+  StopProgress();
+  {
+    G4AutoLock lock(&_counter_mutex);
+    for (const auto counter : _counters)
+      counter->store(0UL, std::memory_order_relaxed);
+  }
+  if (_quiet || !total)
+    return;
+  _reporter_stop = false;
+  _reporter = std::thread(_report, total);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stop Progress Reporter______________________________________________________________________
+void EventAction::StopProgress() {
+  if (!_reporter.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(_reporter_mutex);
+    _reporter_stop = true;
+  }
+  _reporter_wake.notify_one();
+  _reporter.join();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Fill Detector NTuples from Thread-Local Hit Buffer__________________________________________
+bool EventAction::FillDetectorData(const std::string& name,
+                                   const Analysis::ROOT::DataKeyTypeList& types,
+                                   const bool save_all,
+                                   const std::function<double(int)>& threshold,
+                                   const std::function<void(const std::string&)>& extend) {
+  // skipped events (replay, shard or resume) must not reach a logical event or readout frame
+  const auto event = GetEvent();
+  if (event && event->IsAborted())
+    return false;
+
+  const auto split = Tracking::InSubEvent();
+  const auto overlay = Tracking::InOverlay();
+  Physics::ParticleVector particles;
+  if (split || overlay) {
+    const auto last_event = GeneratorAction::GetLastEvent();
+    particles.assign(last_event.begin(), last_event.end());
+    if (!Tracking::MergeSubEvent(particles))
+      return false;
+    if (!Tracking::OverlayEvent(particles, util::random::mix(RunAction::RunID(), EventID(), 0x4F564CULL)))
+      return false;
+  }
+
+  auto& buffer = Tracking::GetHitBuffer();
+  if (!save_all && buffer.GetSize() && Tracking::IsTriggerEnabled()) {
+    if (!Tracking::Trigger(buffer)) {
+      Perf::Count(Perf::TriggerRejected);
+      return false;
+    }
+    Perf::Count(Perf::TriggerAccepted);
+  }
+
+  const auto mode = Tracking::GetDigitizationMode();
+  static G4ThreadLocal Tracking::HitData* _hits = nullptr;
+  static G4ThreadLocal Tracking::HitData* _digitized = nullptr;
+  if (!_hits) {
+    _hits = new Tracking::HitData;
+    _digitized = new Tracking::HitData;
+  }
+  auto& digitized = *_digitized;
+  digitized.clear();
+  if (mode != Tracking::DigitizationMode::Off) {
+    auto& hits = *_hits;
+    hits.clear();
+    buffer.Extract(hits);
+    Tracking::Digitize(hits, threshold, digitized);
+    if (mode == Tracking::DigitizationMode::Instead)
+      buffer.Restore(digitized);
+  }
+
+  const auto hit_count = buffer.GetSize();
+  if (overlay && hit_count < Tracking::GetOverlayTrigger() && !save_all) {
+    Perf::Count(Perf::RejectedFrames);
+    return false;
+  }
+  if (hit_count == 0 && !save_all)
+    return false;
+
+  const auto fill = [&](const std::string& ntuple,
+                        const std::size_t count) {
+    const auto gen_count = split || overlay ? Tracking::ConvertToAnalysis(particles, ntuple)
+                         : save_all         ? Tracking::ConvertToAnalysis(GeneratorAction::GetLastEvent(), ntuple)
+                                            : Tracking::ConvertToAnalysis(GetEvent(), ntuple);
+    Tracking::ConvertToAnalysis(GeneratorAction::GetGenerator()->ExtraDetails(), ntuple);
+    if (extend)
+      extend(ntuple);
+
+    Analysis::ROOT::FillNTuple(ntuple, types, {
+      static_cast<Analysis::ROOT::DataEntryValueType>(count),
+      static_cast<Analysis::ROOT::DataEntryValueType>(gen_count)});
+  };
+
+  fill(name, hit_count);
+  if (mode == Tracking::DigitizationMode::Beside) {
+    Tracking::GetDigitizedHitBuffer().Restore(digitized);
+    fill(Tracking::DigitizedDataName(name), digitized.deposit.size());
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
 } } /* namespace MATHUSLA::MU */
@@ -17,8 +17,13 @@
 
 #include "action.hh"
 
+#include <limits>
 #include <unordered_map>
+#include <unordered_set>
 
+#include <Geant4/G4RunManager.hh>
+#include <Geant4/G4Threading.hh>
+#include <Geant4/Randomize.hh>
 #include <Geant4/tls.hh>
 
 #include "geometry/Earth.hh"
@@ -27,18 +32,27 @@
 #include "physics/CORSIKAReaderGenerator.hh"
 #include "physics/PythiaGenerator.hh"
 #include "physics/HepMCGenerator.hh"
+#include "physics/MixtureGenerator.hh"
 #include "physics/Units.hh"
+#include "perf.hh"
+#include "tracking.hh"
+#include "util/random.hh"
+#include "util/string.hh"
 
 namespace MATHUSLA { namespace MU {
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
 //__Generator Map_______________________________________________________________________________
-G4ThreadLocal std::unordered_map<std::string, Physics::Generator*> _gen_map;
+G4ThreadLocal Physics::GeneratorMap _gen_map;
 //----------------------------------------------------------------------------------------------
 
 //__Current Generator___________________________________________________________________________
-Physics::Generator* _gen;
+G4ThreadLocal Physics::Generator* _gen = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Event IDs Selected for Replay_______________________________________________________________
+G4ThreadLocal std::unordered_set<int>* _replay_events = nullptr;
 //----------------------------------------------------------------------------------------------
 
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
@@ -47,6 +61,7 @@ Physics::Generator* _gen;
 GeneratorAction::GeneratorAction(const std::string& generator)
     : G4VUserPrimaryGeneratorAction(),
       G4UImessenger(Physics::Generator::MessengerDirectory, "Particle Generators.") {
+  util::random::set_thread_stream(static_cast<std::uint64_t>(1 + G4Threading::G4GetThreadId()));
 
   _gen_map["basic"] = new Physics::Generator(
       "basic", "Default Generator.", Physics::Particle(13, 0, 0, Earth::TotalShift() + Cavern::IP(), -3*GeVperC, 0, -100*GeVperC));
@@ -69,10 +84,14 @@ GeneratorAction::GeneratorAction(const std::string& generator)
           "24:onIfAny = 13"
       });
 
-  // _gen_map["hepmc"] = new Physics::HepMCGenerator({});
+#ifdef MU__WITH_HEPMC3
+  _gen_map["hepmc"] = new Physics::HepMCGenerator({});
+#endif
 
   _gen_map["corsika_reader"] = new Physics::CORSIKAReaderGenerator("");
 
+  _gen_map["mixture"] = new Physics::MixtureGenerator(_gen_map);
+
   std::string generators;
   for (const auto& element : _gen_map) {
     generators.append(element.first);
@@ -92,11 +111,53 @@ GeneratorAction::GeneratorAction(const std::string& generator)
 
   _current = CreateCommand<Command::NoArg>("current", "Current Generator.");
   _current->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _replay = CreateCommand<Command::StringArg>("replay", "Only Simulate Listed Event IDs.");
+  _replay->SetParameterName("events", true);
+  _replay->SetDefaultValue("");
+  _replay->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Create Initial Vertex_______________________________________________________________________
 void GeneratorAction::GeneratePrimaries(G4Event* event) {
+  const auto event_id = event->GetEventID();
+  Tracking::SetSubEvent(static_cast<std::size_t>(event_id), 1UL);
+  if (_replay_events && !_replay_events->empty()) {
+    if (!_gen->IsEventIndexed()) {
+      std::cout << "Generator " << _gen->name() << " Reads a Stream and Cannot Replay Events. Ending run.\n";
+      event->SetEventAborted();
+      G4RunManager::GetRunManager()->AbortRun(true);
+      return;
+    }
+    if (_gen->SubEventCount() > 1UL) {
+      std::cout << "Generator " << _gen->name() << " Splits Events and Cannot Replay Them. Ending run.\n";
+      event->SetEventAborted();
+      G4RunManager::GetRunManager()->AbortRun(true);
+      return;
+    }
+    if (!_replay_events->count(event_id)) {
+      event->SetEventAborted();
+      return;
+    }
+  }
+  if (RunAction::IsResumed() && !_gen->IsEventIndexed()) {
+    std::cout << "Generator " << _gen->name() << " Reads a Stream and Cannot Resume a Run. Ending run.\n";
+    event->SetEventAborted();
+    G4RunManager::GetRunManager()->AbortRun(true);
+    return;
+  }
+  if (RunAction::IsEventCompleted(event_id)) {
+    event->SetEventAborted();
+    return;
+  }
+  const auto shard = RunAction::ShardRange(RunAction::EventCount(), _gen->SubEventCount());
+  if (static_cast<std::size_t>(event_id) < shard.first || static_cast<std::size_t>(event_id) >= shard.second) {
+    event->SetEventAborted();
+    return;
+  }
+  Perf::Scope scope(Perf::Generator);
+  SeedEvent(RunAction::RunID(), event_id);
   _gen->GeneratePrimaryVertex(event);
 }
 //----------------------------------------------------------------------------------------------
@@ -112,6 +173,23 @@ void GeneratorAction::SetNewValue(G4UIcommand* command,
       std::cout << element.second << "\n";
   } else if (command == _current) {
     std::cout << "Current Generator: \n  " << _gen->name() << "\n\n";
+  } else if (command == _replay) {
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, ", ");
+    std::unordered_set<int> events;
+    for (const auto& token : tokens) {
+      if (token.empty())
+        continue;
+      long id{};
+      if (!util::string::to_long(token, id) || id < 0 || id > std::numeric_limits<int>::max()) {
+        std::cout << "[ERROR] Invalid Event ID \"" << token << "\" in /gen/replay. Replay List Unchanged.\n";
+        return;
+      }
+      events.insert(static_cast<int>(id));
+    }
+    if (!_replay_events)
+      _replay_events = new std::unordered_set<int>();
+    _replay_events->swap(events);
   }
 }
 //----------------------------------------------------------------------------------------------
@@ -123,11 +201,32 @@ const Physics::Generator* GeneratorAction::GetGenerator() {
 //----------------------------------------------------------------------------------------------
 
 //__Get Last Event Data_________________________________________________________________________
-Physics::ParticleVector GeneratorAction::GetLastEvent() {
+Physics::ParticleView GeneratorAction::GetLastEvent() {
   return _gen->GetLastEvent();
 }
 //----------------------------------------------------------------------------------------------
 
+//__Prepare Current Generator for Run___________________________________________________________
+void GeneratorAction::BeginOfRun() {
+  if (_gen)
+    _gen->BeginOfRun();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Seed Random Engines for Event______________________________________________________________
+void GeneratorAction::SeedEvent(std::size_t run_id,
+                                int event_id) {
+  const auto seed = util::random::mix(util::random::run_seed(), run_id, static_cast<std::uint64_t>(event_id));
+  long seeds[3] = {static_cast<long>(1 + (seed & 0x7FFFFFFEULL)),
+                   static_cast<long>(1 + ((seed >> 32) & 0x7FFFFFFEULL)),
+                   0L};
+  G4Random::setTheSeeds(seeds);
+  util::random::seed_stream(run_id, static_cast<std::uint64_t>(event_id));
+  if (_gen)
+    _gen->SetEventSeed(seed);
+}
+//----------------------------------------------------------------------------------------------
+
 //__Set the Current Generator___________________________________________________________________
 void GeneratorAction::SetGenerator(const std::string& generator) {
   const auto& search = _gen_map.find(generator);
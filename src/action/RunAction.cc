@@ -18,25 +18,38 @@
 
 #include "action.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <ostream>
+#include <sstream>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <Geant4/G4Threading.hh>
 #include <Geant4/G4AutoLock.hh>
 #include <Geant4/G4MTRunManager.hh>
+#include <Geant4/Randomize.hh>
 #include <Geant4/tls.hh>
 
 #include <TFile.h>
-#include <TNamed.h>
 #include <TTree.h>
-#include <TChain.h>
 
 #include "analysis.hh"
+#include "columnar.hh"
 #include "geometry/Construction.hh"
+#include "perf.hh"
+#include "tracking.hh"
 #include "physics/Units.hh"
 
+#include "util/error.hh"
 #include "util/io.hh"
+#include "util/random.hh"
+#include "util/string.hh"
 #include "util/time.hh"
 #include "util/stream.hh"
 
@@ -59,80 +72,453 @@ std::size_t _event_count{};
 std::size_t _run_count{};
 //----------------------------------------------------------------------------------------------
 
+//__Output File Requested by Caller_____________________________________________________________
+std::string _output_file{};
+bool _output_file_used = false;
+//----------------------------------------------------------------------------------------------
+
+//__Process Shard_______________________________________________________________________________
+std::size_t _shard_index{};
+std::size_t _shard_count = 1UL;
+//----------------------------------------------------------------------------------------------
+
+//__Worker File Merge Mode_____________________________________________________________________
+std::string _merge_mode = "fast";
+//----------------------------------------------------------------------------------------------
+
+//__Checkpoint Settings_________________________________________________________________________
+std::size_t _checkpoint_events{};
+double _checkpoint_minutes{};
+bool _checkpointing = false;
+//----------------------------------------------------------------------------------------------
+
+//__Batch Run Settings__________________________________________________________________________
+std::size_t _batch_runs{};
+std::size_t _batch_size{};
+std::size_t _batch_events{};
+std::size_t _batch_run{};
+bool _batch_task_based = false;
+//----------------------------------------------------------------------------------------------
+
+//__Batch Position of each Run__________________________________________________________________
+// Owned by the master. Under the task-based run manager a worker may take part in only some
+// runs of a batch, so workers look up the position of the current run here instead of
+// counting the runs they saw.
+std::unordered_map<G4int, std::size_t> _batch_positions;
+G4ThreadLocal std::size_t _batch_position{};
+G4ThreadLocal bool _batch_open = false;
+//----------------------------------------------------------------------------------------------
+
+//__Runs Recorded in Current Batch______________________________________________________________
+struct _batch_record {
+  std::size_t run, events;
+  Analysis::SimSettingList specification;
+};
+std::vector<_batch_record> _batch_records;
+//----------------------------------------------------------------------------------------------
+
+//__Checkpoint Segments and Completed Events____________________________________________________
+std::vector<std::string> _segment_bases;
+std::unordered_set<int> _completed_events;
+std::size_t _resume_run = static_cast<std::size_t>(-1);
+std::vector<std::string> _resume_segments;
+std::unordered_set<int> _resume_events;
+std::atomic<std::size_t> _segment_counter{0UL};
+G4ThreadLocal std::vector<int> _segment_events;
+G4ThreadLocal std::chrono::steady_clock::time_point _segment_start;
+//----------------------------------------------------------------------------------------------
+
+//__Names of Detector Data Trees________________________________________________________________
+const std::vector<std::string> _tree_names() {
+  const auto& name = Construction::Builder::GetDetectorDataName();
+  if (Tracking::GetDigitizationMode() == Tracking::DigitizationMode::Beside)
+    return {name, Tracking::DigitizedDataName(name)};
+  return {name};
+}
+//----------------------------------------------------------------------------------------------
+
 //__Mutex for ROOT Interface____________________________________________________________________
 G4Mutex _mutex = G4MUTEX_INITIALIZER;
 //----------------------------------------------------------------------------------------------
 
-//__Write Entry to ROOT File____________________________________________________________________
+//__Update Worker File Tags from Thread Count___________________________________________________
+void _update_worker_tags() {
+  const auto master = G4MTRunManager::GetMasterRunManager();
+  _worker_count = static_cast<std::size_t>(master ? master->GetNumberOfThreads()
+                                                  : G4Threading::GetNumberOfRunningWorkerThreads());
+  _worker_tags.clear();
+  _worker_tags.reserve(_worker_count);
+  for (std::size_t i = 0; i < _worker_count; ++i)
+    _worker_tags.push_back(".temp_t" + std::to_string(i) + ".root");
+}
+//----------------------------------------------------------------------------------------------
+
+//__Run Metadata Gathered During the Run________________________________________________________
+Analysis::SimSettingList _metadata;
+std::ostringstream _metadata_stream;
+//----------------------------------------------------------------------------------------------
+
+//__Add Entry to Run Metadata___________________________________________________________________
 template<class... Args>
-void _write_entry(TFile* file,
-                  const std::string& name,
-                  Args&& ...args) {
-  std::stringstream stream;
-  util::stream::forward(stream, args...);
-  TNamed entry(name.c_str(), stream.str().c_str());
-  file->cd();
-  entry.Write();
+void _add_entry(const std::string& name,
+                Args&& ...args) {
+  _metadata_stream.str(std::string{});
+  _metadata_stream.clear();
+  util::stream::forward(_metadata_stream, args...);
+  _metadata.emplace_back(name, _metadata_stream.str());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Checkpoint Manifest Path____________________________________________________________________
+const std::string _manifest_path() {
+  return _prefix + std::to_string(_run_count) + ".checkpoint";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Encode Event IDs as Ranges__________________________________________________________________
+const std::string _event_ranges(std::vector<int> events) {
+  std::sort(events.begin(), events.end());
+  std::stringstream out;
+  for (std::size_t i{}; i < events.size();) {
+    auto j = i;
+    while (j + 1UL < events.size() && events[j + 1UL] <= events[j] + 1)
+      ++j;
+    out << (i ? "," : "") << events[i];
+    if (events[j] != events[i])
+      out << '-' << events[j];
+    i = j + 1UL;
+  }
+  return out.str();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Decode Event ID Ranges______________________________________________________________________
+void _parse_event_ranges(const std::string& ranges,
+                         std::unordered_set<int>& out) {
+  std::vector<std::string> tokens;
+  util::string::split(ranges, tokens, ",");
+  for (const auto& token : tokens) {
+    const auto dash = token.find('-', 1UL);
+    try {
+      const auto first = std::stoi(token.substr(0UL, dash));
+      const auto last = dash == std::string::npos ? first : std::stoi(token.substr(dash + 1UL));
+      for (auto id = first; id <= last; ++id)
+        out.insert(id);
+    } catch (...) {}
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Close Worker Segment and Record it in Manifest______________________________________________
+void _write_checkpoint() {
+  const auto thread = G4Threading::G4GetThreadId();
+  const auto index = _segment_counter.fetch_add(1UL);
+  const auto segment = _prefix + std::to_string(_run_count) + ".seg" + std::to_string(index);
+  Analysis::ROOT::Rotate(_prefix + _temp_path, segment + ".root");
+
+  const auto base = segment + "_t" + std::to_string(thread);
+  G4AutoLock lock(&_mutex);
+  _segment_bases.push_back(base);
+  std::ofstream manifest(_manifest_path(), std::ios::app);
+  manifest << "segment " << base.substr(base.find_last_of('/') + 1UL)
+           << ' ' << thread
+           << ' ' << _segment_events.size()
+           << ' ' << _event_ranges(_segment_events) << '\n';
+  manifest.flush();
+  lock.unlock();
+
+  _segment_events.clear();
+  _segment_start = std::chrono::steady_clock::now();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Close Worker Batch File into a Segment______________________________________________________
+// A task-based worker is not guaranteed to take part in the last run of a batch, so it closes
+// its output at the end of every run it processed and the master merges the segments.
+void _close_batch_segment() {
+  const auto thread = G4Threading::G4GetThreadId();
+  const auto index = _segment_counter.fetch_add(1UL);
+  const auto segment = _prefix + std::to_string(_run_count) + ".seg" + std::to_string(index);
+  Analysis::ROOT::Rotate(_prefix + _temp_path, segment + ".root");
+  Analysis::ROOT::Save();
+
+  G4AutoLock lock(&_mutex);
+  _segment_bases.push_back(segment + "_t" + std::to_string(thread));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Next Unused Segment Index___________________________________________________________________
+std::size_t _next_segment_index() {
+  std::size_t out{};
+  for (const auto& base : _segment_bases) {
+    const auto position = base.rfind(".seg");
+    if (position == std::string::npos)
+      continue;
+    try {
+      out = std::max(out, 1UL + std::stoul(base.substr(position + 4UL)));
+    } catch (...) {}
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Paths of Worker and Segment Files___________________________________________________________
+const std::vector<std::string> _worker_paths() {
+  std::vector<std::string> out;
+  out.reserve(_segment_bases.size() + _worker_tags.size());
+  for (const auto& base : _segment_bases)
+    out.push_back(base + ".root");
+  for (const auto& tag : _worker_tags)
+    out.push_back(_prefix + tag);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Exit unless Directory Was Created or Already Exists_________________________________________
+void _check_directory(const int status,
+                      const std::string& path) {
+  if (!status || errno == EEXIST)
+    return;
+  const auto reason = std::strerror(errno);
+  util::error::exit_when(true, "[FATAL ERROR] Unable to Create Output Directory: ", path, " (", reason, ")\n");
 }
 //----------------------------------------------------------------------------------------------
 
 //__Make DateTime Directories___________________________________________________________________
 std::string _make_directories(std::string prefix) {
-  util::io::create_directory(prefix);
-  util::io::create_directory(prefix += '/' + util::time::GetDate());
-  std::string time_path;
-  do {
-    using namespace std::chrono_literals;
-    std::this_thread::sleep_for(1s);
-    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    time_path = '/' + util::time::GetTime(&now);
-  } while (util::io::path_exists(prefix + time_path));
-  util::io::create_directory(prefix += time_path);
-  return prefix;
+  _check_directory(util::io::create_directory(prefix), prefix);
+  prefix += '/' + util::time::GetDate();
+  _check_directory(util::io::create_directory(prefix), prefix);
+  const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  const auto time_path = prefix + '/' + util::time::GetTime(&now);
+  const auto status = util::io::create_directory(time_path);
+  if (!status)
+    return time_path;
+  _check_directory(status, time_path);
+  const auto token = time_path + '_' + util::io::process_token();
+  auto path = token;
+  for (std::size_t attempt{1}; ; ++attempt) {
+    const auto attempt_status = util::io::create_directory(path);
+    if (!attempt_status)
+      return path;
+    _check_directory(attempt_status, path);
+    path = token + '_' + std::to_string(attempt);
+  }
 }
 //----------------------------------------------------------------------------------------------
 
-} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+//__Merge Worker Files into Output File_________________________________________________________
+void _merge_worker_files(TFile* file,
+                         const bool fast) {
+  const auto names = _tree_names();
+  const auto option = fast ? "fast" : "";
 
-//__RunAction Constructor_______________________________________________________________________
-RunAction::RunAction(const std::string& data_dir) : G4UserRunAction() {
-  _data_dir = data_dir == "" ? "data" : data_dir;
-  _worker_count = static_cast<std::size_t>(G4Threading::GetNumberOfRunningWorkerThreads());
-  _worker_tags.clear();
-  _worker_tags.reserve(_worker_count);
-  for (std::size_t i = 0; i < _worker_count; ++i)
-    _worker_tags.push_back(".temp_t" + std::to_string(i) + ".root");
+  std::vector<TTree*> out(names.size(), nullptr);
+  for (const auto& worker_path : _worker_paths()) {
+    auto worker = TFile::Open(worker_path.c_str(), "READ");
+    if (worker && !worker->IsZombie()) {
+      for (std::size_t i{}; i < names.size(); ++i) {
+        TTree* tree = nullptr;
+        worker->GetObject(names[i].c_str(), tree);
+        if (!tree)
+          continue;
+        file->cd();
+        if (!out[i]) {
+          out[i] = tree->CloneTree(-1, option);
+          if (out[i] && Analysis::ROOT::GetBasketSize())
+            out[i]->SetBasketSize("*", static_cast<Int_t>(Analysis::ROOT::GetBasketSize()));
+        } else {
+          out[i]->CopyEntries(tree, -1, option);
+        }
+        if (out[i])
+          out[i]->ResetBranchAddresses();
+      }
+      worker->Close();
+    }
+    delete worker;
+    util::io::remove_file(worker_path);
+  }
+
+  file->cd();
+  for (const auto tree : out)
+    if (tree)
+      tree->Write();
 }
 //----------------------------------------------------------------------------------------------
 
-//__Run Initialization__________________________________________________________________________
-void RunAction::BeginOfRunAction(const G4Run* run) {
-  G4AutoLock lock(&_mutex);
-  if (!G4Threading::IsWorkerThread()) {
-    if (_prefix.find("/run") == std::string::npos)
-      _prefix = _make_directories(_data_dir) + "/run";
-    _path = _prefix + std::to_string(_run_count) + ".root";
-    _event_count = run->GetNumberOfEventToBeProcessed();
+//__Index Worker Files in Output File___________________________________________________________
+void _index_worker_files() {
+  std::size_t index{};
+  for (const auto& worker_path : _worker_paths()) {
+    if (!util::io::path_exists(worker_path))
+      continue;
+    const auto indexed_path = _prefix + std::to_string(_run_count) + "_t" + std::to_string(index) + ".root";
+    if (util::io::rename_file(worker_path, indexed_path)) {
+      _add_entry("FILE" + std::to_string(index), indexed_path.substr(indexed_path.find_last_of('/') + 1UL));
+      ++index;
+    }
   }
-  lock.unlock();
+  _add_entry("FILES", index);
+  _add_entry("TREE", Construction::Builder::GetDetectorDataName());
+}
+//----------------------------------------------------------------------------------------------
 
-  Analysis::ROOT::Setup();
-  Analysis::ROOT::Open(_prefix + _temp_path);
-  Analysis::ROOT::CreateNTuple(
-    Construction::Builder::GetDetectorDataName(),
-    Construction::Builder::GetDetectorDataKeys(),
-    Construction::Builder::GetDetectorDataKeyTypes());
+//__Index Columnar Worker Files in Output File__________________________________________________
+void _index_columnar_files() {
+  const auto format = Analysis::Columnar::GetFormat();
+  if (format == Analysis::Columnar::Format::ROOT)
+    return;
+  std::vector<std::string> bases = _segment_bases;
+  for (std::size_t thread{}; thread < _worker_count; ++thread)
+    bases.push_back(_prefix + ".temp_t" + std::to_string(thread));
 
-  if (!G4Threading::IsWorkerThread())
-    std::cout << "\n\n";
+  std::size_t index{};
+  for (std::size_t part{}; part < bases.size(); ++part) {
+    const auto tag = "_t" + std::to_string(part);
+    for (const auto& name : _tree_names()) {
+      const auto worker_path = Analysis::Columnar::TablePath(bases[part], name);
+      if (!util::io::path_exists(worker_path))
+        continue;
+      const auto indexed_path = Analysis::Columnar::TablePath(_prefix + std::to_string(_run_count) + tag, name);
+      if (util::io::rename_file(worker_path, indexed_path)) {
+        _add_entry("COLUMNAR_FILE" + std::to_string(index),
+                   indexed_path.substr(indexed_path.find_last_of('/') + 1UL));
+        ++index;
+      }
+    }
+  }
+  _add_entry("COLUMNAR_FORMAT", Analysis::Columnar::FormatName(format));
+  _add_entry("COLUMNAR_FILES", index);
+  _add_entry("ROW_GROUP", Analysis::Columnar::GetRowGroupSize());
 }
 //----------------------------------------------------------------------------------------------
 
-//__Post-Run Processing_________________________________________________________________________
-void RunAction::EndOfRunAction(const G4Run*) {
-  if (!_event_count)
+//__Attach Run Settings to Columnar File Metadata_______________________________________________
+void _set_columnar_metadata() {
+  if (Analysis::Columnar::GetFormat() == Analysis::Columnar::Format::ROOT)
+    return;
+  Analysis::Columnar::SetMetadata(_metadata);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Column Selection and Writer Settings to Run Metadata____________________________________
+void _add_columns() {
+  const auto& columns = Analysis::ROOT::GetColumnSelection();
+  if (!columns.empty()) {
+    std::string list;
+    for (const auto& column : columns)
+      list += (list.empty() ? "" : ", ") + column;
+    _add_entry("COLUMNS", list);
+  }
+  _add_entry("COMPRESSION", Analysis::ROOT::GetCompressionAlgorithm(), " ", Analysis::ROOT::GetCompressionLevel());
+  if (Analysis::ROOT::GetBasketSize())
+    _add_entry("BASKET_SIZE", Analysis::ROOT::GetBasketSize());
+  if (Analysis::ROOT::IsAsyncWriting())
+    _add_entry("ASYNC_QUEUE", Analysis::ROOT::GetAsyncQueueSize());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Hit Aggregation Settings to Run Metadata________________________________________________
+void _add_aggregation() {
+  const auto mode = Tracking::GetAggregationMode();
+  if (mode == Tracking::AggregationMode::Off)
+    return;
+  _add_entry("AGGREGATE", mode == Tracking::AggregationMode::Track ? "track" : "window");
+  if (mode == Tracking::AggregationMode::Window)
+    _add_entry("AGGREGATE_WINDOW", Tracking::GetAggregationWindow() / Units::Time, " ", Units::TimeString);
+  _add_entry("AGGREGATE_POSITION", Tracking::IsAggregationWeighted() ? "weighted" : "earliest");
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Overlay Settings to Run Metadata________________________________________________________
+void _add_overlay() {
+  if (!Tracking::InOverlay())
+    return;
+  _add_entry("OVERLAY", Tracking::GetOverlayEvents());
+  _add_entry("OVERLAY_RATE", Tracking::GetOverlayRate() / hertz, " Hz");
+  _add_entry("OVERLAY_TRIGGER", Tracking::GetOverlayTrigger());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Trigger Settings to Run Metadata________________________________________________________
+void _add_trigger() {
+  if (!Tracking::IsTriggerEnabled())
     return;
+  _add_entry("TRIGGER_HITS", Tracking::GetTriggerHits());
+  _add_entry("TRIGGER_LAYERS", Tracking::GetTriggerLayers());
+  _add_entry("TRIGGER_DEPOSIT", Tracking::GetTriggerDeposit() / Units::Energy, " ", Units::EnergyString);
+  if (Tracking::GetTriggerWindow() > 0.0)
+    _add_entry("TRIGGER_WINDOW", Tracking::GetTriggerWindow() / Units::Time, " ", Units::TimeString);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Digitization Settings to Run Metadata___________________________________________________
+void _add_digitization() {
+  const auto mode = Tracking::GetDigitizationMode();
+  if (mode == Tracking::DigitizationMode::Off)
+    return;
+  _add_entry("DIGI_WINDOW", Tracking::GetDigitizationWindow() / Units::Time, " ", Units::TimeString);
+  if (mode == Tracking::DigitizationMode::Instead) {
+    _add_entry("DIGITIZED", "TRUE");
+  } else {
+    _add_entry("DIGI_TREE", Tracking::DigitizedDataName(Construction::Builder::GetDetectorDataName()));
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Performance Report to Run Metadata______________________________________________________
+void _add_performance(const Perf::Record& record) {
+  for (std::size_t i{}; i < Perf::StageCount; ++i) {
+    const auto stage = static_cast<Perf::Stage>(i);
+    _add_entry("PERF_" + Perf::StageNames[i], Perf::Seconds(record, stage));
+    _add_entry("PERF_" + Perf::StageNames[i] + "_CALLS", record.calls[i]);
+  }
+  _add_entry("PERF_TRACKING", Perf::Seconds(record, Perf::Event)
+                             - Perf::Seconds(record, Perf::Conversion)
+                             - Perf::Seconds(record, Perf::Fill));
+  for (std::size_t i{}; i < Perf::CounterCount; ++i)
+    _add_entry("PERF_" + Perf::CounterNames[i], record.counts[i]);
+  for (std::size_t i{}; i < Perf::MemoryCount; ++i)
+    _add_entry("MEMORY_" + Perf::MemoryNames[i], record.memory[i]);
+  _add_entry("MEMORY_RESIDENT", Perf::ResidentBytes());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Record Finished Run of Current Batch________________________________________________________
+void _record_batch_run() {
+  _batch_records.push_back({_run_count, _event_count, GeneratorAction::GetGenerator()->GetSpecification()});
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Runs of Current Batch to ROOT File____________________________________________________
+void _write_batch_runs(TFile* file) {
+  file->cd();
+  Long64_t run, events;
+  std::vector<std::string> keys, values;
+  TTree tree("runs", "MU-SIM Batch Runs");
+  tree.Branch("run", &run);
+  tree.Branch("events", &events);
+  tree.Branch("keys", &keys);
+  tree.Branch("values", &values);
+  for (const auto& record : _batch_records) {
+    run = static_cast<Long64_t>(record.run);
+    events = static_cast<Long64_t>(record.events);
+    keys.clear();
+    values.clear();
+    for (const auto& entry : record.specification) {
+      keys.push_back(entry.name);
+      values.push_back(entry.text);
+    }
+    tree.Fill();
+  }
+  tree.Write();
+  _add_entry("BATCH_RUNS", _batch_records.size());
+  _add_entry("BATCH_EVENTS", _batch_events);
+}
+//----------------------------------------------------------------------------------------------
 
+//__Save Output and Merge Worker Files__________________________________________________________
+void _close_output() {
   Analysis::ROOT::Save();
 
   G4AutoLock lock(&_mutex);
@@ -141,38 +527,41 @@ void RunAction::EndOfRunAction(const G4Run*) {
       return;
     auto file = TFile::Open(_path.c_str(), "UPDATE");
     if (file && !file->IsZombie()) {
-      file->cd();
-      auto chain = new TChain(Construction::Builder::GetDetectorDataName().c_str());
-      for (const auto& tag : _worker_tags)
-        chain->Add((_prefix + tag).c_str());
-
-      TTree* tree = chain;
-      file->cd();
-      auto clone_tree = tree->CloneTree();
-      if (clone_tree)
-        clone_tree->Write();
-      delete chain;
-
+      Analysis::ROOT::ApplyCompression(file);
+      Perf::Begin(Perf::Merge);
+      if (_merge_mode == "index") {
+        _index_worker_files();
+      } else {
+        _merge_worker_files(file, _merge_mode == "fast" && Analysis::ROOT::GetCompressionAlgorithm() == "zlib");
+      }
+      _index_columnar_files();
       util::io::remove_file(_prefix + _temp_path);
-      for (const auto& tag : _worker_tags)
-        util::io::remove_file(_prefix + tag);
-
-      file->cd();
+      Analysis::ROOT::WriteHistograms(file);
+      Perf::End(Perf::Merge);
 
-      _write_entry(file, "FILETYPE", "MATHULSA MU-SIM DATAFILE");
-      _write_entry(file, "DET", Construction::Builder::GetDetectorName());
-
-      for (const auto& entry : GeneratorAction::GetGenerator()->GetSpecification())
-        _write_entry(file, entry.name, entry.text);
+      if (_batch_size > 1UL) {
+        _write_batch_runs(file);
+        _batch_records.clear();
+      }
+      if (!_segment_bases.empty())
+        _add_entry("SEGMENTS", _segment_bases.size());
+      _add_entry("TIMESTAMP", util::time::GetString("%c %Z"));
 
-      _write_entry(file, "RUN", _run_count);
-      _write_entry(file, "EVENTS", _event_count);
-      _write_entry(file, "TIMESTAMP", util::time::GetString("%c %Z"));
+      const auto performance = Perf::Collect();
+      _add_performance(performance);
 
+      Analysis::Save(file, _metadata);
       file->Close();
+      _metadata.clear();
 
+      util::io::remove_file(_manifest_path());
+      _segment_bases.clear();
+      _completed_events.clear();
       ++_run_count;
-      std::cout << "\n\n\nEnd of Run\nData File: " << _path << "\n\n";
+      if (!EventAction::IsQuiet()) {
+        Perf::Print(std::cout, performance);
+        std::cout << "\n\n\nEnd of Run\nData File: " << _path << "\n\n";
+      }
     }
   }
   lock.unlock();
@@ -180,6 +569,373 @@ void RunAction::EndOfRunAction(const G4Run*) {
 }
 //----------------------------------------------------------------------------------------------
 
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Run Messenger Directory Path________________________________________________________________
+const std::string RunAction::MessengerDirectory = "/data/";
+//----------------------------------------------------------------------------------------------
+
+//__RunAction Constructor_______________________________________________________________________
+RunAction::RunAction(const std::string& data_dir)
+    : G4UserRunAction(), G4UImessenger(MessengerDirectory, "Data Output.") {
+  _data_dir = data_dir == "" ? "data" : data_dir;
+
+  _merge = CreateCommand<Command::StringArg>("merge", "Set Worker File Merge Mode.");
+  _merge->SetParameterName("mode", false);
+  _merge->SetDefaultValue("fast");
+  _merge->SetCandidates("fast clone index");
+  _merge->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _digitize = CreateCommand<Command::StringArg>("digitize", "Set Hit Digitization Mode.");
+  _digitize->SetParameterName("mode", false);
+  _digitize->SetDefaultValue("off");
+  _digitize->SetCandidates("off beside instead");
+  _digitize->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _digi_window = CreateCommand<Command::DoubleUnitArg>("digi_window", "Set Digitization Time Window.");
+  _digi_window->SetParameterName("window", false);
+  _digi_window->SetUnitCategory("Time");
+  _digi_window->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _aggregate = CreateCommand<Command::StringArg>("aggregate", "Set Hit Aggregation Mode.");
+  _aggregate->SetParameterName("mode", false);
+  _aggregate->SetDefaultValue("off");
+  _aggregate->SetCandidates("off track window");
+  _aggregate->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _aggregate_window = CreateCommand<Command::DoubleUnitArg>("aggregate_window", "Set Hit Aggregation Time Window.");
+  _aggregate_window->SetParameterName("window", false);
+  _aggregate_window->SetUnitCategory("Time");
+  _aggregate_window->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _aggregate_position = CreateCommand<Command::StringArg>("aggregate_position", "Set Aggregated Hit Position.");
+  _aggregate_position->SetParameterName("position", false);
+  _aggregate_position->SetDefaultValue("earliest");
+  _aggregate_position->SetCandidates("earliest weighted");
+  _aggregate_position->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _columns = CreateCommand<Command::StringArg>("columns", "Select Detector Data Columns to Write.");
+  _columns->SetParameterName("columns", false);
+  _columns->SetDefaultValue("all");
+  _columns->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _compression = CreateCommand<Command::StringArg>("compression", "Set Output File Compression Algorithm.");
+  _compression->SetParameterName("algorithm", false);
+  _compression->SetDefaultValue("zlib");
+  _compression->SetCandidates("zlib lzma lz4 zstd");
+  _compression->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _compression_level = CreateCommand<Command::IntegerArg>("compression_level", "Set Output File Compression Level.");
+  _compression_level->SetParameterName("level", false, false);
+  _compression_level->SetRange("level >= 0 && level <= 9");
+  _compression_level->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _basket_size = CreateCommand<Command::IntegerArg>("basket_size", "Set Output Tree Basket Size in Bytes.");
+  _basket_size->SetParameterName("size", false, false);
+  _basket_size->SetRange("size >= 0");
+  _basket_size->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _async = CreateCommand<Command::BoolArg>("async", "Write Detector Data on a Background Thread.");
+  _async->SetParameterName("enable", false);
+  _async->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _async_queue = CreateCommand<Command::IntegerArg>("async_queue", "Set Rows Buffered per Writer Thread.");
+  _async_queue->SetParameterName("rows", false, false);
+  _async_queue->SetRange("rows > 0");
+  _async_queue->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _checkpoint = CreateCommand<Command::IntegerArg>("checkpoint", "Close Worker File Segments every N Events.");
+  _checkpoint->SetParameterName("events", false, false);
+  _checkpoint->SetRange("events >= 0");
+  _checkpoint->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _checkpoint_time = CreateCommand<Command::DoubleArg>("checkpoint_time", "Close Worker File Segments every T Minutes.");
+  _checkpoint_time->SetParameterName("minutes", false);
+  _checkpoint_time->SetRange("minutes >= 0");
+  _checkpoint_time->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _format = CreateCommand<Command::StringArg>("format", "Set Detector Data Output Format.");
+  _format->SetParameterName("format", false);
+  _format->SetDefaultValue("root");
+  _format->SetCandidates("root arrow parquet");
+  _format->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _row_group = CreateCommand<Command::IntegerArg>("row_group", "Set Rows per Arrow Batch or Parquet Row Group.");
+  _row_group->SetParameterName("rows", false, false);
+  _row_group->SetRange("rows > 0");
+  _row_group->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _batch = CreateCommand<Command::IntegerArg>("batch", "Write the Next N Runs to One Output File.");
+  _batch->SetParameterName("runs", false, false);
+  _batch->SetRange("runs >= 0");
+  _batch->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _overlay = CreateCommand<Command::IntegerArg>("overlay", "Overlay N Events into One Readout Frame.");
+  _overlay->SetParameterName("events", false, false);
+  _overlay->SetRange("events >= 0");
+  _overlay->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _overlay_rate = CreateCommand<Command::DoubleUnitArg>("overlay_rate", "Set Overlaid Event Rate.");
+  _overlay_rate->SetParameterName("rate", false);
+  _overlay_rate->SetUnitCategory("Frequency");
+  _overlay_rate->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _overlay_trigger = CreateCommand<Command::IntegerArg>("overlay_trigger", "Set Minimum Hits in Written Readout Frame.");
+  _overlay_trigger->SetParameterName("hits", false, false);
+  _overlay_trigger->SetRange("hits >= 1");
+  _overlay_trigger->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_hits = CreateCommand<Command::IntegerArg>("trigger_hits", "Set Minimum Hits in Triggered Event.");
+  _trigger_hits->SetParameterName("hits", false, false);
+  _trigger_hits->SetRange("hits >= 1");
+  _trigger_hits->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_layers = CreateCommand<Command::IntegerArg>("trigger_layers", "Set Minimum Distinct Layers in Triggered Event.");
+  _trigger_layers->SetParameterName("layers", false, false);
+  _trigger_layers->SetRange("layers >= 0");
+  _trigger_layers->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_deposit = CreateCommand<Command::DoubleUnitArg>("trigger_deposit", "Set Minimum Deposit of Trigger Hit.");
+  _trigger_deposit->SetParameterName("deposit", false);
+  _trigger_deposit->SetUnitCategory("Energy");
+  _trigger_deposit->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_window = CreateCommand<Command::DoubleUnitArg>("trigger_window", "Set Trigger Coincidence Window.");
+  _trigger_window->SetParameterName("window", false);
+  _trigger_window->SetUnitCategory("Time");
+  _trigger_window->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _memory = CreateCommand<Command::NoArg>("memory", "Print Resident Memory per Thread.");
+  _memory->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Run Messenger Set New Value_________________________________________________________________
+void RunAction::SetNewValue(G4UIcommand* command,
+                            G4String value) {
+  if (G4Threading::IsWorkerThread())
+    return;
+
+  if (command == _merge) {
+    _merge_mode = value;
+  } else if (command == _digitize) {
+    Tracking::SetDigitizationMode(value == "beside"  ? Tracking::DigitizationMode::Beside
+                                : value == "instead" ? Tracking::DigitizationMode::Instead
+                                                     : Tracking::DigitizationMode::Off);
+  } else if (command == _digi_window) {
+    Tracking::SetDigitizationWindow(_digi_window->GetNewDoubleValue(value));
+  } else if (command == _aggregate) {
+    Tracking::SetAggregationMode(value == "track"  ? Tracking::AggregationMode::Track
+                               : value == "window" ? Tracking::AggregationMode::Window
+                                                   : Tracking::AggregationMode::Off);
+  } else if (command == _aggregate_window) {
+    Tracking::SetAggregationWindow(_aggregate_window->GetNewDoubleValue(value));
+  } else if (command == _aggregate_position) {
+    Tracking::SetAggregationWeighted(value == "weighted");
+  } else if (command == _columns) {
+    Analysis::ROOT::DataKeyList columns;
+    util::string::split(value, columns, ", ");
+    Analysis::ROOT::SetColumnSelection(columns);
+  } else if (command == _compression) {
+    Analysis::ROOT::SetCompressionAlgorithm(value);
+  } else if (command == _compression_level) {
+    Analysis::ROOT::SetCompressionLevel(_compression_level->GetNewIntValue(value));
+  } else if (command == _basket_size) {
+    Analysis::ROOT::SetBasketSize(static_cast<std::size_t>(_basket_size->GetNewIntValue(value)));
+  } else if (command == _async) {
+    Analysis::ROOT::SetAsyncWriting(_async->GetNewBoolValue(value));
+  } else if (command == _async_queue) {
+    Analysis::ROOT::SetAsyncQueueSize(static_cast<std::size_t>(_async_queue->GetNewIntValue(value)));
+  } else if (command == _checkpoint) {
+    _checkpoint_events = static_cast<std::size_t>(_checkpoint->GetNewIntValue(value));
+  } else if (command == _checkpoint_time) {
+    _checkpoint_minutes = _checkpoint_time->GetNewDoubleValue(value);
+  } else if (command == _format) {
+    const auto format = value == "arrow"   ? Analysis::Columnar::Format::Arrow
+                      : value == "parquet" ? Analysis::Columnar::Format::Parquet
+                                           : Analysis::Columnar::Format::ROOT;
+    if (!Analysis::Columnar::SetFormat(format))
+      std::cout << "Columnar Output Unavailable: Rebuild with MU_WITH_ARROW to Write " << value << ".\n";
+  } else if (command == _row_group) {
+    Analysis::Columnar::SetRowGroupSize(static_cast<std::size_t>(_row_group->GetNewIntValue(value)));
+  } else if (command == _batch) {
+    _batch_runs = static_cast<std::size_t>(_batch->GetNewIntValue(value));
+  } else if (command == _overlay) {
+    Tracking::SetOverlayEvents(static_cast<std::size_t>(_overlay->GetNewIntValue(value)));
+  } else if (command == _overlay_rate) {
+    Tracking::SetOverlayRate(_overlay_rate->GetNewDoubleValue(value));
+  } else if (command == _overlay_trigger) {
+    Tracking::SetOverlayTrigger(static_cast<std::size_t>(_overlay_trigger->GetNewIntValue(value)));
+  } else if (command == _trigger_hits) {
+    Tracking::SetTriggerHits(static_cast<std::size_t>(_trigger_hits->GetNewIntValue(value)));
+  } else if (command == _trigger_layers) {
+    Tracking::SetTriggerLayers(static_cast<std::size_t>(_trigger_layers->GetNewIntValue(value)));
+  } else if (command == _trigger_deposit) {
+    Tracking::SetTriggerDeposit(_trigger_deposit->GetNewDoubleValue(value));
+  } else if (command == _trigger_window) {
+    Tracking::SetTriggerWindow(_trigger_window->GetNewDoubleValue(value));
+  } else if (command == _memory) {
+    Perf::PrintMemory(std::cout);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__RunAction Destructor________________________________________________________________________
+RunAction::~RunAction() {
+  if (G4Threading::IsWorkerThread() ? _batch_open : _batch_run > 0UL) {
+    _batch_run = 0UL;
+    _batch_open = false;
+    _close_output();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Run Initialization__________________________________________________________________________
+void RunAction::BeginOfRunAction(const G4Run* run) {
+  G4AutoLock lock(&_mutex);
+  if (G4Threading::IsWorkerThread()) {
+    const auto position = _batch_positions.find(run->GetRunID());
+    _batch_position = position == _batch_positions.cend() ? 0UL : position->second;
+  } else {
+    _batch_position = _batch_run;
+  }
+  const auto batched = _batch_position > 0UL && (!G4Threading::IsWorkerThread() || _batch_open);
+  if (!G4Threading::IsWorkerThread()) {
+    _event_count = run->GetNumberOfEventToBeProcessed();
+    Tracking::ClearSubEvents();
+    if (!batched) {
+      if (!_output_file.empty()) {
+        _prefix = _output_file.substr(0UL, _output_file.rfind(".root")) + "_run";
+        _path = _output_file_used ? _prefix + std::to_string(_run_count) + ".root" : _output_file;
+        _output_file_used = true;
+        util::io::remove_file(_path);
+      } else {
+        if (_shard_count > 1UL) {
+          util::io::create_directory(_data_dir);
+          _prefix = _data_dir + "/shard" + std::to_string(_shard_index)
+                              + "of" + std::to_string(_shard_count) + "_run";
+        } else if (_prefix.find("/run") == std::string::npos) {
+          _prefix = _make_directories(_data_dir) + "/run";
+        }
+        _path = _prefix + std::to_string(_run_count) + ".root";
+      }
+      _update_worker_tags();
+      Analysis::ROOT::ResetHistograms();
+
+      _batch_size = _batch_runs;
+      _batch_events = 0UL;
+      _batch_records.clear();
+      _batch_positions.clear();
+      _batch_task_based = G4RunManager::GetRunManager()->GetRunManagerType() == G4RunManager::taskRM;
+      Analysis::ROOT::SetRunColumn(_batch_size > 1UL);
+
+      _metadata.clear();
+      _add_entry("FILETYPE", "MATHULSA MU-SIM DATAFILE");
+      _add_entry("DET", Construction::Builder::GetDetectorName());
+      for (const auto& entry : GeneratorAction::GetGenerator()->GetSpecification())
+        _add_entry(entry.name, entry.text);
+      _add_entry("SEED", util::random::run_seed());
+      _add_entry("RUN", _run_count);
+      _add_entry("EVENTS", _event_count);
+      if (_shard_count > 1UL) {
+        const auto range = ShardRange(_event_count, GeneratorAction::GetGenerator()->SubEventCount());
+        _add_entry("SHARD", _shard_index);
+        _add_entry("SHARDS", _shard_count);
+        _add_entry("FIRST_EVENT", range.first);
+        _add_entry("LAST_EVENT", range.second);
+      }
+      _add_columns();
+      _add_aggregation();
+      _add_overlay();
+      _add_trigger();
+      _add_digitization();
+
+      if (_run_count == _resume_run) {
+        _segment_bases = std::move(_resume_segments);
+        _completed_events = std::move(_resume_events);
+        _resume_run = static_cast<std::size_t>(-1);
+      }
+      _segment_counter = _next_segment_index();
+      _checkpointing = (_checkpoint_events || _checkpoint_minutes > 0.0)
+                    && GeneratorAction::GetGenerator()->SubEventCount() <= 1UL
+                    && !Tracking::InOverlay()
+                    && _batch_size <= 1UL;
+      if (_checkpointing && !util::io::path_exists(_manifest_path())) {
+        std::ofstream manifest(_manifest_path());
+        manifest << "run " << _run_count << " seed " << util::random::run_seed() << " events " << _event_count << '\n';
+      }
+    }
+    _batch_events += _event_count;
+    _batch_positions[run->GetRunID()] = _batch_position;
+  } else {
+    _segment_events.clear();
+    _segment_start = std::chrono::steady_clock::now();
+    Tracking::ClearOverlay();
+  }
+  lock.unlock();
+
+  GeneratorAction::BeginOfRun();
+
+  if (!Perf::Local().memory[Perf::PhysicsMemory])
+    Perf::MeasureMemory(Perf::PhysicsMemory);
+
+  Analysis::ROOT::SetRunNumber(static_cast<int>(_run_count));
+  if (!batched) {
+    _batch_open = _batch_size > 1UL;
+    Perf::Reset();
+    Analysis::ROOT::Setup();
+    Analysis::ROOT::Open(_prefix + _temp_path);
+    for (const auto& name : _tree_names())
+      Analysis::ROOT::CreateNTuple(
+        name,
+        Construction::Builder::GetDetectorDataKeys(),
+        Construction::Builder::GetDetectorDataKeyTypes());
+    _set_columnar_metadata();
+  }
+
+  if (!G4Threading::IsWorkerThread()) {
+    if (!EventAction::IsQuiet())
+      std::cout << "\n\n";
+    EventAction::StartProgress(_event_count);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Post-Run Processing_________________________________________________________________________
+void RunAction::EndOfRunAction(const G4Run*) {
+  if (!G4Threading::IsWorkerThread())
+    EventAction::StopProgress();
+
+  Perf::SetMemory(Perf::HitMemory, Tracking::GetHitBuffer().GetMemoryBytes()
+                                 + Tracking::GetDigitizedHitBuffer().GetMemoryBytes());
+  if (const auto generator = GeneratorAction::GetGenerator())
+    Perf::SetMemory(Perf::GeneratorMemory, generator->BufferBytes());
+
+  if (!_event_count)
+    return;
+
+  if (_batch_size > 1UL && _batch_position + 1UL < _batch_size) {
+    if (!G4Threading::IsWorkerThread()) {
+      _batch_run = _batch_position + 1UL;
+      _record_batch_run();
+      if (!EventAction::IsQuiet())
+        std::cout << "\n\n\nEnd of Run " << _run_count
+                  << " (" << _batch_run << " of " << _batch_size << " in Batch)\nData File: " << _path << "\n\n";
+      ++_run_count;
+    } else if (_batch_task_based) {
+      _batch_open = false;
+      _close_batch_segment();
+    }
+    return;
+  }
+  if (_batch_size > 1UL && !G4Threading::IsWorkerThread())
+    _record_batch_run();
+  _batch_run = 0UL;
+  _batch_open = false;
+  _close_output();
+}
+//----------------------------------------------------------------------------------------------
+
 //__Get Current Run_____________________________________________________________________________
 const G4Run* RunAction::GetRun() {
   return G4RunManager::GetRunManager()->GetCurrentRun();
@@ -198,4 +954,117 @@ std::size_t RunAction::EventCount() {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Record Completed Event and Checkpoint if Due________________________________________________
+void RunAction::RecordEvent(const int event_id) {
+  if (!_checkpointing || !G4Threading::IsWorkerThread())
+    return;
+  _segment_events.push_back(event_id);
+  const auto minutes = std::chrono::duration<double>(std::chrono::steady_clock::now() - _segment_start).count() / 60.0;
+  if ((_checkpoint_events && _segment_events.size() >= _checkpoint_events)
+      || (_checkpoint_minutes > 0.0 && minutes >= _checkpoint_minutes))
+    _write_checkpoint();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Event was Completed before Resuming________________________________________________
+bool RunAction::IsEventCompleted(const int event_id) {
+  return !_completed_events.empty() && _completed_events.count(event_id);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Current Run Resumes a Checkpoint___________________________________________________
+bool RunAction::IsResumed() {
+  return !_completed_events.empty();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Resume Run from Checkpoint Manifest_________________________________________________________
+bool RunAction::Resume(const std::string& path) {
+  const auto manifest = path.find('/') == std::string::npos ? "./" + path : path;
+  const std::string extension = ".checkpoint";
+  if (manifest.size() <= extension.size()
+      || manifest.compare(manifest.size() - extension.size(), extension.size(), extension))
+    return false;
+
+  std::ifstream file(manifest);
+  if (!file)
+    return false;
+
+  const auto stem = manifest.substr(0UL, manifest.size() - extension.size());
+  const auto digits = stem.find_last_not_of("0123456789") + 1UL;
+  const auto slash = manifest.find_last_of('/');
+  const auto dir = manifest.substr(0UL, slash + 1UL);
+
+  std::string line;
+  std::size_t run{};
+  std::uint64_t seed{};
+  if (!std::getline(file, line) || digits == stem.size())
+    return false;
+  std::string run_key, seed_key;
+  std::istringstream header(line);
+  if (!(header >> run_key >> run >> seed_key >> seed) || run_key != "run" || seed_key != "seed")
+    return false;
+
+  _resume_segments.clear();
+  _resume_events.clear();
+  while (std::getline(file, line)) {
+    std::string key, name, ranges;
+    int thread{};
+    std::size_t count{};
+    std::istringstream entry(line);
+    if (!(entry >> key >> name >> thread >> count) || key != "segment")
+      continue;
+    entry >> ranges;
+    if (!util::io::path_exists(dir + name + ".root"))
+      continue;
+    _resume_segments.push_back(dir + name);
+    _parse_event_ranges(ranges, _resume_events);
+  }
+
+  _prefix = stem.substr(0UL, digits);
+  _resume_run = run;
+  util::random::set_run_seed(seed);
+  std::cout << "Resuming Run " << run << " from " << _resume_segments.size() << " Segments ("
+            << _resume_events.size() << " Completed Events)\n";
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Output File of Next Run_________________________________________________________________
+void RunAction::SetOutputFile(const std::string& path) {
+  _output_file = path;
+  _output_file_used = false;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Process Shard___________________________________________________________________________
+void RunAction::SetShard(const std::size_t index,
+                         const std::size_t count) {
+  _shard_count = std::max(1UL, count);
+  _shard_index = std::min(index, _shard_count - 1UL);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Process Shard Index_____________________________________________________________________
+std::size_t RunAction::ShardIndex() {
+  return _shard_index;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Process Shard Count_____________________________________________________________________
+std::size_t RunAction::ShardCount() {
+  return _shard_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Range of Items Owned by Process Shard___________________________________________________
+std::pair<std::size_t, std::size_t> RunAction::ShardRange(const std::size_t total,
+                                                         const std::size_t granularity) {
+  const auto step = std::max(1UL, granularity);
+  const auto units = (total + step - 1UL) / step;
+  return {std::min(total, step * (units * _shard_index / _shard_count)),
+          std::min(total, step * (units * (_shard_index + 1UL) / _shard_count))};
+}
+//----------------------------------------------------------------------------------------------
+
 } } /* namespace MATHUSLA::MU */
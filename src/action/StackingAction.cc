@@ -0,0 +1,213 @@
+/* src/action/StackingAction.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "action.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Geant4/G4EmCalculator.hh>
+#include <Geant4/G4Event.hh>
+#include <Geant4/G4EventManager.hh>
+#include <Geant4/G4HCofThisEvent.hh>
+#include <Geant4/G4StackManager.hh>
+#include <Geant4/G4RegionStore.hh>
+#include <Geant4/G4Track.hh>
+#include <Geant4/tls.hh>
+
+#include "geometry/Construction.hh"
+#include "perf.hh"
+#include "tracking.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Kill Policy Settings________________________________________________________________________
+G4ThreadLocal bool _kill_enabled;
+G4ThreadLocal double _kill_em_threshold;
+G4ThreadLocal double _kill_safety;
+G4ThreadLocal bool _early_abort_enabled;
+//----------------------------------------------------------------------------------------------
+
+//__Kill Policy Lookup Tables___________________________________________________________________
+G4ThreadLocal G4EmCalculator* _calculator;
+G4ThreadLocal std::vector<const G4Region*>* _rock_regions;
+//----------------------------------------------------------------------------------------------
+
+//__Look Up Rock Regions of Current Geometry___________________________________________________
+void _find_rock_regions() {
+  if (!_rock_regions)
+    _rock_regions = new std::vector<const G4Region*>;
+  _rock_regions->clear();
+  for (const auto& name : Construction::RockRegions()) {
+    const auto rock = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (rock)
+      _rock_regions->push_back(rock);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Region is Rock_____________________________________________________________________
+bool _is_rock(const G4Region* region) {
+  if (!_rock_regions)
+    _find_rock_regions();
+  return std::find(_rock_regions->cbegin(), _rock_regions->cend(), region) != _rock_regions->cend();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Distance from Point to Detector Bounding Box________________________________________________
+double _distance_to_detector(const G4ThreeVector& point) {
+  const auto& extent = Construction::Builder::GetDetectorExtent();
+  const auto dx = std::max({extent.GetXmin() - point.x(), 0.0, point.x() - extent.GetXmax()});
+  const auto dy = std::max({extent.GetYmin() - point.y(), 0.0, point.y() - extent.GetYmax()});
+  const auto dz = std::max({extent.GetZmin() - point.z(), 0.0, point.z() - extent.GetZmax()});
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Track cannot Reach the Detector____________________________________________________
+// The electromagnetic energy cut only holds in rock; in air or the cavern a soft photon can
+// still travel far enough to reach the detector, so there only charged ranges are compared.
+bool _is_unreachable(const G4Track* track,
+                     const double distance,
+                     const bool in_rock) {
+  if (distance <= _kill_safety)
+    return false;
+
+  const auto particle = track->GetParticleDefinition();
+  const auto energy = track->GetKineticEnergy();
+  const auto id = std::abs(particle->GetPDGEncoding());
+  if (in_rock && (id == 11 || id == 22) && energy < _kill_em_threshold)
+    return true;
+
+  if (particle->GetPDGCharge() != 0.0) {
+    const auto volume = track->GetVolume();
+    if (!volume)
+      return false;
+    const auto logical = volume->GetLogicalVolume();
+    const auto range = _calculator->GetCSDARange(energy, particle, logical->GetMaterial(), logical->GetRegion());
+    return range > 0.0 && range < distance;
+  }
+
+  return false;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Current Event has Detector Hits____________________________________________________
+bool _has_hits() {
+  if (Tracking::GetHitBuffer().GetSize())
+    return true;
+  const auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const auto collections = event ? event->GetHCofThisEvent() : nullptr;
+  if (!collections)
+    return false;
+  for (G4int i{}; i < collections->GetNumberOfCollections(); ++i) {
+    const auto collection = collections->GetHC(i);
+    if (collection && collection->GetSize())
+      return true;
+  }
+  return false;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Stacking Messenger Directory Path___________________________________________________________
+const std::string StackingAction::MessengerDirectory = "/kill/";
+//----------------------------------------------------------------------------------------------
+
+//__Stacking Action Constructor_________________________________________________________________
+StackingAction::StackingAction()
+    : G4UserStackingAction(), G4UImessenger(MessengerDirectory, "Track Kill Policy.") {
+  _kill_enabled = true;
+  _kill_em_threshold = 1*MeV;
+  _kill_safety = 1*m;
+  _early_abort_enabled = false;
+  if (!_calculator)
+    _calculator = new G4EmCalculator;
+
+  _enable = CreateCommand<Command::BoolArg>("enable", "Kill Tracks in Rock which cannot Reach the Detector.");
+  _enable->SetParameterName("enable", false);
+  _enable->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _early_abort = CreateCommand<Command::BoolArg>("early_abort",
+    "Abort Events without Hits once no Remaining Track can Reach the Detector.");
+  _early_abort->SetParameterName("enable", false);
+  _early_abort->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _em_threshold = CreateCommand<Command::DoubleUnitArg>("em_threshold",
+    "Set Kinetic Energy below which Electromagnetic Secondaries in Rock are Killed.");
+  _em_threshold->SetParameterName("energy", false);
+  _em_threshold->SetUnitCategory("Energy");
+  _em_threshold->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _safety = CreateCommand<Command::DoubleUnitArg>("safety",
+    "Set Distance from Detector within which no Tracks are Killed.");
+  _safety->SetParameterName("distance", false);
+  _safety->SetUnitCategory("Length");
+  _safety->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Classify New Track__________________________________________________________________________
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track) {
+  const auto volume = track->GetVolume();
+  const auto rock = volume && _is_rock(volume->GetLogicalVolume()->GetRegion());
+  const auto kill = _kill_enabled && track->GetParentID() && rock;
+  if (!kill && !_early_abort_enabled)
+    return fUrgent;
+
+  if (!_is_unreachable(track, _distance_to_detector(track->GetPosition()), rock))
+    return fUrgent;
+
+  return kill ? fKill : fWaiting;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Prepare Stacking for New Event_____________________________________________________________
+// /det/select and /det/layered rebuild the regions, so the rock lookup follows the geometry
+void StackingAction::PrepareNewEvent() {
+  _find_rock_regions();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Start New Stacking Stage____________________________________________________________________
+void StackingAction::NewStage() {
+  if (!_early_abort_enabled || !Construction::Builder::IsDetectorDataPerEvent() || _has_hits())
+    return;
+  Perf::Count(Perf::EarlyAborts);
+  stackManager->clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stacking Messenger Set New Value____________________________________________________________
+void StackingAction::SetNewValue(G4UIcommand* command,
+                                 G4String value) {
+  if (command == _enable) {
+    _kill_enabled = _enable->GetNewBoolValue(value);
+  } else if (command == _early_abort) {
+    _early_abort_enabled = _early_abort->GetNewBoolValue(value);
+  } else if (command == _em_threshold) {
+    _kill_em_threshold = _em_threshold->GetNewDoubleValue(value);
+  } else if (command == _safety) {
+    _kill_safety = _safety->GetNewDoubleValue(value);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace MATHUSLA::MU */
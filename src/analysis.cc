@@ -17,10 +17,25 @@
 
 #include "analysis.hh"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+
 #include <Geant4/tls.hh>
 
+#include <Geant4/G4AutoLock.hh>
+#include <Geant4/G4Threading.hh>
+
 #include <TFile.h>
+#include <TH2D.h>
 #include <TNamed.h>
+#include <TTree.h>
+
+#include "columnar.hh"
+#include "perf.hh"
+
+#include "util/io.hh"
+#include "util/queue.hh"
 
 namespace MATHUSLA { namespace MU {
 
@@ -43,11 +58,7 @@ bool Save(const std::string& path,
           SimSettingList entries) {
   TFile file(path.c_str(), "UPDATE");
   if (!file.IsZombie()) {
-    file.cd();
-    for (const auto entry : entries) {
-      TNamed setting(entry.name.c_str(), entry.text.c_str());
-      setting.Write();
-    }
+    Save(&file, entries);
     file.Close();
     return true;
   }
@@ -55,6 +66,28 @@ bool Save(const std::string& path,
 }
 //----------------------------------------------------------------------------------------------
 
+//__Save Simulation Entries To Open File as Entries and Metadata Tree___________________________
+bool Save(TFile* file,
+          const SimSettingList& entries) {
+  if (!file || file->IsZombie())
+    return false;
+  file->cd();
+  for (const auto& entry : entries)
+    TNamed(entry.name.c_str(), entry.text.c_str()).Write();
+  std::string key, value;
+  TTree metadata("metadata", "MU-SIM Run Metadata");
+  metadata.Branch("key", &key);
+  metadata.Branch("value", &value);
+  for (const auto& entry : entries) {
+    key = entry.name;
+    value = entry.text;
+    metadata.Fill();
+  }
+  metadata.Write();
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
 namespace ROOT { ///////////////////////////////////////////////////////////////////////////////
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
@@ -64,29 +97,368 @@ G4ThreadLocal std::unordered_map<std::string, int> _ntuple;
 //----------------------------------------------------------------------------------------------
 
 //__NTuple Data Storage_________________________________________________________________________
-G4ThreadLocal std::unordered_map<std::string, DataEntryList> _ntuple_data;
+struct _ntuple_storage {
+  DataKeyTypeList types;
+  std::vector<std::size_t> index;
+  DataEntryList real;
+  FloatDataEntryList real_float;
+  IntegerDataEntryList integer;
+  DataEntryList bound_real;
+  FloatDataEntryList bound_real_float;
+  IntegerDataEntryList bound_integer;
+  std::vector<int> column;
+  int run_column;
+  bool columnar;
+};
+G4ThreadLocal std::unordered_map<std::string, _ntuple_storage> _ntuple_data;
+//----------------------------------------------------------------------------------------------
+
+//__Single Precision Option_____________________________________________________________________
+bool _single_precision = false;
+//----------------------------------------------------------------------------------------------
+
+//__Asynchronous Writing Options________________________________________________________________
+bool _async_writing = false;
+std::size_t _async_queue_size = 64UL;
+//----------------------------------------------------------------------------------------------
+
+//__Batch Run Column Options____________________________________________________________________
+bool _run_column = false;
+G4ThreadLocal int _run_number{};
+//----------------------------------------------------------------------------------------------
+
+//__Row Handed to Writer Thread_________________________________________________________________
+struct _async_row {
+  _ntuple_storage* storage;
+  int id;
+  int run;
+  DataEntry single_values;
+  DataEntryList real;
+  FloatDataEntryList real_float;
+  IntegerDataEntryList integer;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Per-Thread Writer Thread and Row Queues_____________________________________________________
+struct _async_writer {
+  std::vector<std::unique_ptr<_async_row>> rows;
+  std::unique_ptr<util::queue::blocking<_async_row*>> filled, free;
+  std::thread thread;
+};
+G4ThreadLocal _async_writer* _writer = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Column Selection and Compression Options____________________________________________________
+DataKeyList _column_selection;
+std::string _compression_algorithm = "zlib";
+int _compression_level = 1;
+std::size_t _basket_size{};
+//----------------------------------------------------------------------------------------------
+
+//__ROOT Compression Algorithm Codes____________________________________________________________
+const std::unordered_map<std::string, int> _compression_codes{
+  {"zlib", 1}, {"lzma", 2}, {"lz4", 4}, {"zstd", 5}};
+//----------------------------------------------------------------------------------------------
+
+//__Apply Precision Option to Column Type_______________________________________________________
+DataKeyType _with_precision(const DataKeyType type) {
+  if (!_single_precision)
+    return type;
+  switch (type) {
+    case DataKeyType::Single: return DataKeyType::Float;
+    case DataKeyType::Vector: return DataKeyType::FloatVector;
+    default:                  return type;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Histogram Registry__________________________________________________________________________
+struct _histogram_definition {
+  HistogramAxis x, y;
+};
+std::unordered_map<std::string, _histogram_definition> _histogram_definitions;
+std::vector<std::string> _histogram_order;
+std::vector<Histogram2D*> _histograms;
+G4ThreadLocal std::unordered_map<std::string, Histogram2D*>* _local_histograms;
+G4Mutex _histogram_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Output Base Path for Current Thread_________________________________________________________
+const std::string _thread_base(const std::string& path) {
+  const auto extension = path.rfind(".root");
+  auto out = extension == std::string::npos ? path : path.substr(0UL, extension);
+  if (G4Threading::IsWorkerThread())
+    out += "_t" + std::to_string(G4Threading::G4GetThreadId());
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Fill Single Columns and Add Row to NTuple___________________________________________________
+void _add_row(G4AnalysisManager* manager,
+              const int id,
+              const _ntuple_storage& storage,
+              const DataEntry& single_values,
+              const int run) {
+  const auto size = storage.types.size();
+  const auto single_size = single_values.size();
+  for (std::size_t index{}, single_index{}; index < size && single_index < single_size; ++index) {
+    const auto column = storage.column[index];
+    switch (storage.types[index]) {
+      case DataKeyType::Single:
+        if (column >= 0)
+          manager->FillNtupleDColumn(id, column, single_values[single_index]);
+        ++single_index;
+        break;
+      case DataKeyType::Float:
+        if (column >= 0)
+          manager->FillNtupleFColumn(id, column, static_cast<float>(single_values[single_index]));
+        ++single_index;
+        break;
+      case DataKeyType::Integer:
+        if (column >= 0)
+          manager->FillNtupleIColumn(id, column, static_cast<int>(single_values[single_index]));
+        ++single_index;
+        break;
+      default:
+        break;
+    }
+  }
+  if (storage.run_column >= 0)
+    manager->FillNtupleIColumn(id, storage.run_column, run);
+  manager->AddNtupleRow(id);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Swap Vector Columns_________________________________________________________________________
+template<class List>
+void _swap_columns(List& left,
+                   List& right) {
+  right.resize(left.size());
+  for (std::size_t i{}; i < left.size(); ++i)
+    left[i].swap(right[i]);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Queued Row on Writer Thread___________________________________________________________
+void _write_async_row(G4AnalysisManager* manager,
+                      _async_row* row) {
+  auto& storage = *row->storage;
+  _swap_columns(row->real, storage.bound_real);
+  _swap_columns(row->real_float, storage.bound_real_float);
+  _swap_columns(row->integer, storage.bound_integer);
+  _add_row(manager, row->id, storage, row->single_values, row->run);
+  for (auto& entry : row->real)       entry.clear();
+  for (auto& entry : row->real_float) entry.clear();
+  for (auto& entry : row->integer)    entry.clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Start Writer Thread for Current Thread______________________________________________________
+void _start_writer() {
+  _writer = new _async_writer;
+  _writer->filled.reset(new util::queue::blocking<_async_row*>(_async_queue_size));
+  _writer->free.reset(new util::queue::blocking<_async_row*>(_async_queue_size));
+  _writer->rows.reserve(_async_queue_size);
+  for (std::size_t i{}; i < _async_queue_size; ++i) {
+    _writer->rows.emplace_back(new _async_row{});
+    auto row = _writer->rows.back().get();
+    _writer->free->push(std::move(row));
+  }
+
+  // the worker does not touch its analysis manager again until the writer is joined
+  const auto manager = G4AnalysisManager::Instance();
+  const auto writer = _writer;
+  _writer->thread = std::thread([=]() {
+    // pop keeps returning the queued rows after the worker closes the queue
+    _async_row* row = nullptr;
+    while (writer->filled->pop(row)) {
+      _write_async_row(manager, row);
+      writer->free->push(std::move(row));
+    }
+  });
+}
+//----------------------------------------------------------------------------------------------
+
+//__Drain and Stop Writer Thread for Current Thread_____________________________________________
+void _stop_writer() {
+  if (!_writer)
+    return;
+  _writer->filled->close();
+  if (_writer->thread.joinable())
+    _writer->thread.join();
+  delete _writer;
+  _writer = nullptr;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Hand Filled Row to Writer Thread____________________________________________________________
+void _push_async_row(const int id,
+                     _ntuple_storage& storage,
+                     const DataEntry& single_values) {
+  _async_row* row = nullptr;
+  if (!_writer->free->try_pop(row)) {
+    Perf::Count(Perf::WriteStalls);
+    _writer->free->pop(row);
+  }
+  row->storage = &storage;
+  row->id = id;
+  row->run = _run_number;
+  row->single_values.assign(single_values.cbegin(), single_values.cend());
+  _swap_columns(storage.real, row->real);
+  _swap_columns(storage.real_float, row->real_float);
+  _swap_columns(storage.integer, row->integer);
+  _writer->filled->push(std::move(row));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Find NTuple Storage Column__________________________________________________________________
+_ntuple_storage* _find_column(const std::string& name,
+                              const std::size_t column) {
+  auto search = _ntuple_data.find(name);
+  if (search == _ntuple_data.end() || column >= search->second.types.size())
+    return nullptr;
+  return &search->second;
+}
 //----------------------------------------------------------------------------------------------
 
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Setup ROOT Analysis Tool____________________________________________________________________
 void Setup() {
+  _stop_writer();
   _ntuple.clear();
+  _ntuple_data.clear();
   delete G4AnalysisManager::Instance();
   G4AnalysisManager::Instance()->SetNtupleMerging(false);
   G4AnalysisManager::Instance()->SetVerboseLevel(0);
+  G4AnalysisManager::Instance()->SetCompressionLevel(_compression_level);
+  if (_basket_size)
+    G4AnalysisManager::Instance()->SetBasketSize(static_cast<unsigned int>(_basket_size));
 }
 //----------------------------------------------------------------------------------------------
 
 //__Open Output File____________________________________________________________________________
 bool Open(const std::string& path) {
-  return G4AnalysisManager::Instance()->OpenFile(path);
+  _stop_writer();
+  if (Columnar::GetFormat() != Columnar::Format::ROOT)
+    Columnar::Open(_thread_base(path));
+  const auto out = G4AnalysisManager::Instance()->OpenFile(path);
+  if (out && _async_writing && G4Threading::IsWorkerThread())
+    _start_writer();
+  return out;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Save Output_________________________________________________________________________________
 bool Save() {
-  return G4AnalysisManager::Instance()->Write() && G4AnalysisManager::Instance()->CloseFile();
+  _stop_writer();
+  const auto columnar = Columnar::Close();
+  return columnar && G4AnalysisManager::Instance()->Write() && G4AnalysisManager::Instance()->CloseFile();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Close Output Segment and Reopen Output File_________________________________________________
+bool Rotate(const std::string& path,
+            const std::string& segment) {
+  _stop_writer();
+  const auto manager = G4AnalysisManager::Instance();
+  const auto columnar = Columnar::Rotate(_thread_base(segment));
+  const auto closed = manager->Write() && manager->CloseFile();
+  const auto renamed = util::io::rename_file(_thread_base(path) + ".root", _thread_base(segment) + ".root");
+  const auto opened = manager->OpenFile(path);
+  if (opened && _async_writing && G4Threading::IsWorkerThread())
+    _start_writer();
+  return columnar && closed && renamed && opened;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Store Floating Point Columns in Single Precision____________________________________________
+void SetSinglePrecision(const bool option) {
+  _single_precision = option;
+}
+bool IsSinglePrecision() {
+  return _single_precision;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Select NTuple Columns Written to File_______________________________________________________
+void SetColumnSelection(const DataKeyList& columns) {
+  _column_selection = columns;
+  if (std::find(columns.cbegin(), columns.cend(), "all") != columns.cend())
+    _column_selection.clear();
+}
+const DataKeyList& GetColumnSelection() {
+  return _column_selection;
+}
+bool IsColumnSelected(const DataKey& column) {
+  if (_column_selection.empty())
+    return true;
+  for (const auto& selected : _column_selection) {
+    if (!selected.empty() && selected.back() == '*') {
+      if (column.compare(0UL, selected.size() - 1UL, selected, 0UL, selected.size() - 1UL) == 0)
+        return true;
+    } else if (column == selected) {
+      return true;
+    }
+  }
+  return false;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write NTuple Rows on Background Thread______________________________________________________
+void SetAsyncWriting(const bool option) {
+  _async_writing = option;
+}
+bool IsAsyncWriting() {
+  return _async_writing;
+}
+void SetAsyncQueueSize(const std::size_t size) {
+  _async_queue_size = std::max(1UL, size);
+}
+std::size_t GetAsyncQueueSize() {
+  return _async_queue_size;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add RUN Column to NTuples for Batch Runs____________________________________________________
+void SetRunColumn(const bool option) {
+  _run_column = option;
+}
+bool HasRunColumn() {
+  return _run_column;
+}
+void SetRunNumber(const int run) {
+  _run_number = run;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Output File Compression and Basket Size_____________________________________________________
+bool SetCompressionAlgorithm(const std::string& algorithm) {
+  if (!_compression_codes.count(algorithm))
+    return false;
+  _compression_algorithm = algorithm;
+  return true;
+}
+const std::string& GetCompressionAlgorithm() {
+  return _compression_algorithm;
+}
+void SetCompressionLevel(const int level) {
+  _compression_level = std::max(0, std::min(9, level));
+}
+int GetCompressionLevel() {
+  return _compression_level;
+}
+void SetBasketSize(const std::size_t size) {
+  _basket_size = size;
+}
+std::size_t GetBasketSize() {
+  return _basket_size;
+}
+void ApplyCompression(TFile* file) {
+  if (!file)
+    return;
+  file->SetCompressionAlgorithm(_compression_codes.at(_compression_algorithm));
+  file->SetCompressionLevel(_compression_level);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -98,62 +470,230 @@ bool CreateNTuple(const std::string& name,
   const auto id = manager->CreateNtuple(name, name);
   const auto size = columns.size();
 
-  std::size_t vector_count{};
-  for (const auto& type : types) {
-    if (type == DataKeyType::Vector)
-      ++vector_count;
+  auto& storage = _ntuple_data[name];
+  storage.types.clear();
+  storage.index.clear();
+  storage.column.clear();
+  storage.types.reserve(size);
+  storage.index.reserve(size);
+  storage.column.reserve(size);
+
+  std::size_t real_count{}, float_count{}, integer_count{};
+  for (std::size_t index{}; index < size; ++index) {
+    const auto type = _with_precision(types[index]);
+    storage.types.push_back(type);
+    switch (type) {
+      case DataKeyType::Vector:        storage.index.push_back(real_count++);    break;
+      case DataKeyType::FloatVector:   storage.index.push_back(float_count++);   break;
+      case DataKeyType::IntegerVector: storage.index.push_back(integer_count++); break;
+      default:                         storage.index.push_back(0UL);             break;
+    }
   }
 
-  DataEntryList data;
-  data.resize(vector_count, {});
-  _ntuple_data.insert({name, data});
-  auto& list = _ntuple_data[name];
+  storage.real.assign(real_count, {});
+  storage.real_float.assign(float_count, {});
+  storage.integer.assign(integer_count, {});
+  storage.bound_real.assign(_writer ? real_count : 0UL, {});
+  storage.bound_real_float.assign(_writer ? float_count : 0UL, {});
+  storage.bound_integer.assign(_writer ? integer_count : 0UL, {});
+  auto& real       = _writer ? storage.bound_real       : storage.real;
+  auto& real_float = _writer ? storage.bound_real_float : storage.real_float;
+  auto& integer    = _writer ? storage.bound_integer    : storage.integer;
 
-  for (std::size_t index{}, vector_index{}; index < size; ++index) {
-    if (types[index] == DataKeyType::Vector) {
-      manager->CreateNtupleDColumn(id, columns[index], list[vector_index++]);
-    } else {
-      manager->CreateNtupleDColumn(id, columns[index]);
+  std::vector<bool> selected;
+  selected.reserve(size);
+  for (std::size_t index{}; index < size; ++index) {
+    const auto& column = columns[index];
+    const auto vector_index = storage.index[index];
+    selected.push_back(IsColumnSelected(column));
+    if (!selected.back()) {
+      storage.column.push_back(-1);
+      continue;
+    }
+    switch (storage.types[index]) {
+      case DataKeyType::Single:        storage.column.push_back(manager->CreateNtupleDColumn(id, column));                           break;
+      case DataKeyType::Float:         storage.column.push_back(manager->CreateNtupleFColumn(id, column));                           break;
+      case DataKeyType::Integer:       storage.column.push_back(manager->CreateNtupleIColumn(id, column));                           break;
+      case DataKeyType::Vector:        storage.column.push_back(manager->CreateNtupleDColumn(id, column, real[vector_index]));       break;
+      case DataKeyType::FloatVector:   storage.column.push_back(manager->CreateNtupleFColumn(id, column, real_float[vector_index])); break;
+      case DataKeyType::IntegerVector: storage.column.push_back(manager->CreateNtupleIColumn(id, column, integer[vector_index]));    break;
     }
   }
 
+  storage.run_column = _run_column ? manager->CreateNtupleIColumn(id, "RUN") : -1;
   manager->FinishNtuple(id);
+  storage.columnar = Columnar::GetFormat() != Columnar::Format::ROOT
+                  && Columnar::CreateTable(name, columns, storage.types, selected);
   return _ntuple.insert({name, id}).second;
 }
 //----------------------------------------------------------------------------------------------
 
+//__Get NTuple Real Vector Column_______________________________________________________________
+RealColumn GetRealColumn(const std::string& name,
+                         const std::size_t column) {
+  const auto storage = _find_column(name, column);
+  if (!storage)
+    return RealColumn{nullptr, nullptr};
+
+  const auto vector_index = storage->index[column];
+  switch (storage->types[column]) {
+    case DataKeyType::Vector:      return RealColumn{&storage->real[vector_index], nullptr};
+    case DataKeyType::FloatVector: return RealColumn{nullptr, &storage->real_float[vector_index]};
+    default:                       return RealColumn{nullptr, nullptr};
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get NTuple Integer Vector Column____________________________________________________________
+IntegerDataEntry* GetIntegerColumn(const std::string& name,
+                                   const std::size_t column) {
+  const auto storage = _find_column(name, column);
+  if (!storage || storage->types[column] != DataKeyType::IntegerVector)
+    return nullptr;
+  return &storage->integer[storage->index[column]];
+}
+//----------------------------------------------------------------------------------------------
+
 //__Fill ROOT NTuple____________________________________________________________________________
 bool FillNTuple(const std::string& name,
                 const DataKeyTypeList& types,
-                const DataEntry& single_values,
-                const DataEntryList& vector_values) {
-
+                const DataEntry& single_values) {
+  Perf::Scope scope(Perf::Fill);
   const auto search = _ntuple.find(name);
   if (search == _ntuple.cend())
     return false;
 
-  auto& data = _ntuple_data[name];
-  const auto vector_size = vector_values.size();
-  if (data.size() != vector_size)
+  auto& storage = _ntuple_data[name];
+  if (storage.types.size() != types.size())
     return false;
 
-  for (std::size_t i{}; i < vector_size; ++i)
-    data[i] = vector_values[i];
+  if (storage.columnar) {
+    const auto out = Columnar::AppendRow(name, storage.index, single_values,
+                                         storage.real, storage.real_float, storage.integer);
+    for (auto& entry : storage.real)       entry.clear();
+    for (auto& entry : storage.real_float) entry.clear();
+    for (auto& entry : storage.integer)    entry.clear();
+    return out;
+  }
 
-  const auto id = search->second;
-  const auto manager = G4AnalysisManager::Instance();
-  const auto size = types.size();
-  for (std::size_t index{}, single_index{}; index < size; ++index) {
-    if (types[index] == DataKeyType::Single) {
-      manager->FillNtupleDColumn(id, index, single_values[single_index++]);
-    }
+  if (_writer) {
+    _push_async_row(search->second, storage, single_values);
+    return true;
   }
 
-  manager->AddNtupleRow(id);
+  _add_row(G4AnalysisManager::Instance(), search->second, storage, single_values, _run_number);
+
+  for (auto& entry : storage.real)       entry.clear();
+  for (auto& entry : storage.real_float) entry.clear();
+  for (auto& entry : storage.integer)    entry.clear();
   return true;
 }
 //----------------------------------------------------------------------------------------------
 
+//__Histogram Initializer_______________________________________________________________________
+bool CreateHistogram(const std::string& name,
+                     const HistogramAxis& x,
+                     const HistogramAxis& y) {
+  if (!x.bins || !y.bins || !(x.max > x.min) || !(y.max > y.min))
+    return false;
+  G4AutoLock lock(&_histogram_mutex);
+  if (_histogram_definitions.count(name))
+    return true;
+  _histogram_definitions.insert({name, {x, y}});
+  _histogram_order.push_back(name);
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread-Local Histogram for Filling______________________________________________________
+Histogram2D* GetHistogram(const std::string& name) {
+  if (!_local_histograms)
+    _local_histograms = new std::unordered_map<std::string, Histogram2D*>;
+  auto& out = (*_local_histograms)[name];
+  if (!out) {
+    G4AutoLock lock(&_histogram_mutex);
+    const auto definition = _histogram_definitions.find(name);
+    if (definition == _histogram_definitions.cend())
+      return nullptr;
+    const auto& x = definition->second.x;
+    const auto& y = definition->second.y;
+    out = new Histogram2D{name, x, y, std::vector<double>((x.bins + 2UL) * (y.bins + 2UL)), 0UL, false};
+    _histograms.push_back(out);
+  }
+  out->active = true;
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Histograms of All Threads_____________________________________________________________
+void ResetHistograms() {
+  G4AutoLock lock(&_histogram_mutex);
+  for (auto histogram : _histograms) {
+    std::fill(histogram->counts.begin(), histogram->counts.end(), 0.0);
+    histogram->entries = 0UL;
+    histogram->active = false;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Merge Histogram of All Threads______________________________________________________________
+bool MergeHistogram(const std::string& name,
+                    Histogram2D& out) {
+  G4AutoLock lock(&_histogram_mutex);
+  const auto definition = _histogram_definitions.find(name);
+  if (definition == _histogram_definitions.cend())
+    return false;
+  const auto& x = definition->second.x;
+  const auto& y = definition->second.y;
+  out = Histogram2D{name, x, y, std::vector<double>((x.bins + 2UL) * (y.bins + 2UL)), 0UL, false};
+  for (const auto histogram : _histograms) {
+    if (histogram->name != name || !histogram->active)
+      continue;
+    out.active = true;
+    for (std::size_t i{}; i < out.counts.size(); ++i)
+      out.counts[i] += histogram->counts[i];
+    out.entries += histogram->entries;
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Histogram to File_____________________________________________________________________
+bool WriteHistogram(TFile* file,
+                    const Histogram2D& histogram,
+                    const std::string& name) {
+  if (!file)
+    return false;
+  const auto& x = histogram.x;
+  const auto& y = histogram.y;
+  file->cd();
+  TH2D out(name.c_str(), name.c_str(), x.bins, x.min, x.max, y.bins, y.min, y.max);
+  out.SetDirectory(nullptr);
+  for (std::size_t j{}; j < y.bins + 2UL; ++j)
+    for (std::size_t i{}; i < x.bins + 2UL; ++i)
+      out.SetBinContent(static_cast<int>(i), static_cast<int>(j), histogram.counts[i + (x.bins + 2UL) * j]);
+  out.SetEntries(static_cast<double>(histogram.entries));
+  return out.Write() > 0;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Merge Histograms of All Threads and Write to File___________________________________________
+std::size_t WriteHistograms(TFile* file) {
+  std::vector<std::string> names;
+  {
+    G4AutoLock lock(&_histogram_mutex);
+    names = _histogram_order;
+  }
+  std::size_t written{};
+  for (const auto& name : names) {
+    Histogram2D merged;
+    if (MergeHistogram(name, merged) && merged.active && WriteHistogram(file, merged, name))
+      ++written;
+  }
+  return written;
+}
+//----------------------------------------------------------------------------------------------
+
 } /* namespace ROOT */ /////////////////////////////////////////////////////////////////////////
 
 } /* namespace Analysis */ /////////////////////////////////////////////////////////////////////
@@ -0,0 +1,197 @@
+/* src/analyze.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "reader.hh"
+
+#include "util/command_line_parser.hh"
+#include "util/error.hh"
+#include "util/string.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Running Summary of Column Values____________________________________________________________
+struct _summary {
+  std::size_t values{};
+  double sum{};
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+
+  void add(const double value) {
+    ++values;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+
+  void merge(const _summary& other) {
+    values += other.values;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+};
+//----------------------------------------------------------------------------------------------
+
+//__Add Column Values of Row to Summary_________________________________________________________
+void _add_row(const Reader::Row& row,
+              std::vector<_summary>& out) {
+  for (std::size_t i{}; i < row.schema.size(); ++i) {
+    switch (row.schema[i].type) {
+      case Reader::ColumnType::RealVector:
+      case Reader::ColumnType::FloatVector:
+        for (const auto value : row.Reals(i))
+          out[i].add(value);
+        break;
+      case Reader::ColumnType::IntegerVector:
+        for (const auto value : row.Integers(i))
+          out[i].add(value);
+        break;
+      case Reader::ColumnType::Unknown:
+        break;
+      default:
+        out[i].add(row.Real(i));
+        break;
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Column Summary Table__________________________________________________________________
+void _print_summary(const Reader::Schema& schema,
+                    const std::vector<_summary>& summary,
+                    const std::size_t files,
+                    const std::size_t entries) {
+  std::cout << "\nColumn Summary (" << files << (files == 1UL ? " File, " : " Files, ")
+            << entries << " Entries):\n"
+            << "  " << std::left << std::setw(28) << "COLUMN" << std::setw(16) << "TYPE"
+            << std::right << std::setw(12) << "VALUES" << std::setw(16) << "MEAN"
+            << std::setw(16) << "MIN" << std::setw(16) << "MAX" << "\n";
+  for (std::size_t i{}; i < schema.size(); ++i) {
+    const auto& column = summary[i];
+    std::cout << "  " << std::left << std::setw(28) << schema[i].name
+              << std::setw(16) << Reader::TypeName(schema[i].type)
+              << std::right << std::setw(12) << column.values;
+    if (column.values) {
+      std::cout << std::setw(16) << column.sum / column.values
+                << std::setw(16) << column.min
+                << std::setw(16) << column.max;
+    }
+    std::cout << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+//__Main Function: Analyze______________________________________________________________________
+int main(int argc, char* argv[]) {
+  using namespace MATHUSLA;
+  using namespace MATHUSLA::MU;
+
+  using util::cli::option;
+
+  option help_opt    ('h', "help",     "MATHUSLA Muon Simulation Analysis", option::no_arguments);
+  option tree_opt    ('t', "tree",     "Detector Tree Name",               option::required_arguments);
+  option columns_opt ('c', "columns",  "Columns to Read",                  option::required_arguments);
+  option thread_opt  ('j', "threads",  "Number of Reader Threads or auto", option::required_arguments);
+  option cache_opt   (0,   "cache",    "Tree Cache Size in MB",            option::required_arguments);
+  option schema_opt  (0,   "schema",   "Print Tree Schema",                option::no_arguments);
+  option metadata_opt(0,   "metadata", "Print Run Metadata",               option::no_arguments);
+
+  const auto operand_count = util::cli::parse(argv,
+    {&help_opt, &tree_opt, &columns_opt, &thread_opt, &cache_opt, &schema_opt, &metadata_opt});
+
+  util::error::exit_when(operand_count < 2UL,
+    "Usage: ", argv[0], " [options] <file or directory>...\n");
+
+  std::vector<std::string> paths;
+  for (std::size_t i = 1UL; i < operand_count; ++i)
+    for (const auto& path : Reader::FindFiles(argv[i]))
+      paths.push_back(path);
+  util::error::exit_when(paths.empty(),
+    "[FATAL ERROR] No ROOT Files Found.\n");
+
+  const std::string tree = tree_opt.argument ? tree_opt.argument : Reader::DefaultTree(paths.front());
+  util::error::exit_when(tree.empty(),
+    "[FATAL ERROR] No Detector Tree in File: ", paths.front(), "\n");
+
+  if (metadata_opt.count) {
+    std::cout << "Metadata of " << paths.front() << ":\n";
+    for (const auto& entry : Reader::ReadMetadata(paths.front()))
+      std::cout << "  " << std::left << std::setw(32) << entry.first << entry.second << "\n";
+  }
+
+  const auto schema = Reader::ReadSchema(paths.front(), tree);
+  if (schema_opt.count) {
+    std::cout << "Schema of " << tree << ":\n";
+    for (const auto& column : schema)
+      std::cout << "  " << std::left << std::setw(28) << column.name << Reader::TypeName(column.type) << "\n";
+  }
+  if (schema_opt.count || metadata_opt.count)
+    return 0;
+
+  std::vector<std::string> columns;
+  if (columns_opt.argument) {
+    util::string::split(columns_opt.argument, columns, ", ");
+    columns.erase(std::remove(columns.begin(), columns.end(), ""), columns.end());
+  } else {
+    for (const auto& column : schema)
+      columns.push_back(column.name);
+  }
+
+  std::size_t threads = 1UL;
+  if (thread_opt.argument) {
+    const std::string opt = thread_opt.argument;
+    try {
+      threads = opt == "auto" ? std::max(1U, std::thread::hardware_concurrency()) : std::stoul(opt);
+    } catch (...) {
+      threads = 1UL;
+    }
+  }
+  if (cache_opt.argument)
+    Reader::SetCacheSize(static_cast<long long>(std::stod(cache_opt.argument) * 1024.0 * 1024.0));
+
+  std::vector<std::vector<_summary>> summaries(std::max(1UL, threads), std::vector<_summary>(columns.size()));
+  Reader::Schema types;
+  for (const auto& column : columns) {
+    const auto search = std::find_if(schema.cbegin(), schema.cend(),
+      [&](const auto& entry) { return entry.name == column; });
+    types.push_back({column, search != schema.cend() ? search->type : Reader::ColumnType::Unknown});
+  }
+
+  const auto entries = Reader::Traverse(paths, tree, columns,
+    [&](const Reader::Row& row) { _add_row(row, summaries[row.worker]); }, threads);
+
+  for (std::size_t i = 1UL; i < summaries.size(); ++i)
+    for (std::size_t j{}; j < columns.size(); ++j)
+      summaries.front()[j].merge(summaries[i][j]);
+  _print_summary(types, summaries.front(), paths.size(), entries);
+  return 0;
+}
+//----------------------------------------------------------------------------------------------
@@ -0,0 +1,349 @@
+/* src/benchmarks.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "analysis.hh"
+#include "tracking.hh"
+#include "geometry/Construction.hh"
+#include "geometry/Prototype.hh"
+#include "physics/CORSIKAReaderGenerator.hh"
+#include "physics/Generator.hh"
+#include "physics/MuonTransport.hh"
+#include "physics/Units.hh"
+
+#include "util/command_line_parser.hh"
+#include "util/error.hh"
+#include "util/io.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Benchmark Clock_____________________________________________________________________________
+using _clock = std::chrono::steady_clock;
+//----------------------------------------------------------------------------------------------
+
+//__End-to-End Scenario_________________________________________________________________________
+struct _scenario {
+  std::string name, script;
+  bool needs_corsika;
+};
+const std::vector<_scenario> _scenarios{
+  {"box_corsika",      "scripts/benchmarks/box_corsika.mac",      true},
+  {"prototype_pythia", "scripts/benchmarks/prototype_pythia.mac", false},
+  {"flat_range",       "scripts/benchmarks/flat_range.mac",       false},
+  {"muon_mapper",      "scripts/benchmarks/muon_mapper.mac",      false},
+  {"box_boolean",      "scripts/benchmarks/box_boolean.mac",      false},
+  {"box_layered",      "scripts/benchmarks/box_layered.mac",      false}};
+//----------------------------------------------------------------------------------------------
+
+//__Benchmark Result Output_____________________________________________________________________
+std::ostream* _out = &std::cout;
+void _write_result(const std::string& kind,
+                   const std::string& name,
+                   const std::size_t threads,
+                   const std::size_t count,
+                   const double seconds) {
+  *_out << kind << ',' << name << ',' << threads << ',' << count << ','
+        << seconds << ',' << (seconds > 0 ? count / seconds : 0.0) << '\n';
+  _out->flush();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Time Function over Iterations_______________________________________________________________
+template<class Function>
+double _time(const std::size_t iterations,
+             Function&& function) {
+  const auto start = _clock::now();
+  for (std::size_t i{}; i < iterations; ++i)
+    function(i);
+  return std::chrono::duration<double>(_clock::now() - start).count();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Thread Counts for Scaling Curve_____________________________________________________________
+const std::vector<std::size_t> _thread_counts(const std::size_t max) {
+  std::vector<std::size_t> out;
+  for (std::size_t count = 1UL; count < max; count *= 2UL)
+    out.push_back(count);
+  out.push_back(max);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Synthetic Generator Event___________________________________________________________________
+const Physics::ParticleVector _synthetic_event(const std::size_t size) {
+  Physics::ParticleVector out;
+  out.reserve(size);
+  for (std::size_t i{}; i < size; ++i)
+    out.emplace_back(i % 2 ? 13 : -13, 0, 0, 0, -100*m, 1*GeVperC, 2*GeVperC, -100*GeVperC);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Run Microbenchmarks_________________________________________________________________________
+void _run_micro(const std::size_t iterations,
+                const std::string& corsika) {
+  const std::string cut = "13, -13 | 10 GeV/c : 100 GeV/c | -1.0 : 1.0 | 0 deg : 10 deg";
+  _write_result("micro", "ParsePropagationList", 1UL, iterations, _time(iterations, [&](std::size_t) {
+    volatile auto size = Physics::ParsePropagationList(cut).size();
+    static_cast<void>(size);
+  }));
+
+  const std::string temp_path = ".benchmark.root";
+  const std::string name = "benchmark";
+  Analysis::ROOT::Setup();
+  Analysis::ROOT::Open(temp_path);
+  Analysis::ROOT::CreateNTuple(name,
+                               Analysis::ROOT::DefaultDataKeyList,
+                               Analysis::ROOT::DefaultDataKeyTypeList);
+
+  const auto event = _synthetic_event(64UL);
+  _write_result("micro", "ConvertToAnalysis", 1UL, iterations, _time(iterations, [&](std::size_t) {
+    Tracking::ConvertToAnalysis(event, name);
+  }));
+  _write_result("micro", "FillNTuple", 1UL, iterations, _time(iterations, [&](std::size_t) {
+    Tracking::ConvertToAnalysis(event, name);
+    Analysis::ROOT::FillNTuple(name, Analysis::ROOT::DefaultDataKeyTypeList, {0, 64});
+  }));
+
+  Analysis::ROOT::Save();
+  util::io::remove_file(temp_path);
+
+  if (corsika.empty())
+    return;
+
+  const std::size_t shower_iterations = 10UL;
+  Physics::CORSIKAEvent shower;
+  _write_result("micro", "_collect_source", 1UL, shower_iterations, _time(shower_iterations, [&](std::size_t) {
+    Physics::CORSIKAConfig config{};
+    Physics::ReadCORSIKAShower(corsika, Physics::Particle(), config, shower);
+  }));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Run End-to-End Scenarios____________________________________________________________________
+void _run_scenarios(const std::string& simulation,
+                    const std::string& selected,
+                    const std::size_t events,
+                    const std::size_t max_threads,
+                    const std::string& seed,
+                    const std::string& corsika) {
+  const std::string data_dir = ".benchmarks";
+  for (const auto& scenario : _scenarios) {
+    if (selected != "all" && selected != scenario.name)
+      continue;
+    if (scenario.needs_corsika && corsika.empty()) {
+      std::cerr << "Skipping " << scenario.name << ": no CORSIKA file given.\n";
+      continue;
+    }
+    for (const auto threads : _thread_counts(max_threads)) {
+      auto command = simulation
+                   + " -q -j " + std::to_string(threads)
+                   + " --seed=" + seed
+                   + " -o " + data_dir
+                   + " -s " + scenario.script
+                   + " events " + std::to_string(events);
+      if (scenario.needs_corsika)
+        command += " file " + corsika;
+      command += " > /dev/null 2>&1";
+
+      int status{};
+      const auto seconds = _time(1UL, [&](std::size_t) { status = std::system(command.c_str()); });
+      if (status) {
+        std::cerr << "Scenario " << scenario.name << " failed with " << threads << " threads.\n";
+        continue;
+      }
+      _write_result("scenario", scenario.name, threads, events, seconds);
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Report Validation Check_____________________________________________________________________
+bool _report_check(const std::string& name,
+                   const bool passed,
+                   const std::string& detail) {
+  std::cerr << "[" << (passed ? "PASS" : "FAIL") << "] " << name << ": " << detail << "\n";
+  return passed;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check Width of Interpolated Muon Transport__________________________________________________
+// Both ends of the table hold the same uniform energy loss and displacement spread, so a muon
+// between them must see that spread unchanged. Averaging one sample from each neighbouring
+// bin would narrow it by sqrt(2).
+bool _check_transport_width() {
+  const std::string path = ".benchmark_transport.txt";
+  const std::size_t rows = 1000UL;
+  {
+    std::ofstream table(path);
+    for (std::size_t i{}; i < rows; ++i) {
+      const auto loss = 1.0 + 4.0 * (i + 0.5) / rows;
+      const auto displacement = 2.0 * (i + 0.5) / rows;
+      table << "10 1000 "   << 10.0 - loss   << ' ' << displacement << " 0.01\n";
+      table << "1000 1000 " << 1000.0 - loss << ' ' << displacement << " 0.01\n";
+    }
+  }
+
+  Physics::MuonTransportModel model;
+  const auto loaded = model.Load(path);
+  util::io::remove_file(path);
+  if (!loaded)
+    return _report_check("MuonTransportWidth", false, "unable to load table");
+
+  const std::size_t draws = 100000UL;
+  double loss_sum{}, loss_square{}, displacement_sum{}, displacement_square{};
+  for (std::size_t i{}; i < draws; ++i) {
+    const auto transport = model.Interpolate(100*GeV, 1000);
+    const auto loss = transport.loss / GeV;
+    const auto displacement = transport.displacement / m;
+    loss_sum += loss;
+    loss_square += loss * loss;
+    displacement_sum += displacement;
+    displacement_square += displacement * displacement;
+  }
+  const auto loss_mean = loss_sum / draws;
+  const auto displacement_mean = displacement_sum / draws;
+  const auto loss_width = std::sqrt(loss_square / draws - loss_mean * loss_mean);
+  const auto displacement_width = std::sqrt(displacement_square / draws - displacement_mean * displacement_mean);
+
+  const auto expected_loss = 4.0 / std::sqrt(12.0);
+  const auto expected_displacement = 2.0 / std::sqrt(12.0);
+  const auto passed = std::abs(loss_width / expected_loss - 1.0) < 0.05
+                   && std::abs(displacement_width / expected_displacement - 1.0) < 0.05;
+  return _report_check("MuonTransportWidth", passed,
+    "loss width " + std::to_string(loss_width) + " GeV (expected " + std::to_string(expected_loss)
+    + "), displacement width " + std::to_string(displacement_width) + " m (expected "
+    + std::to_string(expected_displacement) + ")");
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check Prototype Volume Table with Geometry Cache_____________________________________________
+// The detector is built once without the cache, saved to it, and built again from it. The
+// sensitive volume table rebuilt from the cached world has to match the constructed one.
+bool _check_prototype_cache() {
+  Construction::Builder::SetCacheDirectory("");
+  Construction::Builder builder("Prototype", "", false);
+  builder.Construct();
+
+  struct _entry { int id; std::string name; G4Transform3D global; };
+  std::vector<_entry> expected;
+  for (const auto& entry : Prototype::Detector::SensitiveVolumes())
+    if (entry.id >= 0)
+      expected.push_back({entry.id, entry.name, entry.global});
+
+  util::io::create_directory(".benchmarks");
+  Construction::Builder::SetCacheDirectory(".benchmarks/cache");
+  builder.ConstructSDandField();
+  builder.Construct();
+  Construction::Builder::SetCacheDirectory("");
+
+  std::size_t loaded{}, mismatched{};
+  for (const auto& entry : Prototype::Detector::SensitiveVolumes())
+    if (entry.id >= 0)
+      ++loaded;
+  for (const auto& entry : expected) {
+    const auto& table = Prototype::Detector::SensitiveVolumes();
+    const auto found = std::find_if(table.cbegin(), table.cend(), [&](const auto& other) {
+      return other.id == entry.id; });
+    if (found == table.cend()
+        || found->name != entry.name
+        || Prototype::Detector::DecodeDetector(entry.id) != entry.name
+        || (found->global.getTranslation() - entry.global.getTranslation()).mag() > 1*um
+        || !found->global.getRotation().isNear(entry.global.getRotation(), 1e-9))
+      ++mismatched;
+  }
+
+  return _report_check("PrototypeCacheVolumes", !expected.empty() && loaded == expected.size() && !mismatched,
+    std::to_string(loaded) + " of " + std::to_string(expected.size()) + " sensitive volumes loaded from cache, "
+    + std::to_string(mismatched) + " mismatched");
+}
+//----------------------------------------------------------------------------------------------
+
+//__Run Validation Checks_______________________________________________________________________
+bool _run_checks() {
+  auto passed = true;
+  passed &= _check_transport_width();
+  passed &= _check_prototype_cache();
+  return passed;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+//__Main Function: Benchmarks___________________________________________________________________
+int main(int argc, char* argv[]) {
+  using namespace MATHUSLA;
+  using namespace MATHUSLA::MU;
+
+  using util::cli::option;
+
+  option help_opt    ('h', "help",       "MATHUSLA Muon Simulation Benchmarks", option::no_arguments);
+  option micro_opt   ('m', "micro",      "Only Run Microbenchmarks",            option::no_arguments);
+  option check_opt   ('c', "check",      "Only Run Validation Checks",          option::no_arguments);
+  option scenario_opt(0,   "scenario",   "Only Run Scenario (default: all)",    option::required_arguments);
+  option events_opt  ('e', "events",     "Events per Scenario",                 option::required_arguments);
+  option iter_opt    ('n', "iterations", "Microbenchmark Iterations",           option::required_arguments);
+  option thread_opt  ('j', "threads",    "Maximum Number of Threads",           option::required_arguments);
+  option seed_opt    (0,   "seed",       "Random Seed",                         option::required_arguments);
+  option corsika_opt (0,   "corsika",    "CORSIKA ROOT File",                   option::required_arguments);
+  option sim_opt     (0,   "sim",        "Simulation Executable",               option::required_arguments);
+  option out_opt     ('o', "out",        "Results CSV File",                    option::required_arguments);
+
+  util::cli::parse(argv,
+    {&help_opt, &micro_opt, &check_opt, &scenario_opt, &events_opt, &iter_opt, &thread_opt,
+     &seed_opt, &corsika_opt, &sim_opt, &out_opt});
+
+  std::ofstream file;
+  if (out_opt.argument) {
+    file.open(out_opt.argument);
+    util::error::exit_when(!file, "[FATAL ERROR] Unable to Open Results File: ", out_opt.argument, "\n");
+    _out = &file;
+  }
+
+  const auto hardware = static_cast<std::size_t>(std::thread::hardware_concurrency());
+  const auto max_threads = thread_opt.argument ? std::stoul(thread_opt.argument) : std::max(1UL, hardware);
+  const auto events      = events_opt.argument ? std::stoul(events_opt.argument) : 1000UL;
+  const auto iterations  = iter_opt.argument   ? std::stoul(iter_opt.argument)   : 10000UL;
+  const auto seed        = seed_opt.argument   ? std::string(seed_opt.argument)  : "1";
+  const auto corsika     = corsika_opt.argument ? std::string(corsika_opt.argument) : "";
+  const auto simulation  = sim_opt.argument    ? std::string(sim_opt.argument)   : "./simulation";
+  const auto scenario    = scenario_opt.argument ? std::string(scenario_opt.argument) : "all";
+
+  Units::Define();
+
+  if (check_opt.count)
+    return _run_checks() ? 0 : 1;
+
+  *_out << "kind,name,threads,count,seconds,rate\n";
+  _run_micro(iterations, corsika);
+  if (!micro_opt.count)
+    _run_scenarios(simulation, scenario, events, max_threads, seed, corsika);
+
+  return 0;
+}
+//----------------------------------------------------------------------------------------------
@@ -0,0 +1,440 @@
+/* src/columnar.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "columnar.hh"
+
+#include <algorithm>
+
+#include <Geant4/tls.hh>
+
+#include "util/io.hh"
+
+#ifdef MU__WITH_ARROW
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/util/compression.h>
+#include <arrow/util/key_value_metadata.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+#endif
+
+namespace MATHUSLA { namespace MU {
+
+namespace Analysis { ///////////////////////////////////////////////////////////////////////////
+
+namespace Columnar { ///////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Output Backend Settings_____________________________________________________________________
+Format _format = Format::ROOT;
+std::size_t _row_group_size = 8192UL;
+//----------------------------------------------------------------------------------------------
+
+//__Dictionary-Encoded Column___________________________________________________________________
+const std::string _dictionary_column = "Detector";
+//----------------------------------------------------------------------------------------------
+
+//__Thread Output Base Path and Metadata________________________________________________________
+G4ThreadLocal std::string _base;
+G4ThreadLocal SimSettingList _metadata;
+//----------------------------------------------------------------------------------------------
+
+#ifdef MU__WITH_ARROW
+
+//__Columnar Table Writer_______________________________________________________________________
+struct _table {
+  std::string path;
+  ROOT::DataKeyTypeList types;
+  std::vector<bool> dictionary;
+  std::shared_ptr<arrow::Schema> schema;
+  std::vector<std::shared_ptr<arrow::ArrayBuilder>> builders;
+  std::size_t rows;
+  std::shared_ptr<arrow::io::FileOutputStream> sink;
+  std::unique_ptr<parquet::arrow::FileWriter> parquet;
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> ipc;
+};
+G4ThreadLocal std::unordered_map<std::string, _table> _tables;
+//----------------------------------------------------------------------------------------------
+
+//__Convert Column Type to Arrow Type___________________________________________________________
+std::shared_ptr<arrow::DataType> _arrow_type(const ROOT::DataKeyType type,
+                                             const bool dictionary) {
+  switch (type) {
+    case ROOT::DataKeyType::Single:        return arrow::float64();
+    case ROOT::DataKeyType::Float:         return arrow::float32();
+    case ROOT::DataKeyType::Integer:       return arrow::int32();
+    case ROOT::DataKeyType::Vector:        return arrow::list(arrow::float64());
+    case ROOT::DataKeyType::FloatVector:   return arrow::list(arrow::float32());
+    case ROOT::DataKeyType::IntegerVector:
+      return arrow::list(dictionary ? arrow::dictionary(arrow::int32(), arrow::int32()) : arrow::int32());
+  }
+  return arrow::null();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Convert Simulation Settings to Arrow Metadata_______________________________________________
+std::shared_ptr<arrow::KeyValueMetadata> _key_value_metadata() {
+  std::vector<std::string> keys, values;
+  keys.reserve(_metadata.size());
+  values.reserve(_metadata.size());
+  for (const auto& entry : _metadata) {
+    keys.push_back(entry.name);
+    values.push_back(entry.text);
+  }
+  return arrow::key_value_metadata(keys, values);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Open Table Output File______________________________________________________________________
+bool _open_writer(_table& table) {
+  auto sink = arrow::io::FileOutputStream::Open(table.path);
+  if (!sink.ok())
+    return false;
+  table.sink = std::move(sink).ValueUnsafe();
+  table.schema = table.schema->WithMetadata(_key_value_metadata());
+
+  if (_format == Format::Parquet) {
+    parquet::WriterProperties::Builder properties;
+    properties.compression(parquet::Compression::ZSTD);
+    properties.max_row_group_length(static_cast<int64_t>(_row_group_size));
+    parquet::ArrowWriterProperties::Builder arrow_properties;
+    arrow_properties.store_schema();
+    auto writer = parquet::arrow::FileWriter::Open(*table.schema, arrow::default_memory_pool(), table.sink,
+                                                   properties.build(), arrow_properties.build());
+    if (!writer.ok())
+      return false;
+    table.parquet = std::move(writer).ValueUnsafe();
+  } else {
+    auto options = arrow::ipc::IpcWriteOptions::Defaults();
+    auto codec = arrow::util::Codec::Create(arrow::Compression::ZSTD);
+    if (codec.ok())
+      options.codec = std::move(codec).ValueUnsafe();
+    options.emit_dictionary_deltas = true;
+    auto writer = arrow::ipc::MakeStreamWriter(table.sink, table.schema, options);
+    if (!writer.ok())
+      return false;
+    table.ipc = std::move(writer).ValueUnsafe();
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Buffered Rows as Record Batch or Row Group____________________________________________
+bool _flush(_table& table) {
+  if (!table.rows)
+    return true;
+  if (!table.parquet && !table.ipc && !_open_writer(table))
+    return false;
+
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  arrays.reserve(table.builders.size());
+  for (auto& builder : table.builders) {
+    if (!builder)
+      continue;
+    std::shared_ptr<arrow::Array> array;
+    if (!builder->Finish(&array).ok())
+      return false;
+    arrays.push_back(array);
+  }
+
+  const auto rows = static_cast<int64_t>(table.rows);
+  table.rows = 0UL;
+  const auto batch = arrow::RecordBatch::Make(table.schema, rows, arrays);
+  if (table.ipc)
+    return table.ipc->WriteRecordBatch(*batch).ok();
+
+  const auto group = arrow::Table::FromRecordBatches({batch});
+  return group.ok() && table.parquet->WriteTable(**group, rows).ok();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Flush and Close Table Output File___________________________________________________________
+bool _close_writer(_table& table) {
+  auto out = _flush(table);
+  if (table.parquet)
+    out = table.parquet->Close().ok() && out;
+  if (table.ipc)
+    out = table.ipc->Close().ok() && out;
+  if (table.sink)
+    out = table.sink->Close().ok() && out;
+  table.parquet.reset();
+  table.ipc.reset();
+  table.sink.reset();
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Append Vector to List Column________________________________________________________________
+template<class Builder, class Entry>
+arrow::Status _append_list(arrow::ArrayBuilder* builder,
+                           const Entry& entry) {
+  const auto list = static_cast<arrow::ListBuilder*>(builder);
+  auto status = list->Append();
+  if (status.ok())
+    status = static_cast<Builder*>(list->value_builder())->AppendValues(entry.data(),
+                                                                        static_cast<int64_t>(entry.size()));
+  return status;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Append Vector to Dictionary-Encoded List Column_____________________________________________
+arrow::Status _append_dictionary_list(arrow::ArrayBuilder* builder,
+                                      const ROOT::IntegerDataEntry& entry) {
+  const auto list = static_cast<arrow::ListBuilder*>(builder);
+  auto status = list->Append();
+  const auto values = static_cast<arrow::Dictionary32Builder<arrow::Int32Type>*>(list->value_builder());
+  for (std::size_t i{}; status.ok() && i < entry.size(); ++i)
+    status = values->Append(entry[i]);
+  return status;
+}
+//----------------------------------------------------------------------------------------------
+
+#endif /* MU__WITH_ARROW */
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Columnar Backend Availability_______________________________________________________________
+bool Available() {
+#ifdef MU__WITH_ARROW
+  return true;
+#else
+  return false;
+#endif
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Output Backend Format___________________________________________________________________
+bool SetFormat(const Format format) {
+  if (format != Format::ROOT && !Available())
+    return false;
+  _format = format;
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Output Backend Format___________________________________________________________________
+Format GetFormat() {
+  return _format;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Output Backend Format Name______________________________________________________________
+const std::string FormatName(const Format format) {
+  switch (format) {
+    case Format::Arrow:   return "arrow";
+    case Format::Parquet: return "parquet";
+    default:              return "root";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Output File Extension___________________________________________________________________
+const std::string Extension() {
+  switch (_format) {
+    case Format::Arrow:   return ".arrows";
+    case Format::Parquet: return ".parquet";
+    default:              return ".root";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Rows per Record Batch or Row Group______________________________________________________
+void SetRowGroupSize(const std::size_t rows) {
+  _row_group_size = std::max(1UL, rows);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Rows per Record Batch or Row Group______________________________________________________
+std::size_t GetRowGroupSize() {
+  return _row_group_size;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Path of Columnar Output Table_______________________________________________________________
+const std::string TablePath(const std::string& base,
+                            const std::string& name) {
+  return base + "_" + name + Extension();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Open Columnar Output for Current Thread_____________________________________________________
+bool Open(const std::string& base) {
+#ifdef MU__WITH_ARROW
+  _tables.clear();
+#endif
+  _base = base;
+  _metadata.clear();
+  return Available() && _format != Format::ROOT;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Close Columnar Output for Current Thread____________________________________________________
+bool Close() {
+  bool out = true;
+#ifdef MU__WITH_ARROW
+  for (auto& entry : _tables)
+    out = _close_writer(entry.second) && out;
+  _tables.clear();
+#endif
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Close Current Output Segment for Current Thread_____________________________________________
+bool Rotate(const std::string& segment_base) {
+  bool out = true;
+#ifdef MU__WITH_ARROW
+  for (auto& entry : _tables) {
+    auto& table = entry.second;
+    out = _close_writer(table) && out;
+    if (util::io::path_exists(table.path))
+      out = util::io::rename_file(table.path, TablePath(segment_base, entry.first)) && out;
+  }
+#else
+  static_cast<void>(segment_base);
+#endif
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Columnar Table Initializer__________________________________________________________________
+bool CreateTable(const std::string& name,
+                 const ROOT::DataKeyList& columns,
+                 const ROOT::DataKeyTypeList& types,
+                 const std::vector<bool>& selected) {
+#ifdef MU__WITH_ARROW
+  if (_format == Format::ROOT || columns.size() != types.size() || columns.size() != selected.size())
+    return false;
+
+  _table table{};
+  table.path = TablePath(_base, name);
+  table.types = types;
+  table.dictionary.reserve(columns.size());
+  table.builders.reserve(columns.size());
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  fields.reserve(columns.size());
+  for (std::size_t i{}; i < columns.size(); ++i) {
+    if (!selected[i]) {
+      table.builders.push_back(nullptr);
+      table.dictionary.push_back(false);
+      continue;
+    }
+    const auto dictionary = types[i] == ROOT::DataKeyType::IntegerVector && columns[i] == _dictionary_column;
+    const auto type = _arrow_type(types[i], dictionary);
+    auto builder = arrow::MakeBuilderExactIndex(type);
+    if (!builder.ok())
+      return false;
+    fields.push_back(arrow::field(columns[i], type));
+    table.builders.push_back(std::move(builder).ValueUnsafe());
+    table.dictionary.push_back(dictionary);
+  }
+  table.schema = arrow::schema(fields);
+  return _tables.insert({name, std::move(table)}).second;
+#else
+  static_cast<void>(name);
+  static_cast<void>(columns);
+  static_cast<void>(types);
+  static_cast<void>(selected);
+  return false;
+#endif
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attach Simulation Settings to Columnar File Metadata________________________________________
+void SetMetadata(const SimSettingList& entries) {
+  _metadata.insert(_metadata.end(), entries.cbegin(), entries.cend());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Row to Columnar Table___________________________________________________________________
+bool AppendRow(const std::string& name,
+               const std::vector<std::size_t>& index,
+               const ROOT::DataEntry& single_values,
+               const ROOT::DataEntryList& real,
+               const ROOT::FloatDataEntryList& real_float,
+               const ROOT::IntegerDataEntryList& integer) {
+#ifdef MU__WITH_ARROW
+  const auto search = _tables.find(name);
+  if (search == _tables.end())
+    return false;
+
+  auto& table = search->second;
+  const auto size = table.types.size();
+  const auto single_size = single_values.size();
+  for (std::size_t i{}, single_index{}; i < size; ++i) {
+    const auto builder = table.builders[i].get();
+    const auto vector_index = index[i];
+    if (!builder) {
+      if (table.types[i] == ROOT::DataKeyType::Single
+          || table.types[i] == ROOT::DataKeyType::Float
+          || table.types[i] == ROOT::DataKeyType::Integer)
+        ++single_index;
+      continue;
+    }
+    arrow::Status status;
+    switch (table.types[i]) {
+      case ROOT::DataKeyType::Single:
+        status = single_index < single_size
+               ? static_cast<arrow::DoubleBuilder*>(builder)->Append(single_values[single_index++])
+               : builder->AppendNull();
+        break;
+      case ROOT::DataKeyType::Float:
+        status = single_index < single_size
+               ? static_cast<arrow::FloatBuilder*>(builder)->Append(static_cast<float>(single_values[single_index++]))
+               : builder->AppendNull();
+        break;
+      case ROOT::DataKeyType::Integer:
+        status = single_index < single_size
+               ? static_cast<arrow::Int32Builder*>(builder)->Append(static_cast<int>(single_values[single_index++]))
+               : builder->AppendNull();
+        break;
+      case ROOT::DataKeyType::Vector:
+        status = _append_list<arrow::DoubleBuilder>(builder, real[vector_index]);
+        break;
+      case ROOT::DataKeyType::FloatVector:
+        status = _append_list<arrow::FloatBuilder>(builder, real_float[vector_index]);
+        break;
+      case ROOT::DataKeyType::IntegerVector:
+        status = table.dictionary[i] ? _append_dictionary_list(builder, integer[vector_index])
+                                     : _append_list<arrow::Int32Builder>(builder, integer[vector_index]);
+        break;
+    }
+    if (!status.ok())
+      return false;
+  }
+
+  return ++table.rows < _row_group_size || _flush(table);
+#else
+  static_cast<void>(name);
+  static_cast<void>(index);
+  static_cast<void>(single_values);
+  static_cast<void>(real);
+  static_cast<void>(real_float);
+  static_cast<void>(integer);
+  return false;
+#endif
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Columnar */ /////////////////////////////////////////////////////////////////////
+
+} /* namespace Analysis */ /////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
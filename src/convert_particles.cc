@@ -0,0 +1,38 @@
+/* src/convert_particles.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/FileReaderGenerator.hh"
+
+#include <string>
+#include <exception>
+#include <iostream>
+
+int main(const int argc, const char *const argv[]) {
+  if (argc != 3) {
+    std::cout << "Usage: " << argv[0] << " <text particle file> <binary particle file>" << std::endl;
+    return 1;
+  }
+  try {
+    const auto records = MATHUSLA::MU::Physics::ReadParticleTextFile(argv[1]);
+    MATHUSLA::MU::Physics::WriteParticleBinaryFile(argv[2], records);
+    std::cout << "Wrote " << records.size() << " particles to " << argv[2] << std::endl;
+  } catch (const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -4,48 +4,76 @@
 #include "Geant4/G4Trap.hh"
 #include "Geant4/G4Box.hh"
 
+#include "geometry/Cavern.hh"
 #include "geometry/Construction.hh"
+#include "geometry/Prototype.hh"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <string>
-#include <cctype>
-#include <iostream>
-
-bool is_scintillator_name(const std::string &name) {
-  if (
-       name.size() == 5
-    && name[0] == 'S'
-    && (name[1] == 'A' || name[1] == 'B')
-    && std::isdigit(name[2])
-    && name[3] == '-'
-    && std::isdigit(name[4])
-  ) {
-    return true;
-  } else {
-    return false;
+#include <unordered_map>
+#include <vector>
+
+using MATHUSLA::MU::Prototype::SensitiveVolume;
+
+// Binary geometry table: the 8-byte GeometryMagic, a std::uint64_t record count, and then the
+// records. Rotations map local to global coordinates and are stored row-major, lengths are in mm.
+constexpr char GeometryMagic[8] = {'M', 'U', 'G', 'E', 'O', 'M', '0', '1'};
+
+struct GeometryRecord {
+  std::int32_t id;
+  std::int32_t kind;
+  double rotation[9];
+  double translation[3];
+  double dimensions[7];
+};
+
+enum GeometryKind : std::int32_t { ScintillatorKind = 0, StripKind = 1 };
+
+std::size_t volume_dimensions(const SensitiveVolume &entry, double *out) {
+  const auto *solid = entry.volume->GetLogicalVolume()->GetSolid();
+  if (entry.scintillator != nullptr) {
+    const auto *trap = dynamic_cast<const G4Trap *>(solid);
+    if (trap == nullptr) {
+      return 0;
+    }
+    out[0] = 2.0 * trap->GetXHalfLength1();
+    out[1] = 2.0 * trap->GetXHalfLength2();
+    out[2] = 2.0 * trap->GetXHalfLength3();
+    out[3] = 2.0 * trap->GetXHalfLength4();
+    out[4] = 2.0 * trap->GetYHalfLength1();
+    out[5] = 2.0 * trap->GetYHalfLength2();
+    out[6] = 2.0 * trap->GetZHalfLength();
+    return 7;
+  }
+  const auto *box = dynamic_cast<const G4Box *>(solid);
+  if (box == nullptr) {
+    return 0;
   }
+  out[0] = 2.0 * box->GetXHalfLength();
+  out[1] = 2.0 * box->GetYHalfLength();
+  out[2] = 2.0 * box->GetZHalfLength();
+  return 3;
 }
 
-bool is_strip_name(const std::string &name) {
-  if (
-       name.size() == 5
-    && std::isdigit(name[0])
-    && std::isdigit(name[1])
-    && std::isdigit(name[2])
-    && std::isdigit(name[3])
-    && std::isdigit(name[4])
-  ) {
-    return true;
-  } else {
-    return false;
+void print_volume(const std::string &name, const G4ThreeVector &translation, const G4RotationMatrix &rotation,
+                  const double *dimensions, const std::size_t dimension_count) {
+  std::printf("%s,%.2f,%.2f,%.2f,%.5f,%.5f,%.5f,%.5f,%.5f,%.5f",
+              name.c_str(), translation.x(), translation.y(), translation.z(),
+              rotation.thetaX(), rotation.phiX(), rotation.thetaY(), rotation.phiY(), rotation.thetaZ(), rotation.phiZ());
+  for (std::size_t i = 0; i < dimension_count; i++) {
+    std::printf(",%.5f", dimensions[i]);
   }
+  std::printf("\n");
 }
 
-void dump_volume(const G4VPhysicalVolume &physical_volume, const G4ThreeVector &parent_translation, const G4RotationMatrix &parent_rotation, const bool dump_everything = false) {
+void dump_volume(const G4VPhysicalVolume &physical_volume, const G4ThreeVector &parent_translation, const G4RotationMatrix &parent_rotation,
+                 const std::unordered_map<const G4VPhysicalVolume *, const SensitiveVolume *> &sensitive) {
   const auto &logical_volume = *(physical_volume.GetLogicalVolume());
   const auto n_daughters = logical_volume.GetNoDaughters();
 
-  const auto name = logical_volume.GetName();
-
   const auto translation = parent_translation + parent_rotation * physical_volume.GetTranslation();
 
   auto rotation = parent_rotation;
@@ -54,65 +82,115 @@ void dump_volume(const G4VPhysicalVolume &physical_volume, const G4ThreeVector &
     rotation = rotation * relative_rotation_ptr->inverse();
   }
 
-  if (dump_everything || (n_daughters == 0 && (is_scintillator_name(name) || is_strip_name(name)))) {
-    std::cout << name;
-    std::cout.setf(std::ios::fixed);
-    std::cout.precision(2);
-    std::cout << "," << translation.x() << "," << translation.y() << "," << translation.z();
-    std::cout.precision(5);
-    std::cout << "," << rotation.thetaX() << "," << rotation.phiX();
-    std::cout << "," << rotation.thetaY() << "," << rotation.phiY();
-    std::cout << "," << rotation.thetaZ() << "," << rotation.phiZ();
-    if (n_daughters == 0 && is_scintillator_name(name)) {
-      const auto &trap = *static_cast<const G4Trap *>(logical_volume.GetSolid());
-      std::cout << "," << 2.0 * trap.GetXHalfLength1();
-      std::cout << "," << 2.0 * trap.GetXHalfLength2();
-      std::cout << "," << 2.0 * trap.GetXHalfLength3();
-      std::cout << "," << 2.0 * trap.GetXHalfLength4();
-      std::cout << "," << 2.0 * trap.GetYHalfLength1();
-      std::cout << "," << 2.0 * trap.GetYHalfLength2();
-      std::cout << "," << 2.0 * trap.GetZHalfLength();
-    } else if (is_strip_name(name)) {
-      const auto &box = *static_cast<const G4Box *>(logical_volume.GetSolid());
-      std::cout << "," << 2.0 * box.GetXHalfLength();
-      std::cout << "," << 2.0 * box.GetYHalfLength();
-      std::cout << "," << 2.0 * box.GetZHalfLength();
-    }
-    std::cout << std::endl;
-  }
+  double dimensions[7] = {};
+  const auto search = sensitive.find(&physical_volume);
+  const auto dimension_count = search != sensitive.end() ? volume_dimensions(*search->second, dimensions) : 0;
+  print_volume(logical_volume.GetName(), translation, rotation, dimensions, dimension_count);
+
   for (G4int daughter_index = 0; daughter_index < n_daughters; daughter_index++) {
     const auto &daughter_volume = *(logical_volume.GetDaughter(daughter_index));
-    dump_volume(daughter_volume, translation, rotation, dump_everything);
+    dump_volume(daughter_volume, translation, rotation, sensitive);
+  }
+}
+
+void dump_world(const G4VPhysicalVolume &physical_volume, const std::vector<SensitiveVolume> &volumes) {
+  std::unordered_map<const G4VPhysicalVolume *, const SensitiveVolume *> sensitive;
+  for (const auto &entry : volumes) {
+    if (entry.id >= 0) {
+      sensitive[entry.volume] = &entry;
+    }
+  }
+  dump_volume(physical_volume, G4ThreeVector(0.0, 0.0, 0.0), G4RotationMatrix(0.0, 0.0, 0.0), sensitive);
+}
+
+void dump_sensitive(const std::vector<SensitiveVolume> &volumes) {
+  for (const auto &entry : volumes) {
+    if (entry.id < 0) {
+      continue;
+    }
+    double dimensions[7] = {};
+    const auto dimension_count = volume_dimensions(entry, dimensions);
+    print_volume(entry.name, entry.global.getTranslation(), entry.global.getRotation(), dimensions, dimension_count);
   }
 }
 
-void dump_world(const G4VPhysicalVolume &physical_volume, const bool dump_everything = false) {
-  dump_volume(physical_volume, G4ThreeVector(0.0, 0.0, 0.0), G4RotationMatrix(0.0, 0.0, 0.0), dump_everything);
+bool write_binary(const std::string &pathname, const std::vector<SensitiveVolume> &volumes) {
+  std::vector<GeometryRecord> records;
+  records.reserve(volumes.size());
+  for (const auto &entry : volumes) {
+    if (entry.id < 0) {
+      continue;
+    }
+    records.emplace_back();
+    auto &record = records.back();
+    record.id = entry.id;
+    record.kind = entry.scintillator != nullptr ? ScintillatorKind : StripKind;
+    for (int row = 0; row < 3; row++) {
+      for (int column = 0; column < 3; column++) {
+        record.rotation[3 * row + column] = entry.global(row, column);
+      }
+      record.translation[row] = entry.global(row, 3);
+    }
+    std::fill(std::begin(record.dimensions), std::end(record.dimensions), 0.0);
+    volume_dimensions(entry, record.dimensions);
+  }
+
+  std::ofstream output_stream(pathname, std::ios::binary | std::ios::trunc);
+  const std::uint64_t count = records.size();
+  output_stream.write(GeometryMagic, sizeof(GeometryMagic));
+  output_stream.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  output_stream.write(reinterpret_cast<const char *>(records.data()),
+                      static_cast<std::streamsize>(records.size() * sizeof(GeometryRecord)));
+  return static_cast<bool>(output_stream);
 }
 
 int main(const int argc, const char *const argv[]) {
   bool dump_everything = false;
+  std::string binary_path;
   if (argc == 2 && std::string(argv[1]) == "all") {
     dump_everything = true;
+  } else if (argc == 3 && std::string(argv[1]) == "--binary") {
+    binary_path = argv[2];
   } else if (argc != 1) {
-    std::cout << "Usage: " << argv[0] << " [all]" << std::endl;
+    std::printf("Usage: %s [all | --binary <file>]\n", argv[0]);
     return 1;
   }
   MATHUSLA::MU::Construction::Builder test_stand_builder("Prototype", "test-stand-geometry-dump", true);
   const auto &world = *(test_stand_builder.Construct());
-  std::cout << "# Format by column:" << std::endl << std::endl;
-  std::cout << "# Volume name" << std::endl;
-  std::cout << "# Global x-coordinate of center of volume (mm)" << std::endl;
-  std::cout << "# Global y-coordinate of center of volume (mm)" << std::endl;
-  std::cout << "# Global z-coordinate of center of volume (mm)" << std::endl;
-  std::cout << "# Global zenith angle of local x-axis of volume (rad)" << std::endl;
-  std::cout << "# Global azimuthal angle of local x-axis of volume (rad)" << std::endl;
-  std::cout << "# Global zenith angle of local y-axis of volume (rad)" << std::endl;
-  std::cout << "# Global azimuthal angle of local y-axis of volume (rad)" << std::endl;
-  std::cout << "# Global zenith angle of local z-axis of volume (rad)" << std::endl;
-  std::cout << "# Global azimuthal angle of local z-axis of volume (rad)" << std::endl;
-  std::cout << "# (Additional detector-specific fields for dimensions of scintillators and strips) " << std::endl;
-  std::cout << std::endl;
-  dump_world(world, dump_everything);
+  const auto &volumes = MATHUSLA::MU::Prototype::Detector::SensitiveVolumes();
+
+  if (!binary_path.empty()) {
+    if (!write_binary(binary_path, volumes)) {
+      std::fprintf(stderr, "Unable to write geometry table: %s\n", binary_path.c_str());
+      return 1;
+    }
+    return 0;
+  }
+
+  std::printf("# Format by column:\n\n");
+  std::printf("# Volume name\n");
+  std::printf("# Global x-coordinate of center of volume (mm)\n");
+  std::printf("# Global y-coordinate of center of volume (mm)\n");
+  std::printf("# Global z-coordinate of center of volume (mm)\n");
+  std::printf("# Global zenith angle of local x-axis of volume (rad)\n");
+  std::printf("# Global azimuthal angle of local x-axis of volume (rad)\n");
+  std::printf("# Global zenith angle of local y-axis of volume (rad)\n");
+  std::printf("# Global azimuthal angle of local y-axis of volume (rad)\n");
+  std::printf("# Global zenith angle of local z-axis of volume (rad)\n");
+  std::printf("# Global azimuthal angle of local z-axis of volume (rad)\n");
+  std::printf("# (Additional detector-specific fields for dimensions of scintillators and strips) \n");
+  std::printf("\n");
+  const auto &transform = MATHUSLA::MU::Cavern::CollisionTransform();
+  std::printf("# Collision frame to global frame (rotation row, translation in mm):\n");
+  for (int row = 0; row < 3; row++) {
+    std::printf("# %.5f,%.5f,%.5f,%.5f\n", transform.rotation[row][0], transform.rotation[row][1],
+                transform.rotation[row][2], transform.translation[row]);
+  }
+  std::printf("\n");
+  if (dump_everything) {
+    dump_world(world, volumes);
+  } else {
+    dump_sensitive(volumes);
+  }
   return 0;
 }
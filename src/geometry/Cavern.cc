@@ -31,6 +31,28 @@ namespace { ////////////////////////////////////////////////////////////////////
 static auto _base_depth = Cavern::DefaultBaseDepth;
 //----------------------------------------------------------------------------------------------
 
+//__Cavern Rotation Coefficients________________________________________________________________
+const long double _cos_P1_tilt = std::cos(Cavern::P1ForwardTilt / rad);
+const long double _sin_P1_tilt = std::sin(Cavern::P1ForwardTilt / rad);
+//----------------------------------------------------------------------------------------------
+
+//__Build Collision Frame Transform_____________________________________________________________
+Cavern::Transform _make_collision_transform() {
+  // collision frame (x, y, z) is rotated from P1 as (z, y, -x) and placed at the IP, whose world
+  // depth Earth::TotalShift() + Cavern::IP() reduces to the unshifted base depth of the cavern
+  const auto cosine = static_cast<double>(_cos_P1_tilt);
+  const auto sine = static_cast<double>(_sin_P1_tilt);
+  return {{{-sine,   0,  cosine},
+           {    0,   1,       0},
+           {-cosine, 0,   -sine}},
+          {0, 0, static_cast<double>(_base_depth - Cavern::DetectorHeight)}};
+}
+//----------------------------------------------------------------------------------------------
+
+//__Collision Frame Transform___________________________________________________________________
+auto _collision_transform = _make_collision_transform();
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 namespace Cavern { /////////////////////////////////////////////////////////////////////////////
@@ -51,6 +73,7 @@ long double BaseDepth() {
 }
 long double BaseDepth(long double value) {
   _base_depth = value;
+  _collision_transform = _make_collision_transform();
   return BaseDepth();
 }
 long double TopDepth() {
@@ -66,10 +89,10 @@ long double IP() {
 
 //__Cavern Rotations____________________________________________________________________________
 long double cosP1Tilt() {
-  return std::cos(P1ForwardTilt / rad);
+  return _cos_P1_tilt;
 }
 long double sinP1Tilt() {
-  return std::sin(P1ForwardTilt / rad);
+  return _sin_P1_tilt;
 }
 long double rotate_from_P1_x(long double x, long double z) {
   return x * cosP1Tilt() + z * sinP1Tilt();
@@ -95,6 +118,28 @@ std::pair<long double, long double> rotate_to_P1(long double x, long double z) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Apply Transform to Coordinate Arrays________________________________________________________
+void Transform::apply(std::size_t count,
+                      double* x,
+                      double* y,
+                      double* z) const {
+  const auto& r = rotation;
+  const auto& d = translation;
+  for (std::size_t i{}; i < count; ++i) {
+    const auto xi = x[i], yi = y[i], zi = z[i];
+    x[i] = r[0][0] * xi + r[0][1] * yi + r[0][2] * zi + d[0];
+    y[i] = r[1][0] * xi + r[1][1] * yi + r[1][2] * zi + d[1];
+    z[i] = r[2][0] * xi + r[2][1] * yi + r[2][2] * zi + d[2];
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Transform from Collision Frame at IP to World Frame_________________________________________
+const Transform& CollisionTransform() {
+  return _collision_transform;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Cavern Logical Volumes______________________________________________________________________
 G4LogicalVolume* Volume() {
   auto box = Construction::Box("CavernBox", CavernLength, CavernWidth, CavernHeight - VaultRadius);
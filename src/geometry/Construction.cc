@@ -17,25 +17,44 @@
 
 #include "geometry/Construction.hh"
 
+#include <algorithm>
+#include <cfloat>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
 #include <Geant4/G4SubtractionSolid.hh>
+#include <Geant4/G4AutoLock.hh>
 #include <Geant4/G4GeometryManager.hh>
 #include <Geant4/G4GeometryTolerance.hh>
 #include <Geant4/G4LogicalVolumeStore.hh>
 #include <Geant4/G4PhysicalVolumeStore.hh>
+#include <Geant4/G4ProductionCuts.hh>
+#include <Geant4/G4Region.hh>
+#include <Geant4/G4RegionStore.hh>
 #include <Geant4/G4SDManager.hh>
 #include <Geant4/G4Colour.hh>
 #include <Geant4/G4SolidStore.hh>
 #include <Geant4/G4PVPlacement.hh>
 #include <Geant4/G4NistManager.hh>
 #include <Geant4/G4GDMLParser.hh>
+#include <Geant4/G4Threading.hh>
+#include <Geant4/G4VVisManager.hh>
 #include <Geant4/tls.hh>
 
 #include "geometry/Box.hh"
+#include "geometry/Earth.hh"
 #include "geometry/Prototype.hh"
 #include "geometry/Flat.hh"
 #include "geometry/MuonMapper.hh"
 
+#include "physics/MuonTransport.hh"
+
+#include "perf.hh"
+
 #include "util/io.hh"
+#include "util/string.hh"
 
 namespace MATHUSLA { namespace MU {
 
@@ -45,6 +64,10 @@ namespace { ////////////////////////////////////////////////////////////////////
 const auto _nist = G4NistManager::Instance();
 //----------------------------------------------------------------------------------------------
 
+//__Material Interning Mutex____________________________________________________________________
+G4Mutex _material_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
 //__Detector Details for Builder________________________________________________________________
 std::string _detector;
 std::string _export_dir;
@@ -53,16 +76,222 @@ std::string _data_name;
 const Analysis::ROOT::DataKeyList* _data_keys;
 const Analysis::ROOT::DataKeyTypeList* _data_key_types;
 bool _save_option;
+bool _material_dump = true;
+bool _quiet = false;
+G4VisExtent _detector_extent;
+//----------------------------------------------------------------------------------------------
+
+//__Region Production Cuts______________________________________________________________________
+std::unordered_map<std::string, double> _region_cuts{
+  {"Sandstone", 10*cm},
+  {"Marl",      10*cm},
+  {"Mix",       10*cm},
+  {"Cavern",     1*cm}};
+const std::vector<std::string> _rock_regions{"Sandstone", "Marl", "Mix"};
+//----------------------------------------------------------------------------------------------
+
+//__Region of Logical Volume____________________________________________________________________
+const std::string _region_name(const G4LogicalVolume* volume) {
+  const auto& material = volume->GetMaterial()->GetName();
+  if (material == "Quartz")
+    return "Sandstone";
+  if (material == "Marl" || material == "Mix")
+    return material;
+  if (volume->GetName() == "DetectorRing")
+    return "Cavern";
+  return "";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Update Region Production Cuts_______________________________________________________________
+void _update_region_cuts() {
+  for (const auto& entry : _region_cuts) {
+    auto region = G4RegionStore::GetInstance()->GetRegion(entry.first, false);
+    if (!region)
+      region = new G4Region(entry.first);
+    auto cuts = region->GetProductionCuts();
+    if (!cuts) {
+      cuts = new G4ProductionCuts;
+      region->SetProductionCuts(cuts);
+    }
+    cuts->SetProductionCut(entry.second);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Assign Earth and Cavern Volumes to Regions__________________________________________________
+void _assign_regions() {
+  _update_region_cuts();
+  const auto store = G4RegionStore::GetInstance();
+  for (auto volume : *G4LogicalVolumeStore::GetInstance()) {
+    const auto name = _region_name(volume);
+    if (!name.empty())
+      store->GetRegion(name, false)->AddRootLogicalVolume(volume);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Geometry Cache Variables____________________________________________________________________
+std::string _cache_dir;
+bool _cache_loaded = false;
+G4VPhysicalVolume* _world = nullptr;
+std::vector<G4LogicalVolume*> _cache_sensitive;
+//----------------------------------------------------------------------------------------------
+
+//__Layered Solid Construction Variables________________________________________________________
+bool _layered_solids = false;
+std::unordered_map<std::string, bool> _layered_detectors;
+//----------------------------------------------------------------------------------------------
+
+//__Geometry Cache Version______________________________________________________________________
+// Detector dimensions are compile-time constants, so bump this whenever they change.
+constexpr auto _cache_version = 3;
+//----------------------------------------------------------------------------------------------
+
+//__Sensitive Volume GDML Auxiliary Tag_________________________________________________________
+const std::string _sensitive_tag = "SensDet";
+//----------------------------------------------------------------------------------------------
+
+//__Clean Geometry Stores_______________________________________________________________________
+void _clean_geometry() {
+  G4GeometryManager::GetInstance()->OpenGeometry();
+  G4PhysicalVolumeStore::GetInstance()->Clean();
+  G4LogicalVolumeStore::GetInstance()->Clean();
+  G4SolidStore::GetInstance()->Clean();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Geometry Cache Path for Current Parameters__________________________________________________
+const std::string _cache_path() {
+  std::stringstream parameters;
+  parameters << std::setprecision(17);
+  parameters << _cache_version << ' ' << _detector << ' ' << Construction::WorldLength
+             << ' ' << _layered_solids;
+  for (const auto value : {Earth::LastShift(),
+                           Earth::LayerWidthX(),
+                           Earth::LayerWidthY(),
+                           Earth::BufferZoneLength(),
+                           Earth::BufferZoneHigherWidth(),
+                           Earth::BufferZoneLowerWidth(),
+                           Earth::BufferZoneHigherDepth(),
+                           Earth::BufferZoneLowerDepth(),
+                           Earth::SandstoneDepth(),
+                           Earth::MarlDepth(),
+                           Earth::MixDepth()})
+    parameters << ' ' << value;
+  std::stringstream path;
+  path << _cache_dir << '/' << _detector << ".v" << _cache_version << '.'
+       << std::hex << std::setw(16) << std::setfill('0')
+       << util::string::fnv1a(parameters.str()) << ".gdml";
+  return path.str();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load World from Geometry Cache______________________________________________________________
+G4VPhysicalVolume* _load_cache(const std::string& path) {
+  _cache_sensitive.clear();
+  if (!util::io::path_exists(path))
+    return nullptr;
+
+  G4GDMLParser parser;
+  parser.Read(path, false);
+  const auto world = parser.GetWorldVolume();
+  if (world) {
+    for (auto volume : *G4LogicalVolumeStore::GetInstance()) {
+      for (const auto& aux : parser.GetVolumeAuxiliaryInformation(volume)) {
+        if (aux.type == _sensitive_tag) {
+          _cache_sensitive.push_back(volume);
+          break;
+        }
+      }
+    }
+  }
+
+  if (!world || _cache_sensitive.empty() || !world->GetLogicalVolume()->GetNoDaughters()) {
+    std::cout << "Invalid Geometry Cache: " << path << "\n";
+    _cache_sensitive.clear();
+    _clean_geometry();
+    return nullptr;
+  }
+  return world;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Save World with Sensitive Volumes to Geometry Cache_________________________________________
+void _save_cache(const std::string& path) {
+  util::io::create_directory(_cache_dir);
+
+  G4GDMLParser parser;
+  for (auto volume : *G4LogicalVolumeStore::GetInstance()) {
+    const auto detector = volume->GetSensitiveDetector();
+    if (detector)
+      parser.AddVolumeAuxiliaryInfo({_sensitive_tag, detector->GetName(), "", nullptr}, volume);
+  }
+
+  const auto temp_path = path.substr(0, path.size() - 5UL) + ".part.gdml";
+  if (util::io::path_exists(temp_path))
+    util::io::remove_file(temp_path);
+  parser.Write(temp_path, _world, true, G4GDML_DEFAULT_SCHEMALOCATION);
+  if (util::io::rename_file(temp_path, path) && !_quiet)
+    std::cout << "Saved Geometry Cache: " << path << "\n";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Compute World Bounding Box of Placed Volume_________________________________________________
+const G4VisExtent _world_extent(const G4VPhysicalVolume* volume) {
+  if (!volume)
+    return G4VisExtent();
+  const auto extent = volume->GetLogicalVolume()->GetSolid()->GetExtent();
+  const auto rotation = volume->GetObjectRotationValue();
+  const auto translation = volume->GetObjectTranslation();
+  double x_min = DBL_MAX, x_max = -DBL_MAX,
+         y_min = DBL_MAX, y_max = -DBL_MAX,
+         z_min = DBL_MAX, z_max = -DBL_MAX;
+  for (const auto x : {extent.GetXmin(), extent.GetXmax()}) {
+    for (const auto y : {extent.GetYmin(), extent.GetYmax()}) {
+      for (const auto z : {extent.GetZmin(), extent.GetZmax()}) {
+        const auto corner = rotation * G4ThreeVector(x, y, z) + translation;
+        x_min = std::min(x_min, corner.x());
+        x_max = std::max(x_max, corner.x());
+        y_min = std::min(y_min, corner.y());
+        y_max = std::max(y_max, corner.y());
+        z_min = std::min(z_min, corner.z());
+        z_max = std::max(z_max, corner.z());
+      }
+    }
+  }
+  return G4VisExtent(x_min, x_max, y_min, y_max, z_min, z_max);
+}
 //----------------------------------------------------------------------------------------------
 
 //__Detector List_______________________________________________________________________________
 const std::string& _detectors = "Prototype Flat Box MuonMapper";
 //----------------------------------------------------------------------------------------------
 
+//__Muon Map Sweep Driver_______________________________________________________________________
+MuonMapper::Sweep* _sweep = nullptr;
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 namespace Construction { ///////////////////////////////////////////////////////////////////////
 
+//__Rock Region Names___________________________________________________________________________
+const std::vector<std::string>& RockRegions() {
+  return _rock_regions;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Layered Solid Construction Mode_____________________________________________________________
+bool LayeredSolids() {
+  return _layered_solids;
+}
+bool LayeredSolids(const bool value) {
+  _layered_solids = value;
+  return LayeredSolids();
+}
+//----------------------------------------------------------------------------------------------
+
 //__Construction Materials______________________________________________________________________
 G4Element* Material::H = _nist->FindOrBuildElement("H");
 G4Element* Material::C = _nist->FindOrBuildElement("C");
@@ -83,6 +312,15 @@ G4Material* Material::PolystyreneFoam = _nist->BuildMaterialWithNewDensity("Poly
 G4Material* Material::Polyvinyltoluene = _nist->FindOrBuildMaterial("G4_PLASTIC_SC_VINYLTOLUENE");
 //----------------------------------------------------------------------------------------------
 
+//__Find or Define Process-Wide Material________________________________________________________
+G4Material* Material::Intern(const std::string& name,
+                             const std::function<G4Material*(const std::string&)>& define) {
+  G4AutoLock lock(&_material_mutex);
+  const auto existing = G4Material::GetMaterial(name, false);
+  return existing ? existing : define(name);
+}
+//----------------------------------------------------------------------------------------------
+
 //__Detector Messenger Directory Path___________________________________________________________
 const std::string Builder::MessengerDirectory = "/det/";
 //----------------------------------------------------------------------------------------------
@@ -96,6 +334,9 @@ Builder::Builder(const std::string& detector,
   _export_dir = export_dir;
   _save_option = save_option;
 
+  if (!_sweep)
+    _sweep = new MuonMapper::Sweep;
+
   _select = CreateCommand<Command::StringArg>("select", "Select Detector.");
   _select->SetParameterName("detector", false);
   _select->SetDefaultValue("Prototype");
@@ -107,56 +348,121 @@ Builder::Builder(const std::string& detector,
 
   _current = CreateCommand<Command::NoArg>("current", "Current Detector.");
   _current->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _cache = CreateCommand<Command::StringArg>("cache", "Set Geometry Cache Directory.");
+  _cache->SetParameterName("dir", true);
+  _cache->SetDefaultValue("");
+  _cache->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _layered = CreateCommand<Command::BoolArg>("layered", "Build Current Detector without Boolean Solids.");
+  _layered->SetParameterName("layered", false);
+  _layered->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _sandstone_cut = CreateCommand<Command::DoubleUnitArg>("sandstone_cut", "Set Sandstone Production Cut.");
+  _sandstone_cut->SetParameterName("cut", false);
+  _sandstone_cut->SetUnitCategory("Length");
+  _sandstone_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _marl_cut = CreateCommand<Command::DoubleUnitArg>("marl_cut", "Set Marl Production Cut.");
+  _marl_cut->SetParameterName("cut", false);
+  _marl_cut->SetUnitCategory("Length");
+  _marl_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _mix_cut = CreateCommand<Command::DoubleUnitArg>("mix_cut", "Set Mix Production Cut.");
+  _mix_cut->SetParameterName("cut", false);
+  _mix_cut->SetUnitCategory("Length");
+  _mix_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _cavern_cut = CreateCommand<Command::DoubleUnitArg>("cavern_cut", "Set Cavern Production Cut.");
+  _cavern_cut->SetParameterName("cut", false);
+  _cavern_cut->SetUnitCategory("Length");
+  _cavern_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Build World and Detector Geometry___________________________________________________________
 G4VPhysicalVolume* Builder::Construct() {
-  G4GeometryManager::GetInstance()->OpenGeometry();
-  G4PhysicalVolumeStore::GetInstance()->Clean();
-  G4LogicalVolumeStore::GetInstance()->Clean();
-  G4SolidStore::GetInstance()->Clean();
+  Perf::MarkMemory();
+  _clean_geometry();
+  LayeredSolids(_layered_detectors[_detector]);
+  if (_detector == "Flat") {
+    Tracking::SetTriggerLayerFunction(Flat::Detector::DetectorLayer);
+  } else if (_detector == "Box") {
+    Tracking::SetTriggerLayerFunction(Box::Detector::DetectorLayer);
+  } else if (_detector == "MuonMapper") {
+    Tracking::SetTriggerLayerFunction(nullptr);
+  } else {
+    Tracking::SetTriggerLayerFunction(Prototype::Detector::DetectorLayer);
+  }
 
   G4GeometryManager::GetInstance()->SetWorldMaximumExtent(WorldLength);
 
-  std::cout << "Computed tolerance = "
-            << G4GeometryTolerance::GetInstance()->GetSurfaceTolerance() / m << " m\n";
+  if (!_quiet)
+    std::cout << "Computed tolerance = "
+              << G4GeometryTolerance::GetInstance()->GetSurfaceTolerance() / m << " m\n";
+
+  _cache_loaded = false;
+  if (!_cache_dir.empty() && _export_dir.empty()) {
+    const auto path = _cache_path();
+    if ((_world = _load_cache(path))) {
+      if (_detector == "Flat") {
+        Flat::Detector::Reset();
+      } else if (_detector == "Box") {
+        Box::Detector::Reset();
+      } else if (_detector == "MuonMapper") {
+        MuonMapper::Detector::Reset();
+      } else {
+        Prototype::Detector::Reset();
+        Prototype::Detector::IndexVolumes(_world, _cache_sensitive);
+      }
+      _detector_extent = _world_extent(_world->GetLogicalVolume()->GetDaughter(0));
+      Builder::SetSaveOption(_save_option);
+      _assign_regions();
+      _cache_loaded = true;
+      if (!_quiet)
+        std::cout << "Loaded Geometry Cache: " << path << "\n";
+      Perf::MeasureMemory(Perf::GeometryMemory);
+      return _world;
+    }
+  }
 
   auto worldLV = BoxVolume("World", WorldLength, WorldLength, WorldLength - 700*m);
 
+  G4VPhysicalVolume* detector = nullptr;
   if (!_export_dir.empty()) {
     if (_detector == "Flat") {
-      Export(Flat::Detector::Construct(worldLV), _export_dir, "flat.gdml");
+      Export(detector = Flat::Detector::Construct(worldLV), _export_dir, "flat.gdml");
       Export(Flat::Detector::ConstructEarth(worldLV), _export_dir, "flat.earth.gdml");
     } else if (_detector == "Box") {
-      Export(Box::Detector::Construct(worldLV), _export_dir, "box.gdml");
+      Export(detector = Box::Detector::Construct(worldLV), _export_dir, "box.gdml");
       Export(Box::Detector::ConstructEarth(worldLV), _export_dir, "box.earth.gdml");
     } else if (_detector == "MuonMapper") {
-      Export(MuonMapper::Detector::Construct(worldLV), _export_dir, "muon_mapper.gdml");
+      Export(detector = MuonMapper::Detector::Construct(worldLV), _export_dir, "muon_mapper.gdml");
       Export(MuonMapper::Detector::ConstructEarth(worldLV), _export_dir, "muon_mapper.earth.gdml");
     } else {
-      Export(Prototype::Detector::Construct(worldLV), _export_dir, "prototype.gdml");
+      Export(detector = Prototype::Detector::Construct(worldLV), _export_dir, "prototype.gdml");
       Export(Prototype::Detector::ConstructEarth(worldLV), _export_dir, "prototype.earth.gdml");
     }
   } else {
     if (_detector == "Flat") {
-      Flat::Detector::Construct(worldLV);
+      detector = Flat::Detector::Construct(worldLV);
       Flat::Detector::ConstructEarth(worldLV);
     } else if (_detector == "Box") {
-      Box::Detector::Construct(worldLV);
+      detector = Box::Detector::Construct(worldLV);
       Box::Detector::ConstructEarth(worldLV);
     } else if (_detector == "MuonMapper") {
-      MuonMapper::Detector::Construct(worldLV);
+      detector = MuonMapper::Detector::Construct(worldLV);
       MuonMapper::Detector::ConstructEarth(worldLV);
     } else {
-      Prototype::Detector::Construct(worldLV);
+      detector = Prototype::Detector::Construct(worldLV);
       Prototype::Detector::ConstructEarth(worldLV);
     }
   }
+  _detector_extent = _world_extent(detector);
 
   Builder::SetSaveOption(_save_option);
 
-  auto world = PlaceVolume(worldLV, nullptr);
+  auto world = _world = PlaceVolume(worldLV, nullptr);
   if (!_export_dir.empty()) {
     if (_detector == "Flat") {
       Export(world, _export_dir, "world.flat.gdml");
@@ -169,40 +475,59 @@ G4VPhysicalVolume* Builder::Construct() {
     }
   }
 
-  std::cout << "Materials: "
-            << *G4Material::GetMaterialTable() << '\n';
+  _assign_regions();
+
+  if (_material_dump)
+    std::cout << "Materials: "
+              << *G4Material::GetMaterialTable() << '\n';
 
+  Perf::MeasureMemory(Perf::GeometryMemory);
   return world;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Build Detector______________________________________________________________________________
 void Builder::ConstructSDandField() {
+  Perf::MarkMemory();
+  G4VSensitiveDetector* detector = nullptr;
   if (_detector == "Flat") {
     _data_per_event = Flat::Detector::DataPerEvent;
     _data_name = Flat::Detector::DataName;
     _data_keys = &Flat::Detector::DataKeys;
     _data_key_types = &Flat::Detector::DataKeyTypes;
-    G4SDManager::GetSDMpointer()->AddNewDetector(new Flat::Detector);
+    detector = new Flat::Detector;
   } else if (_detector == "Box") {
     _data_per_event = Box::Detector::DataPerEvent;
     _data_name = Box::Detector::DataName;
     _data_keys = &Box::Detector::DataKeys;
     _data_key_types = &Box::Detector::DataKeyTypes;
-    G4SDManager::GetSDMpointer()->AddNewDetector(new Box::Detector);
+    detector = new Box::Detector;
   } else if (_detector == "MuonMapper") {
     _data_per_event = MuonMapper::Detector::DataPerEvent;
     _data_name = MuonMapper::Detector::DataName;
     _data_keys = &MuonMapper::Detector::DataKeys;
     _data_key_types = &MuonMapper::Detector::DataKeyTypes;
-    G4SDManager::GetSDMpointer()->AddNewDetector(new MuonMapper::Detector);
+    detector = new MuonMapper::Detector;
   } else {
     _data_per_event = Prototype::Detector::DataPerEvent;
     _data_name = Prototype::Detector::DataName;
     _data_keys = &Prototype::Detector::DataKeys;
     _data_key_types = &Prototype::Detector::DataKeyTypes;
-    G4SDManager::GetSDMpointer()->AddNewDetector(new Prototype::Detector);
+    detector = new Prototype::Detector;
   }
+  G4SDManager::GetSDMpointer()->AddNewDetector(detector);
+
+  if (_cache_loaded) {
+    for (auto volume : _cache_sensitive)
+      volume->SetSensitiveDetector(detector);
+  } else if (!_cache_dir.empty() && !G4Threading::IsWorkerThread()) {
+    _save_cache(_cache_path());
+  }
+
+  Physics::MuonTransportModel::Attach(RockRegions());
+
+  // the master adds its detectors to the shared geometry, workers only own theirs
+  Perf::MeasureMemory(Perf::GeometryMemory, !G4Threading::IsWorkerThread());
 }
 //----------------------------------------------------------------------------------------------
 
@@ -211,9 +536,31 @@ void Builder::SetNewValue(G4UIcommand* command, G4String value) {
   if (command == _select && value != _detector.c_str()) {
     SetDetector(value);
   } else if (command == _list) {
-    std::cout << "Detectors: " << _detectors << "\n";
+    if (!_quiet)
+      std::cout << "Detectors: " << _detectors << "\n";
   } else if (command == _current) {
-    std::cout << "Current Detector: " << _detector << "\n";
+    if (!_quiet)
+      std::cout << "Current Detector: " << _detector << "\n";
+  } else if (command == _cache) {
+    SetCacheDirectory(value);
+  } else if (command == _sandstone_cut) {
+    _region_cuts["Sandstone"] = _sandstone_cut->GetNewDoubleValue(value);
+    _update_region_cuts();
+  } else if (command == _marl_cut) {
+    _region_cuts["Marl"] = _marl_cut->GetNewDoubleValue(value);
+    _update_region_cuts();
+  } else if (command == _mix_cut) {
+    _region_cuts["Mix"] = _mix_cut->GetNewDoubleValue(value);
+    _update_region_cuts();
+  } else if (command == _cavern_cut) {
+    _region_cuts["Cavern"] = _cavern_cut->GetNewDoubleValue(value);
+    _update_region_cuts();
+  } else if (command == _layered) {
+    const auto layered = _layered->GetNewBoolValue(value);
+    if (layered != _layered_detectors[_detector]) {
+      _layered_detectors[_detector] = layered;
+      Command::Execute("/run/reinitializeGeometry");
+    }
   }
 }
 //----------------------------------------------------------------------------------------------
@@ -223,8 +570,9 @@ void Builder::SetDetector(const std::string& detector) {
   _detector = detector;
   Command::Execute("/run/reinitializeGeometry",
                    "/run/geometryModified",
-                   "/run/initialize",
-                   "/vis/viewer/clearTransients");
+                   "/run/initialize");
+  if (G4VVisManager::GetConcreteInstance())
+    Command::Execute("/vis/viewer/clearTransients");
 }
 //----------------------------------------------------------------------------------------------
 
@@ -242,6 +590,24 @@ void Builder::SetSaveOption(bool option) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Set Geometry Cache Directory________________________________________________________________
+void Builder::SetCacheDirectory(const std::string& dir) {
+  _cache_dir = dir;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Material Table Printout_________________________________________________________________
+void Builder::SetMaterialDump(const bool option) {
+  _material_dump = option;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Quiet Mode______________________________________________________________________________
+void Builder::SetQuiet(const bool quiet) {
+  _quiet = quiet;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Get Current Detector Name___________________________________________________________________
 const std::string& Builder::GetDetectorName() {
   return _detector;
@@ -272,6 +638,12 @@ const Analysis::ROOT::DataKeyTypeList& Builder::GetDetectorDataKeyTypes() {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Get Current Detector World Bounding Box_____________________________________________________
+const G4VisExtent& Builder::GetDetectorExtent() {
+  return _detector_extent;
+}
+//----------------------------------------------------------------------------------------------
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 //__Sensitive Material Attribute Definition_____________________________________________________
@@ -382,6 +754,21 @@ G4LogicalVolume* OpenBoxVolume(const std::string& name,
                                const double thickness,
                                G4Material* material,
                                const G4VisAttributes& attr) {
+  if (LayeredSolids()) {
+    auto volume = BoxVolume(name, width, height, depth, Material::Air, BorderAttributes());
+    const auto inner_height = height - 2 * thickness;
+    const auto inner_depth  = depth  - 2 * thickness;
+    for (const auto side : {-1, 1}) {
+      PlaceVolume(Box(name + "_Z", width, height, thickness), material, attr, volume,
+        Transform(0, 0, side * 0.5 * (depth - thickness)));
+      PlaceVolume(Box(name + "_Y", width, thickness, inner_depth), material, attr, volume,
+        Transform(0, side * 0.5 * (height - thickness), 0));
+      PlaceVolume(Box(name + "_X", thickness, inner_height, inner_depth), material, attr, volume,
+        Transform(side * 0.5 * (width - thickness), 0, 0));
+    }
+    return volume;
+  }
+
   auto outer = Box(name,
     width,
     height,
@@ -57,28 +57,43 @@ G4Material* Material::Mix       = nullptr;
 
 //__Define Earth Materials______________________________________________________________________
 void Material::Define() {
-  Material::CaCO3 = new G4Material("CaCO3", 2.71*g/cm3, 3);
-  Material::CaCO3->AddElement(Construction::Material::Ca, 1);
-  Material::CaCO3->AddElement(Construction::Material::C,  1);
-  Material::CaCO3->AddElement(Construction::Material::O,  3);
-
-  Material::Kaolinite = new G4Material("Clay", 2.65*g/cm3, 4);
-  Material::Kaolinite->AddElement(Construction::Material::Al, 2);
-  Material::Kaolinite->AddElement(Construction::Material::Si, 2);
-  Material::Kaolinite->AddElement(Construction::Material::O,  9);
-  Material::Kaolinite->AddElement(Construction::Material::H,  4);
-
-  Material::SiO2 = new G4Material("Quartz", 2.445*g/cm3, 2);
-  Material::SiO2->AddElement(Construction::Material::Si, 1);
-  Material::SiO2->AddElement(Construction::Material::O, 2);
-
-  Material::Marl = new G4Material("Marl", 2.46*g/cm3, 2);
-  Material::Marl->AddMaterial(Material::Kaolinite, 35*perCent);
-  Material::Marl->AddMaterial(Material::CaCO3,     65*perCent);
-
-  Material::Mix = new G4Material("Mix", 2.54*g/cm3, 2);
-  Material::Mix->AddMaterial(Material::Marl, 50*perCent);
-  Material::Mix->AddMaterial(Material::SiO2, 50*perCent);
+  Material::CaCO3 = Construction::Material::Intern("CaCO3", [](const auto& name) {
+    auto out = new G4Material(name, 2.71*g/cm3, 3);
+    out->AddElement(Construction::Material::Ca, 1);
+    out->AddElement(Construction::Material::C,  1);
+    out->AddElement(Construction::Material::O,  3);
+    return out;
+  });
+
+  Material::Kaolinite = Construction::Material::Intern("Clay", [](const auto& name) {
+    auto out = new G4Material(name, 2.65*g/cm3, 4);
+    out->AddElement(Construction::Material::Al, 2);
+    out->AddElement(Construction::Material::Si, 2);
+    out->AddElement(Construction::Material::O,  9);
+    out->AddElement(Construction::Material::H,  4);
+    return out;
+  });
+
+  Material::SiO2 = Construction::Material::Intern("Quartz", [](const auto& name) {
+    auto out = new G4Material(name, 2.445*g/cm3, 2);
+    out->AddElement(Construction::Material::Si, 1);
+    out->AddElement(Construction::Material::O, 2);
+    return out;
+  });
+
+  Material::Marl = Construction::Material::Intern("Marl", [](const auto& name) {
+    auto out = new G4Material(name, 2.46*g/cm3, 2);
+    out->AddMaterial(Material::Kaolinite, 35*perCent);
+    out->AddMaterial(Material::CaCO3,     65*perCent);
+    return out;
+  });
+
+  Material::Mix = Construction::Material::Intern("Mix", [](const auto& name) {
+    auto out = new G4Material(name, 2.54*g/cm3, 2);
+    out->AddMaterial(Material::Marl, 50*perCent);
+    out->AddMaterial(Material::SiO2, 50*perCent);
+    return out;
+  });
 }
 //----------------------------------------------------------------------------------------------
 
@@ -1,12 +1,25 @@
 #include "geometry/MuonMapper.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <utility>
+
 #include <Geant4/G4NistManager.hh>
 #include <Geant4/G4VProcess.hh>
+#include <Geant4/G4Threading.hh>
 #include <Geant4/tls.hh>
 
+#include <TFile.h>
+#include <TTree.h>
+
 #include "action.hh"
 #include "analysis.hh"
 #include "geometry/Earth.hh"
+#include "perf.hh"
+
+#include "util/string.hh"
 
 namespace MATHUSLA { namespace MU {
 
@@ -14,7 +27,150 @@ namespace MuonMapper { /////////////////////////////////////////////////////////
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 //__MuonMapper Sensitive Material_______________________________________________________________
-G4LogicalVolume* _box;
+G4LogicalVolume* _box = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__MuonMapper Thread-Local Map_________________________________________________________________
+G4ThreadLocal Analysis::ROOT::Histogram2D* _map = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Sweep Settings______________________________________________________________________________
+std::vector<double> _sweep_energies{100};
+std::vector<double> _sweep_angles{45};
+bool _sweep_valid_energies = true;
+bool _sweep_valid_angles = true;
+std::size_t _sweep_events = 1000UL;
+std::size_t _sweep_max_events = 100000UL;
+double _sweep_target = 0.05;
+std::string _sweep_output = "mu_sweep.root";
+//----------------------------------------------------------------------------------------------
+
+//__Sweep Grid Point____________________________________________________________________________
+struct _sweep_point {
+  double energy, angle;
+  std::size_t events, stopped;
+  Analysis::ROOT::Histogram2D map;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Parse Sweep Value List______________________________________________________________________
+bool _parse_values(const std::string& name,
+                   const std::string& value,
+                   std::vector<double>& out) {
+  std::vector<std::string> tokens;
+  util::string::split(value, tokens, ", ");
+  out.clear();
+  for (const auto& token : tokens) {
+    if (token.empty())
+      continue;
+    double next{};
+    if (!util::string::to_double(token, next)) {
+      std::cerr << "[ERROR] Invalid Sweep " << name << " \"" << token << "\".\n";
+      out.clear();
+      return false;
+    }
+    out.push_back(next);
+  }
+  if (out.empty())
+    std::cerr << "[ERROR] Empty Sweep " << name << " List.\n";
+  return !out.empty();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Relative Statistical Error of Stopped Fraction______________________________________________
+double _relative_error(const _sweep_point& point) {
+  if (!point.events || !point.stopped)
+    return std::numeric_limits<double>::infinity();
+  const auto fraction = static_cast<double>(point.stopped) / point.events;
+  return std::sqrt((1.0 - fraction) / (point.events * fraction));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Events Needed to Reach Target Error_________________________________________________________
+std::size_t _events_needed(const _sweep_point& point) {
+  if (!point.events)
+    return _sweep_events;
+  const auto error = _relative_error(point);
+  if (error <= _sweep_target || point.events >= _sweep_max_events)
+    return 0UL;
+  const auto total = std::isfinite(error)
+    ? static_cast<std::size_t>(std::ceil(point.events * (error / _sweep_target) * (error / _sweep_target)))
+    : 2UL * point.events;
+  const auto extra = std::max(total, point.events + _sweep_events) - point.events;
+  return std::min(extra, _sweep_max_events - point.events);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Consolidated Sweep Map________________________________________________________________
+void _write_sweep(const std::vector<_sweep_point>& points) {
+  auto file = TFile::Open(_sweep_output.c_str(), "RECREATE");
+  if (!file || file->IsZombie()) {
+    std::cerr << "[ERROR] Unable to Open Sweep Output: " << _sweep_output << "\n";
+    delete file;
+    return;
+  }
+
+  double energy, angle, fraction, error;
+  Long64_t events, stopped;
+  TTree tree("mu_sweep", "mu_sweep");
+  tree.Branch("energy", &energy);
+  tree.Branch("angle", &angle);
+  tree.Branch("events", &events);
+  tree.Branch("stopped", &stopped);
+  tree.Branch("fraction", &fraction);
+  tree.Branch("error", &error);
+  for (std::size_t i{}; i < points.size(); ++i) {
+    const auto& point = points[i];
+    energy = point.energy;
+    angle = point.angle;
+    events = static_cast<Long64_t>(point.events);
+    stopped = static_cast<Long64_t>(point.stopped);
+    fraction = point.events ? static_cast<double>(point.stopped) / point.events : 0.0;
+    error = _relative_error(point);
+    tree.Fill();
+    Analysis::ROOT::WriteHistogram(file, point.map, Detector::MapName + "_" + std::to_string(i));
+  }
+  file->cd();
+  tree.Write();
+  Analysis::SimSettingList entries;
+  entries.emplace_back("FILETYPE", "MATHULSA MU-SIM MUON SWEEP");
+  entries.emplace_back("SWEEP_TARGET", std::to_string(_sweep_target));
+  entries.emplace_back("SWEEP_EVENTS", std::to_string(_sweep_events));
+  entries.emplace_back("SWEEP_MAX_EVENTS", std::to_string(_sweep_max_events));
+  Analysis::Save(file, entries);
+  file->Close();
+  delete file;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Column Density of Earth Layers along Straight Line__________________________________________
+// The Earth layers are horizontal slabs, so the path length in each layer follows from the
+// overlap of the segment with the layer in z. Returned in g/cm2.
+double _column_density(const G4ThreeVector& start,
+                       const G4ThreeVector& end) {
+  const auto dz = std::abs(end.z() - start.z());
+  if (dz <= 0.0)
+    return 0.0;
+  const auto length = (end - start).mag();
+  const auto low  = std::min(start.z(), end.z());
+  const auto high = std::max(start.z(), end.z());
+
+  const std::pair<double, G4Material*> layers[]{
+    {static_cast<double>(Earth::SandstoneDepth()), Earth::Material::SiO2},
+    {static_cast<double>(Earth::MarlDepth()),      Earth::Material::Marl},
+    {static_cast<double>(Earth::MixDepth()),       Earth::Material::Mix}};
+
+  double out{};
+  auto top = static_cast<double>(Earth::TotalShift());
+  for (const auto& layer : layers) {
+    const auto bottom = top + layer.first;
+    const auto overlap = std::min(high, bottom) - std::max(low, top);
+    if (overlap > 0.0 && layer.second)
+      out += overlap / dz * length * layer.second->GetDensity();
+    top = bottom;
+  }
+  return out / (g/cm2);
+}
 //----------------------------------------------------------------------------------------------
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
@@ -25,46 +181,62 @@ G4Material* Stopper = G4NistManager::Instance()->FindOrBuildMaterial("G4_Al");
 //__MuonMapper Data Variables___________________________________________________________________
 const std::string& Detector::DataName = "mu_map";
 const Analysis::ROOT::DataKeyList Detector::DataKeys{
-  "R", "logB"};
+  "R", "logB", "E_in", "X", "E_out", "D", "theta"};
 const Analysis::ROOT::DataKeyTypeList Detector::DataKeyTypes{
-  Analysis::ROOT::DataKeyType::Single, Analysis::ROOT::DataKeyType::Single};
+  Analysis::ROOT::DataKeyType::Single, Analysis::ROOT::DataKeyType::Single,
+  Analysis::ROOT::DataKeyType::Single, Analysis::ROOT::DataKeyType::Single,
+  Analysis::ROOT::DataKeyType::Single, Analysis::ROOT::DataKeyType::Single,
+  Analysis::ROOT::DataKeyType::Single};
+const std::string& Detector::MapName = "mu_map_hist";
 bool Detector::SaveAll = false;
 //----------------------------------------------------------------------------------------------
 
 //__Detector Constructor________________________________________________________________________
 Detector::Detector() : G4VSensitiveDetector("MATHUSLA/MU/MuonMapper") {
   collectionName.insert("MuonMapper_HC");
-  _box->SetSensitiveDetector(this);
+  if (_box)
+    _box->SetSensitiveDetector(this);
+  Analysis::ROOT::CreateHistogram(MapName, {MapRBins, 0.0, MapRMax}, {MapLogBBins, 0.0, MapLogBMax});
 }
 //----------------------------------------------------------------------------------------------
 
 //__Initalize Event_____________________________________________________________________________
-void Detector::Initialize(G4HCofThisEvent*) {}
+void Detector::Initialize(G4HCofThisEvent*) {
+  _map = Analysis::ROOT::GetHistogram(MapName);
+}
 //----------------------------------------------------------------------------------------------
 
 //__Hit Processing______________________________________________________________________________
 G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
-  const auto pre_step = step->GetPreStepPoint();
+  Perf::Count(Perf::ProcessHits);
   const auto track = step->GetTrack();
-  try {
-    if (track->GetParticleDefinition()->GetParticleName() != "mu-")
-      return false;
+  if (track->GetParticleDefinition()->GetPDGEncoding() != 13)
+    return false;
 
-    constexpr auto mass = 105.658369L;
-    const auto process = pre_step->GetProcessDefinedStep();
-    const auto process_name = process->GetProcessName();
-    if (process_name == "Transportation" && track->GetVolume() == track->GetNextVolume()) {
-      const auto kinetic = track->GetKineticEnergy() / MeV; // from GeV correction
-      /*
-      Analysis::ROOT::FillNTuple(DataPrefix, 0, {
-        (track->GetPosition() - G4ThreeVector(0, 0, 100*m)).mag() / m,
-        static_cast<double>(std::log10(std::sqrt(kinetic*kinetic + 2*kinetic*mass) / mass))});
-      */
-      track->SetTrackStatus(fStopAndKill);
-      return true;
-    }
-  } catch (...) {}
-  return false;
+  const auto process = step->GetPreStepPoint()->GetProcessDefinedStep();
+  if (!process || process->GetProcessType() != fTransportation || track->GetVolume() != track->GetNextVolume())
+    return false;
+
+  constexpr auto mass = 105.658369;
+  const auto kinetic = track->GetKineticEnergy() / MeV;
+  const auto R = (track->GetPosition() - G4ThreeVector(0, 0, 100*m)).mag() / m;
+  const auto logB = std::log10(std::sqrt(kinetic * kinetic + 2 * kinetic * mass) / mass);
+
+  if (_map)
+    _map->Fill(R, logB, track->GetWeight());
+  if (SaveAll) {
+    const auto& vertex = track->GetVertexPosition();
+    const auto& initial = track->GetVertexMomentumDirection();
+    const auto E_in = track->GetVertexKineticEnergy() / GeV;
+    const auto X = _column_density(vertex, track->GetPosition());
+    const auto E_out = kinetic * MeV / GeV;
+    const auto D = (track->GetPosition() - vertex).cross(initial).mag() / m;
+    const auto theta = initial.angle(track->GetMomentumDirection());
+    Analysis::ROOT::FillNTuple(DataName, DataKeyTypes, {R, logB, E_in, X, E_out, D, theta});
+  }
+
+  track->SetTrackStatus(fStopAndKill);
+  return true;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -95,6 +267,132 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Forget Constructed Volumes__________________________________________________________________
+void Detector::Reset() {
+  _box = nullptr;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sweep Messenger Directory Path______________________________________________________________
+const std::string Sweep::MessengerDirectory = "/sweep/";
+//----------------------------------------------------------------------------------------------
+
+//__Sweep Constructor___________________________________________________________________________
+Sweep::Sweep() : G4UImessenger(MessengerDirectory, "Adaptive Muon Map Sweep.") {
+  _energies = CreateCommand<Command::StringArg>("energies", "Set Sweep Kinetic Energies in GeV.");
+  _energies->SetParameterName("energies", false);
+  _energies->SetToBeBroadcasted(false);
+  _energies->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _angles = CreateCommand<Command::StringArg>("angles", "Set Sweep Zenith Angles in deg.");
+  _angles->SetParameterName("angles", false);
+  _angles->SetToBeBroadcasted(false);
+  _angles->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _events = CreateCommand<Command::IntegerArg>("events", "Set Initial Events per Sweep Point.");
+  _events->SetParameterName("events", false);
+  _events->SetToBeBroadcasted(false);
+  _events->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _max_events = CreateCommand<Command::IntegerArg>("max_events", "Set Maximum Events per Sweep Point.");
+  _max_events->SetParameterName("events", false);
+  _max_events->SetToBeBroadcasted(false);
+  _max_events->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _target = CreateCommand<Command::DoubleArg>("target", "Set Target Relative Error of Stopped Fraction.");
+  _target->SetParameterName("target", false);
+  _target->SetToBeBroadcasted(false);
+  _target->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _output = CreateCommand<Command::StringArg>("output", "Set Consolidated Sweep Output File.");
+  _output->SetParameterName("path", false);
+  _output->SetToBeBroadcasted(false);
+  _output->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _start = CreateCommand<Command::NoArg>("start", "Run Sweep over Energy-Angle Grid.");
+  _start->SetToBeBroadcasted(false);
+  _start->AvailableForStates(G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sweep Messenger Set New Value_______________________________________________________________
+void Sweep::SetNewValue(G4UIcommand* command,
+                        G4String value) {
+  if (G4Threading::IsWorkerThread())
+    return;
+
+  if (command == _energies) {
+    _sweep_valid_energies = _parse_values("Energy", value, _sweep_energies);
+  } else if (command == _angles) {
+    _sweep_valid_angles = _parse_values("Angle", value, _sweep_angles);
+  } else if (command == _events) {
+    _sweep_events = static_cast<std::size_t>(std::max(1, _events->GetNewIntValue(value)));
+  } else if (command == _max_events) {
+    _sweep_max_events = static_cast<std::size_t>(std::max(1, _max_events->GetNewIntValue(value)));
+  } else if (command == _target) {
+    _sweep_target = _target->GetNewDoubleValue(value);
+  } else if (command == _output) {
+    _sweep_output = value;
+  } else if (command == _start) {
+    Run();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Run Adaptive Sweep__________________________________________________________________________
+void Sweep::Run() {
+  if (Construction::Builder::GetDetectorName() != "MuonMapper") {
+    std::cerr << "[ERROR] Muon Map Sweep Requires the MuonMapper Detector.\n";
+    return;
+  }
+  if (!_sweep_valid_energies || !_sweep_valid_angles) {
+    std::cerr << "[ERROR] Muon Map Sweep has Invalid Energies or Angles. Fix them before /sweep/start.\n";
+    return;
+  }
+
+  std::vector<_sweep_point> points;
+  for (const auto energy : _sweep_energies)
+    for (const auto angle : _sweep_angles)
+      points.push_back({energy, angle, 0UL, 0UL, {}});
+
+  Command::Execute("/gen/select range", "/gen/range/id 13");
+
+  std::size_t round{};
+  for (bool pending = true; pending; ++round) {
+    pending = false;
+    for (auto& point : points) {
+      const auto count = _events_needed(point);
+      if (!count)
+        continue;
+      pending = true;
+
+      const auto theta = point.angle * deg;
+      Command::Execute(
+        "/gen/range/p_unit " + std::to_string(std::sin(theta)) + " 0 " + std::to_string(-std::cos(theta)),
+        "/gen/range/ke " + std::to_string(point.energy) + " GeV",
+        "/run/beamOn " + std::to_string(count));
+
+      Analysis::ROOT::Histogram2D merged;
+      if (!Analysis::ROOT::MergeHistogram(Detector::MapName, merged))
+        continue;
+      if (point.map.counts.empty()) {
+        point.map = merged;
+      } else {
+        for (std::size_t i{}; i < merged.counts.size(); ++i)
+          point.map.counts[i] += merged.counts[i];
+        point.map.entries += merged.entries;
+      }
+      point.events += count;
+      point.stopped += merged.entries;
+    }
+    std::cout << "Sweep Round " << round << " Complete\n";
+  }
+
+  _write_sweep(points);
+  std::cout << "Sweep Map: " << _sweep_output << "\n";
+}
+//----------------------------------------------------------------------------------------------
+
 } /* namespace MuonMapper */ ///////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
@@ -5,6 +5,7 @@
 
 #include "action.hh"
 #include "analysis.hh"
+#include "perf.hh"
 #include "geometry/Earth.hh"
 #include "physics/Units.hh"
 #include "tracking.hh"
@@ -22,6 +23,7 @@ G4LogicalVolume* _steel;
 
 //__Box Hit Collection__________________________________________________________________________
 G4ThreadLocal Tracking::HitCollection* _hit_collection;
+G4ThreadLocal bool _store_hits;
 //----------------------------------------------------------------------------------------------
 
 //__Box Specification Variables_________________________________________________________________
@@ -64,18 +66,22 @@ Detector::Detector() : G4VSensitiveDetector("MATHUSLA/MU/Box") {
 
 //__Initalize Event_____________________________________________________________________________
 void Detector::Initialize(G4HCofThisEvent* event) {
-  _hit_collection = Tracking::GenerateHitCollection(this, event);
+  _store_hits = Tracking::IsHitCollectionRequired(verboseLevel);
+  _hit_collection = _store_hits ? Tracking::GenerateHitCollection(this, event) : nullptr;
+  Tracking::AttachHitBuffers(DataName);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Hit Processing______________________________________________________________________________
 G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
+  Perf::Count(Perf::ProcessHits);
   const auto deposit = step->GetTotalEnergyDeposit();
 
   if (deposit == 0.0L)
     return false;
 
   const auto track      = step->GetTrack();
+  const auto touchable  = step->GetPreStepPoint()->GetTouchable();
   const auto step_point = step->GetPostStepPoint();
   const auto particle   = track->GetParticleDefinition();
   const auto trackID    = track->GetTrackID();
@@ -83,25 +89,26 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
   const auto position   = G4LorentzVector(step_point->GetGlobalTime(), step_point->GetPosition());
   const auto momentum   = G4LorentzVector(step_point->GetTotalEnergy(), step_point->GetMomentum());
 
-  const auto local_position = position.vect() - G4ThreeVector(x_displacement, y_displacement, 0);
+  const auto detector_id = EncodeDetector(touchable->GetReplicaNumber(1),
+                                          touchable->GetReplicaNumber(0),
+                                          touchable->GetCopyNumber(3));
 
-  const auto x_index = static_cast<size_t>(std::floor(+local_position.x() / scintillator_x_width));
-  const auto y_index = static_cast<size_t>(std::floor(+local_position.y() / scintillator_y_width));
-  const auto z_index = static_cast<size_t>(std::floor(-local_position.z() / (layer_spacing + scintillator_height)));
+  const auto hit_position = G4LorentzVector(position.t() / Units::Time,   position.vect() / Units::Length);
+  const auto hit_momentum = G4LorentzVector(momentum.e() / Units::Energy, momentum.vect() / Units::Momentum);
 
-  const auto x_name = std::to_string(x_index);
-  const auto y_name = std::to_string(y_index);
-
-  _hit_collection->insert(new Tracking::Hit(
-    particle,
+  Tracking::GetHitBuffer().Append(
+    particle->GetPDGEncoding(),
     trackID,
     parentID,
-    std::to_string(1UL + z_index)
-      + (x_index < 10UL ? "00" + x_name : (x_index < 100UL ? "0" + x_name : x_name))
-      + (y_index < 10UL ? "00" + y_name : (y_index < 100UL ? "0" + y_name : y_name)),
+    detector_id,
     deposit / Units::Energy,
-    G4LorentzVector(position.t() / Units::Time,   position.vect() / Units::Length),
-    G4LorentzVector(momentum.e() / Units::Energy, momentum.vect() / Units::Momentum)));
+    hit_position,
+    hit_momentum,
+    track->GetWeight());
+
+  if (_store_hits)
+    _hit_collection->insert(new Tracking::Hit(
+      particle, trackID, parentID, detector_id, deposit / Units::Energy, hit_position, hit_momentum));
 
   return true;
 }
@@ -109,45 +116,26 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
 
 //__Post-Event Processing_______________________________________________________________________
 void Detector::EndOfEvent(G4HCofThisEvent*) {
-  if (_hit_collection->GetSize() == 0 && !SaveAll)
-    return;
-
-  const auto collection_data = Tracking::ConvertToAnalysis(_hit_collection);
-
-  Analysis::ROOT::DataEntryList root_data;
-  root_data.reserve(24UL);
-  root_data.push_back(collection_data[0]);
-  root_data.push_back(collection_data[1]);
-  root_data.push_back(collection_data[2]);
-  root_data.push_back(collection_data[3]);
-  root_data.push_back(collection_data[4]);
-  root_data.push_back(collection_data[5]);
-  root_data.push_back(collection_data[6]);
-  root_data.push_back(collection_data[7]);
-  root_data.push_back(collection_data[8]);
-  root_data.push_back(collection_data[9]);
-  root_data.push_back(collection_data[10]);
-  root_data.push_back(collection_data[11]);
-  root_data.push_back(collection_data[12]);
-  root_data.push_back(collection_data[13]);
-
-  const auto gen_particle_data = SaveAll ? Tracking::ConvertToAnalysis(GeneratorAction::GetLastEvent())
-                                         : Tracking::ConvertToAnalysis(EventAction::GetEvent());
-  const auto extra_gen_data = Tracking::ConvertToAnalysis(GeneratorAction::GetGenerator()->ExtraDetails());
-  root_data.insert(root_data.cend(), gen_particle_data.cbegin(), gen_particle_data.cend());
-  root_data.insert(root_data.cend(), extra_gen_data.cbegin(), extra_gen_data.cend());
-
-  Analysis::ROOT::DataEntry metadata;
-  metadata.reserve(2UL);
-  metadata.push_back(collection_data[0UL].size());
-  metadata.push_back(gen_particle_data[0UL].size());
-
-  Analysis::ROOT::FillNTuple(DataName, Detector::DataKeyTypes, metadata, root_data);
-  if (verboseLevel >= 2 && _hit_collection)
+  const auto filled = EventAction::FillDetectorData(DataName, DataKeyTypes, SaveAll, [](const int) { return DigiThreshold; });
+  if (filled && verboseLevel >= 2)
     std::cout << *_hit_collection;
 }
 //----------------------------------------------------------------------------------------------
 
+//__Detector Encoding___________________________________________________________________________
+int Detector::EncodeDetector(const int x_index,
+                             const int y_index,
+                             const int z_index) {
+  return (1 + z_index) * 1000000 + x_index * 1000 + y_index;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Detector Layer of Encoded Detector__________________________________________________________
+int Detector::DetectorLayer(const int id) {
+  return id / 1000000;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Build Detector______________________________________________________________________________
 G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
   Scintillator::Material::Define();
@@ -160,14 +148,16 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
       x_edge_length,
       y_edge_length,
       scintillator_height,
-      scintillator_casing_thickness);
+      scintillator_casing_thickness,
+      scintillator_x_width,
+      scintillator_y_width);
     current->PlaceIn(DetectorVolume, Construction::Transform(
       0,
       0,
       half_detector_height
         - steel_height
         - 0.5L*scintillator_height
-        - layer * (scintillator_height + layer_spacing)));
+        - layer * (scintillator_height + layer_spacing)))->SetCopyNo(static_cast<G4int>(layer));
     _scintillators.push_back(current);
   }
 
@@ -186,6 +176,20 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world) {
   Earth::Material::Define();
 
   auto earth = Earth::Volume();
+  if (Construction::LayeredSolids()) {
+    auto sandstone = Earth::SandstoneVolume();
+    Construction::PlaceVolume(
+      Construction::BoxVolume("AirBox", x_edge_length, y_edge_length, air_gap),
+      sandstone,
+      Construction::Transform(0.5L*x_edge_length + x_displacement,
+                              0.5L*y_edge_length + y_displacement,
+                              0.5L*(air_gap-Earth::SandstoneDepth())));
+    Construction::PlaceVolume(sandstone, earth, Earth::SandstoneTransform());
+    Construction::PlaceVolume(Earth::MarlVolume(), earth, Earth::MarlTransform());
+    Construction::PlaceVolume(Earth::MixVolume(), earth, Earth::MixTransform());
+    return Construction::PlaceVolume(earth, world, Earth::Transform());
+  }
+
   auto modified = Construction::Volume(new G4SubtractionSolid("ModifiedSandstone",
     Earth::SandstoneVolume()->GetSolid(),
     Construction::Box("AirBox", x_edge_length, y_edge_length, air_gap),
@@ -201,6 +205,13 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Forget Constructed Volumes__________________________________________________________________
+void Detector::Reset() {
+  _scintillators.clear();
+  _steel = nullptr;
+}
+//----------------------------------------------------------------------------------------------
+
 } /* namespace Box */ //////////////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
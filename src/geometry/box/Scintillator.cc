@@ -1,5 +1,9 @@
 #include "geometry/Box.hh"
 
+#include <algorithm>
+#include <cmath>
+
+#include <Geant4/G4PVReplica.hh>
 #include <Geant4/G4SubtractionSolid.hh>
 #include <Geant4/tls.hh>
 
@@ -7,11 +11,44 @@ namespace MATHUSLA { namespace MU {
 
 namespace Box { ////////////////////////////////////////////////////////////////////////////////
 
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Tile Slab into Replicated Columns and Rows__________________________________________________
+G4LogicalVolume* _tile_volume(const std::string& name,
+                              G4LogicalVolume* slab,
+                              const double x_pitch,
+                              const double y_pitch) {
+  const auto box = static_cast<const G4Box*>(slab->GetSolid());
+  const auto x_length = 2.0 * box->GetXHalfLength();
+  const auto y_length = 2.0 * box->GetYHalfLength();
+  const auto z_length = 2.0 * box->GetZHalfLength();
+  const auto x_count = std::max(1L, std::lround(x_length / x_pitch));
+  const auto y_count = std::max(1L, std::lround(y_length / y_pitch));
+  const auto x_width = x_length / x_count;
+  const auto y_width = y_length / y_count;
+
+  auto column = Construction::BoxVolume(name + "_X", x_width, y_length, z_length,
+    slab->GetMaterial(), G4VisAttributes::GetInvisible());
+  new G4PVReplica(name + "_X", column, slab, kXAxis, static_cast<G4int>(x_count), x_width);
+
+  auto tile = Construction::BoxVolume(name + "_T", x_width, y_width, z_length,
+    slab->GetMaterial(), G4VisAttributes::GetInvisible());
+  new G4PVReplica(name + "_T", tile, column, kYAxis, static_cast<G4int>(y_count), y_width);
+
+  return tile;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Scintillator Constructor____________________________________________________________________
 Scintillator::Scintillator(const std::string& name,
                            const double length,
                            const double height,
                            const double width,
-                           const double thickness)
+                           const double thickness,
+                           const double x_pitch,
+                           const double y_pitch)
     : _name(name), _length(length), _height(height), _width(width), _thickness(thickness) {
 
   const auto border = 2 * _thickness;
@@ -19,12 +56,22 @@ Scintillator::Scintillator(const std::string& name,
   auto outer = Construction::Box("", _length, _height, _width);
   auto inner = Construction::Box("", _length - border, _height - border, _width - border);
 
-  auto casing = new G4SubtractionSolid(name + "_C", outer, inner);
-
-  _lvolume = Construction::Volume(name, outer, Construction::BorderAttributes());
-  _sensitive = Construction::PlaceVolume(name,
-    inner, Material::Scintillator, Construction::SensitiveAttributes(), _lvolume);
-  Construction::PlaceVolume(casing, Material::Casing, Construction::CasingAttributes(), _lvolume);
+  if (Construction::LayeredSolids()) {
+    _lvolume = Construction::Volume(name, outer, Material::Casing, Construction::CasingAttributes());
+    _sensitive = Construction::PlaceVolume(name,
+      inner, Material::Scintillator, Construction::SensitiveAttributes(), _lvolume);
+  } else {
+    auto casing = new G4SubtractionSolid(name + "_C", outer, inner);
+
+    _lvolume = Construction::Volume(name, outer, Construction::BorderAttributes());
+    _sensitive = Construction::PlaceVolume(name,
+      inner, Material::Scintillator, Construction::SensitiveAttributes(), _lvolume);
+    Construction::PlaceVolume(casing, Material::Casing, Construction::CasingAttributes(), _lvolume);
+  }
+
+  _tile = x_pitch > 0.0 && y_pitch > 0.0
+        ? _tile_volume(name, _sensitive->GetLogicalVolume(), x_pitch, y_pitch)
+        : _sensitive->GetLogicalVolume();
 }
 
 //__Scintillator Material_______________________________________________________________________
@@ -38,23 +85,26 @@ void Scintillator::Material::Define() {
 
   // Material::Scintillator = Construction::Material::Scintillator;
 
-  Material::Scintillator = new G4Material("Scintillator", 1.032*g/cm3, 2);
-  Material::Scintillator->AddElement(Construction::Material::C, 9);
-  Material::Scintillator->AddElement(Construction::Material::H, 10);
+  Material::Scintillator = Construction::Material::Intern("Scintillator", [](const auto& name) {
+    auto out = new G4Material(name, 1.032*g/cm3, 2);
+    out->AddElement(Construction::Material::C, 9);
+    out->AddElement(Construction::Material::H, 10);
 
-  constexpr int_fast32_t nSci = 1;
-  double eSci[nSci] = { 3.10*eV };
-  double rSci[nSci] = { 1.58    };
+    constexpr int_fast32_t nSci = 1;
+    double eSci[nSci] = { 3.10*eV };
+    double rSci[nSci] = { 1.58    };
 
-  auto sciProp = new G4MaterialPropertiesTable();
-  sciProp->AddProperty("RINDEX", eSci, rSci, nSci);
-  Material::Scintillator->SetMaterialPropertiesTable(sciProp);
+    auto sciProp = new G4MaterialPropertiesTable();
+    sciProp->AddProperty("RINDEX", eSci, rSci, nSci);
+    out->SetMaterialPropertiesTable(sciProp);
+    return out;
+  });
 }
 //----------------------------------------------------------------------------------------------
 
 //__Register Scintillator with Detector_________________________________________________________
 void Scintillator::Register(G4VSensitiveDetector* detector) {
-  _sensitive->GetLogicalVolume()->SetSensitiveDetector(detector);
+  _tile->SetSensitiveDetector(detector);
 }
 //----------------------------------------------------------------------------------------------
 
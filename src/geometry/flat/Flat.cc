@@ -17,9 +17,13 @@
 
 #include "geometry/Flat.hh"
 
+#include <algorithm>
+
 #include <Geant4/tls.hh>
 
+#include "action.hh"
 #include "geometry/Earth.hh"
+#include "perf.hh"
 #include "tracking.hh"
 
 namespace MATHUSLA { namespace MU {
@@ -34,6 +38,8 @@ std::vector<Layer*> _layers;
 
 //__Flat Hit Collection_________________________________________________________________________
 G4ThreadLocal Tracking::HitCollection* _hit_collection;
+G4ThreadLocal Tracking::HitAggregator _aggregator;
+G4ThreadLocal bool _store_hits;
 //----------------------------------------------------------------------------------------------
 
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
@@ -55,24 +61,53 @@ Detector::Detector() : G4VSensitiveDetector("MATHUSLA/MU/Flat") {
 
 //__Initalize Event_____________________________________________________________________________
 void Detector::Initialize(G4HCofThisEvent* event) {
-  _hit_collection = Tracking::GenerateHitCollection(this, event);
+  _store_hits = Tracking::IsHitCollectionRequired(verboseLevel);
+  _hit_collection = _store_hits ? Tracking::GenerateHitCollection(this, event) : nullptr;
+  _aggregator.Clear();
+  Tracking::AttachHitBuffers(DataName);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Hit Processing______________________________________________________________________________
 G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
-  _hit_collection->insert(new Tracking::Hit(step));
+  Perf::Count(Perf::ProcessHits);
+  const auto deposit = step->GetTotalEnergyDeposit();
+  if (!deposit || deposit < MinDeposit)
+    return false;
+
+  const auto detector_id = step->GetTrack()->GetTouchable()->GetHistory()->GetTopVolume()->GetCopyNo();
+  Tracking::GetHitBuffer().Append(step, detector_id);
+  if (!_store_hits)
+    return true;
+
+  const Tracking::Hit hit(step);
+  const auto time = hit.GetPosition().t();
+  const auto index = _aggregator.Find(hit.GetDetectorID(), hit.GetTrackID(), time);
+  if (index != Tracking::HitAggregator::npos) {
+    (*_hit_collection)[index]->Absorb(hit, Tracking::IsAggregationWeighted());
+    return true;
+  }
+  _aggregator.Insert(hit.GetDetectorID(), hit.GetTrackID(), time, _hit_collection->entries());
+  _hit_collection->insert(new Tracking::Hit(hit));
   return true;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Post-Event Processing_______________________________________________________________________
 void Detector::EndOfEvent(G4HCofThisEvent*) {
-  if (verboseLevel >= 2 && _hit_collection)
+  const auto filled = EventAction::FillDetectorData(DataName, DataKeyTypes, SaveAll,
+    [](const int) { return std::max(MinDeposit, DigiThreshold); });
+  if (filled && verboseLevel >= 2 && _hit_collection)
     std::cout << *_hit_collection;
 }
 //----------------------------------------------------------------------------------------------
 
+//__Detector Layer of Copy Number_______________________________________________________________
+int Detector::DetectorLayer(const int id) {
+  return id / 1000;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Build Detector______________________________________________________________________________
 G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
   Scintillator::Material::Define();
@@ -95,6 +130,12 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
 
   _layers = {L1, L2, L3};
 
+  for (std::size_t layer{}; layer < _layers.size(); ++layer) {
+    const auto& scintillators = _layers[layer]->GetScintillators();
+    for (std::size_t index{}; index < scintillators.size(); ++index)
+      scintillators[index]->sensitive->SetCopyNo(static_cast<G4int>((1 + layer) * 1000 + index));
+  }
+
   return Construction::PlaceVolume(DetectorVolume, world,
     G4Translate3D(0, 0, -0.5*total_outer_box_height));
 }
@@ -106,6 +147,12 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Forget Constructed Volumes__________________________________________________________________
+void Detector::Reset() {
+  _layers.clear();
+}
+//----------------------------------------------------------------------------------------------
+
 } /* namespace Flat */ /////////////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
@@ -95,17 +95,20 @@ G4Material* Scintillator::Material::Scintillator = nullptr;
 void Scintillator::Material::Define() {
   Material::Casing = Construction::Material::Aluminum;
 
-  Material::Scintillator = new G4Material("Scintillator", 1.032*g/cm3, 2);
-  Material::Scintillator->AddElement(Construction::Material::C, 9);
-  Material::Scintillator->AddElement(Construction::Material::H, 10);
-
-  constexpr int_fast32_t nSci = 1;
-  double eSci[nSci] = { 3.10*eV };
-  double rSci[nSci] = { 1.58    };
-
-  auto sciProp = new G4MaterialPropertiesTable();
-  sciProp->AddProperty("RINDEX", eSci, rSci, nSci);
-  Material::Scintillator->SetMaterialPropertiesTable(sciProp);
+  Material::Scintillator = Construction::Material::Intern("Scintillator", [](const auto& name) {
+    auto out = new G4Material(name, 1.032*g/cm3, 2);
+    out->AddElement(Construction::Material::C, 9);
+    out->AddElement(Construction::Material::H, 10);
+
+    constexpr int_fast32_t nSci = 1;
+    double eSci[nSci] = { 3.10*eV };
+    double rSci[nSci] = { 1.58    };
+
+    auto sciProp = new G4MaterialPropertiesTable();
+    sciProp->AddProperty("RINDEX", eSci, rSci, nSci);
+    out->SetMaterialPropertiesTable(sciProp);
+    return out;
+  });
 }
 //----------------------------------------------------------------------------------------------
 
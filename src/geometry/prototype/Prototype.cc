@@ -17,15 +17,18 @@
 
 #include "geometry/Prototype.hh"
 
+#include <algorithm>
 #include <unordered_map>
 
 #include <Geant4/G4HCofThisEvent.hh>
+#include <Geant4/G4Point3D.hh>
 #include <Geant4/G4Step.hh>
 #include <Geant4/tls.hh>
 
 #include "action.hh"
 #include "analysis.hh"
 #include "geometry/Cavern.hh"
+#include "perf.hh"
 #include "physics/Units.hh"
 #include "tracking.hh"
 #include "geometry/Earth.hh"
@@ -43,56 +46,159 @@ std::vector<RPC*> _rpcs;
 
 //__Prototype Hit Collection____________________________________________________________________
 G4ThreadLocal Tracking::HitCollection* _hit_collection;
+G4ThreadLocal bool _store_hits;
 //----------------------------------------------------------------------------------------------
 
-//__Encoding/Decoding Maps______________________________________________________________________
-G4ThreadLocal std::unordered_map<std::string, Scintillator*> _scintillator_map;
-G4ThreadLocal std::unordered_map<std::string, double>        _encoding;
-G4ThreadLocal std::unordered_map<int, std::string>           _decoding;
+//__Encoding Map________________________________________________________________________________
+G4ThreadLocal std::unordered_map<std::string, int> _encoding;
+//----------------------------------------------------------------------------------------------
+
+//__Sensitive Volume Table Indexed by Copy Number_______________________________________________
+std::vector<SensitiveVolume> _volume_table;
+//----------------------------------------------------------------------------------------------
+
+//__Table Index of Detector Copy Number_________________________________________________________
+int _table_index(const int id) {
+  if (id >= 0 && id < static_cast<int>(Scintillator::Count))
+    return id;
+  const auto rpc   = id / 1000 - 1;
+  const auto pad   = (id % 1000) / 10 - 1;
+  const auto strip = id % 10 - 1;
+  if (rpc < 0 || rpc >= static_cast<int>(RPC::Count)
+      || pad < 0 || pad >= static_cast<int>(RPC::PadsPerRPC)
+      || strip < 0 || strip >= static_cast<int>(RPC::StripsPerPad))
+    return -1;
+  return static_cast<int>(Scintillator::Count + (rpc * RPC::PadsPerRPC + pad) * RPC::StripsPerPad + strip);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Find Table Entry of Detector Copy Number____________________________________________________
+const SensitiveVolume* _find_volume(const int id) {
+  const auto index = _table_index(id);
+  return index >= 0 && static_cast<std::size_t>(index) < _volume_table.size()
+      && _volume_table[index].id == id ? &_volume_table[index] : nullptr;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Placement Transform of Physical Volume in its Mother________________________________________
+const G4Transform3D _placement(const G4VPhysicalVolume* volume) {
+  return G4Transform3D(volume->GetObjectRotationValue(), volume->GetObjectTranslation());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Sensitive Volume to Table_______________________________________________________________
+void _add_volume(const G4VPhysicalVolume* volume,
+                 const Scintillator* scintillator,
+                 const G4Transform3D& global) {
+  const auto id = volume->GetCopyNo();
+  const auto index = _table_index(id);
+  if (index < 0)
+    return;
+  if (static_cast<std::size_t>(index) >= _volume_table.size())
+    _volume_table.resize(index + 1UL, {-1, "", nullptr, nullptr, G4Transform3D(), G4Transform3D()});
+  _volume_table[index] = {id, volume->GetName(), volume, scintillator, global, global.inverse()};
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Sensitive Daughters of Logical Volume to Table__________________________________________
+void _index_daughters(const G4LogicalVolume* mother,
+                      const G4Transform3D& transform,
+                      const std::vector<G4LogicalVolume*>& sensitive) {
+  for (std::size_t i{}; i < mother->GetNoDaughters(); ++i) {
+    const auto daughter = mother->GetDaughter(i);
+    const auto global = transform * _placement(daughter);
+    const auto volume = daughter->GetLogicalVolume();
+    if (std::find(sensitive.cbegin(), sensitive.cend(), volume) != sensitive.cend()) {
+      _add_volume(daughter, nullptr, global);
+    } else {
+      _index_daughters(volume, global, sensitive);
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Prototype Data Keys with PMT Distances______________________________________________________
+const Analysis::ROOT::DataKeyList _data_keys() {
+  auto out = Analysis::ROOT::DefaultDataKeyList;
+  out.insert(out.end(), {"PMT_UP", "PMT_RIGHT", "PMT_R"});
+  return out;
+}
+const Analysis::ROOT::DataKeyTypeList _data_key_types() {
+  auto out = Analysis::ROOT::DefaultDataKeyTypeList;
+  out.insert(out.end(), 3UL, Analysis::ROOT::DataKeyType::Vector);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Fill PMT Distance Columns from Hit Columns__________________________________________________
+void _fill_pmt_columns(const std::string& name) {
+  const auto first = Analysis::ROOT::DefaultDataKeyList.size();
+  auto up    = Analysis::ROOT::GetRealColumn(name, first);
+  auto right = Analysis::ROOT::GetRealColumn(name, first + 1UL);
+  auto r     = Analysis::ROOT::GetRealColumn(name, first + 2UL);
+  for (auto column : {&up, &right, &r})
+    column->clear();
+
+  const auto hit = Analysis::ROOT::DefaultHitColumn;
+  const auto detector = Analysis::ROOT::GetIntegerColumn(name, hit + 2UL);
+  const auto x = Analysis::ROOT::GetRealColumn(name, hit + 6UL);
+  const auto y = Analysis::ROOT::GetRealColumn(name, hit + 7UL);
+  const auto z = Analysis::ROOT::GetRealColumn(name, hit + 8UL);
+  if (!detector || !x.size() || x.size() != y.size() || x.size() != z.size() || x.size() != detector->size())
+    return;
+
+  const auto size = detector->size();
+  for (auto column : {&up, &right, &r})
+    column->reserve(size);
+  for (std::size_t i{}; i < size; ++i) {
+    const auto entry = _find_volume((*detector)[i]);
+    Scintillator::PMTPoint point{0, 0, 0};
+    if (entry && entry->id < static_cast<int>(Scintillator::Count)) {
+      const auto local = entry->to_local * G4Point3D(x[i] * Units::Length, y[i] * Units::Length, z[i] * Units::Length);
+      const G4ThreeVector position(local.x(), local.y(), local.z());
+      point = entry->scintillator ? Scintillator::PMTDistance(position, entry->scintillator)
+                                  : Scintillator::PMTDistance(position, Scintillator::InfoArray[entry->id]);
+    }
+    up.push_back(point.up / Units::Length);
+    right.push_back(point.right / Units::Length);
+    r.push_back(point.r / Units::Length);
+  }
+}
 //----------------------------------------------------------------------------------------------
 
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Prototype Data Variables____________________________________________________________________
 const std::string& Detector::DataName = "prototype_run";
-const Analysis::ROOT::DataKeyList Detector::DataKeys = Analysis::ROOT::DefaultDataKeyList;
-const Analysis::ROOT::DataKeyTypeList Detector::DataKeyTypes = Analysis::ROOT::DefaultDataKeyTypeList;
+const Analysis::ROOT::DataKeyList Detector::DataKeys = _data_keys();
+const Analysis::ROOT::DataKeyTypeList Detector::DataKeyTypes = _data_key_types();
 bool Detector::SaveAll = false;
 //----------------------------------------------------------------------------------------------
 
 //__Prototype Constructor_______________________________________________________________________
 Detector::Detector() : G4VSensitiveDetector("MATHUSLA/MU/Prototype") {
   collectionName.insert("Prototype_HC");
-  for (auto scintillator : _scintillators) {
+  for (auto scintillator : _scintillators)
     scintillator->Register(this);
-    const auto name = scintillator->GetFullName();
-    const auto id = _decoding.size();
-    _scintillator_map.insert({name, scintillator});
-    _encoding.insert({name, id});
-    _decoding.insert({id, name});
-  }
-  for (auto rpc : _rpcs) {
+  for (auto rpc : _rpcs)
     rpc->Register(this);
-    for (const auto& pad : rpc->GetPadList()) {
-      for (const auto& volume : pad->pvolume_strips) {
-        const auto& name = volume->GetName();
-        const auto id = std::stoi(name);
-        _encoding.insert({name, id});
-        _decoding.insert({id, name});
-      }
-    }
-  }
+  for (const auto& entry : _volume_table)
+    if (entry.id >= 0)
+      _encoding.insert({entry.name, entry.id});
 }
 //----------------------------------------------------------------------------------------------
 
 //__Initalize Event_____________________________________________________________________________
 void Detector::Initialize(G4HCofThisEvent* event) {
-  _hit_collection = Tracking::GenerateHitCollection(this, event);
+  _store_hits = Tracking::IsHitCollectionRequired(verboseLevel);
+  _hit_collection = _store_hits ? Tracking::GenerateHitCollection(this, event) : nullptr;
+  Tracking::AttachHitBuffers(DataName);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Hit Processing______________________________________________________________________________
 G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
+  Perf::Count(Perf::ProcessHits);
   const auto deposit = step->GetTotalEnergyDeposit();
 
   const auto min_deposit = Scintillator::MinDeposit < RPC::MinDeposit ?
@@ -105,7 +211,7 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
   const auto trackID     = track->GetTrackID();
   const auto particle    = track->GetParticleDefinition();
   const auto history     = track->GetTouchable()->GetHistory();
-  const auto name        = history->GetTopVolume()->GetName();
+  const auto detector_id = history->GetTopVolume()->GetCopyNo();
   const auto post_step   = step->GetPostStepPoint();
 
   const auto global_time = post_step->GetGlobalTime()  / Units::Time;
@@ -113,42 +219,26 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
   const auto energy      = post_step->GetTotalEnergy() / Units::Energy;
   const auto momentum    = post_step->GetMomentum()    / Units::Momentum;
 
-  _hit_collection->insert(
-    new Tracking::Hit(
-      particle,
-      trackID,
-      track->GetParentID(),
-      name,
-      deposit / Units::Energy,
-      G4LorentzVector(global_time, position),
-      G4LorentzVector(energy, momentum)));
-
-  /* FIXME: add back to data
-  Scintillator::PMTPoint pmt_point{0, 0, 0};
-  if (detector_id < 100) {
-    const auto sci = _scintillator_map[name];
-
-    const auto& volume1 = history->GetVolume(history->GetDepth() - 1);
-    const auto& volume2 = history->GetVolume(history->GetDepth() - 2);
-    const auto& volume3 = history->GetVolume(history->GetDepth() - 3);
-    const auto& volume4 = history->GetVolume(history->GetDepth() - 4);
-
-    const auto& t1 = volume1->GetObjectTranslation();
-    const auto& t2 = volume2->GetObjectTranslation();
-    const auto& t3 = volume3->GetObjectTranslation();
-    const auto& t4 = volume4->GetObjectTranslation();
-
-    const auto& r2 = volume2->GetObjectRotationValue();
-    const auto& r3 = volume3->GetObjectRotationValue();
-    const auto& r4 = volume4->GetObjectRotationValue();
-
-    const auto translation = r4 * (r3 * (r2 * (t1) + t2) + t3) + t4;
-    const auto rotation = (r4*r3*r2).inverse();
-
-    if (sci)
-      pmt_point = Scintillator::PMTDistance(position, sci, translation, rotation);
-  }
-  */
+  Tracking::GetHitBuffer().Append(
+    particle->GetPDGEncoding(),
+    trackID,
+    track->GetParentID(),
+    detector_id,
+    deposit / Units::Energy,
+    G4LorentzVector(global_time, position),
+    G4LorentzVector(energy, momentum),
+    track->GetWeight());
+
+  if (_store_hits)
+    _hit_collection->insert(
+      new Tracking::Hit(
+        particle,
+        trackID,
+        track->GetParentID(),
+        detector_id,
+        deposit / Units::Energy,
+        G4LorentzVector(global_time, position),
+        G4LorentzVector(energy, momentum)));
 
   return true;
 }
@@ -156,54 +246,43 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
 
 //__Post-Event Processing_______________________________________________________________________
 void Detector::EndOfEvent(G4HCofThisEvent*) {
-  if (_hit_collection->GetSize() == 0 && !SaveAll)
-    return;
-
-  const auto collection_data = Tracking::ConvertToAnalysis(_hit_collection, _encoding);
-
-  Analysis::ROOT::DataEntryList root_data;
-  root_data.reserve(24);
-  root_data.push_back(collection_data[0]);
-  root_data.push_back(collection_data[1]);
-  root_data.push_back(collection_data[2]);
-  root_data.push_back(collection_data[3]);
-  root_data.push_back(collection_data[4]);
-  root_data.push_back(collection_data[5]);
-  root_data.push_back(collection_data[6]);
-  root_data.push_back(collection_data[7]);
-  root_data.push_back(collection_data[8]);
-  root_data.push_back(collection_data[9]);
-  root_data.push_back(collection_data[10]);
-  root_data.push_back(collection_data[11]);
-  root_data.push_back(collection_data[12]);
-  root_data.push_back(collection_data[13]);
-
-  const auto gen_particle_data = SaveAll ? Tracking::ConvertToAnalysis(GeneratorAction::GetLastEvent())
-                                         : Tracking::ConvertToAnalysis(EventAction::GetEvent());
-  const auto extra_gen_data = Tracking::ConvertToAnalysis(GeneratorAction::GetGenerator()->ExtraDetails());
-  root_data.insert(root_data.cend(), gen_particle_data.cbegin(), gen_particle_data.cend());
-  root_data.insert(root_data.cend(), extra_gen_data.cbegin(), extra_gen_data.cend());
-
-  Analysis::ROOT::DataEntry metadata;
-  metadata.reserve(2);
-  metadata.push_back(collection_data[0].size());
-  metadata.push_back(gen_particle_data[0].size());
-
-  Analysis::ROOT::FillNTuple(DataName, Detector::DataKeyTypes, metadata, root_data);
-  if (verboseLevel >= 2 && _hit_collection)
+  const auto filled = EventAction::FillDetectorData(DataName, DataKeyTypes, SaveAll, [](const int id) {
+    return std::max(id > 1000 ? RPC::MinDeposit : Scintillator::MinDeposit,
+                    id > 1000 ? RPC::DigiThreshold : Scintillator::DigiThreshold);
+  }, _fill_pmt_columns);
+  if (filled && verboseLevel >= 2)
     std::cout << *_hit_collection;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Detector Encoding___________________________________________________________________________
 int Detector::EncodeDetector(const std::string& name) {
-  return _encoding[name];
+  const auto search = _encoding.find(name);
+  return search != _encoding.cend() ? search->second : -1;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Detector Decoding___________________________________________________________________________
 const std::string Detector::DecodeDetector(int id) {
-  return _decoding[id];
+  const auto entry = _find_volume(id);
+  return entry ? entry->name : "";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Detector Layer of Copy Number_______________________________________________________________
+// Scintillator planes like SA1 get negative layers, RPCs keep their index.
+int Detector::DetectorLayer(const int id) {
+  if (id >= 0 && id < static_cast<int>(Scintillator::Count)) {
+    const auto& name = Scintillator::InfoArray[id].name;
+    return -(1 + 10 * (name[1] - 'A') + (name[2] - '0'));
+  }
+  return id / 1000;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sensitive Volume Table______________________________________________________________________
+const std::vector<SensitiveVolume>& Detector::SensitiveVolumes() {
+  return _volume_table;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -213,6 +292,7 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
   RPC::Material::Define();
   _scintillators.clear();
   _rpcs.clear();
+  _volume_table.clear();
 
   constexpr double total_outer_box_height = 6796.2*mm;
   auto DetectorVolume = Construction::BoxVolume(
@@ -230,6 +310,7 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
         G4ThreeVector(scintillator_info.x, scintillator_info.y, scintillator_info.z)
       )
     );
+    scintillator->sensitive->SetCopyNo(static_cast<G4int>(_scintillators.size()));
     _scintillators.push_back(scintillator);
   }
 
@@ -241,8 +322,23 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
     _rpcs.push_back(rpc);
   }
 
-  return Construction::PlaceVolume(DetectorVolume, world,
+  const auto placement = Construction::PlaceVolume(DetectorVolume, world,
     G4Translate3D(-2.386*m, 0.0*m, Earth::TotalShift() + Earth::BufferZoneLowerDepth() - 0.5 * total_outer_box_height));
+
+  const auto detector = _placement(placement);
+  for (const auto scintillator : _scintillators)
+    _add_volume(scintillator->sensitive, scintillator,
+      detector * _placement(scintillator->pvolume) * _placement(scintillator->sensitive));
+  for (const auto rpc : _rpcs) {
+    const auto rpc_transform = detector * _placement(rpc->GetPlacement());
+    for (const auto pad : rpc->GetPadList()) {
+      const auto pad_transform = rpc_transform * _placement(pad->pvolume);
+      for (const auto volume : pad->pvolume_strips)
+        _add_volume(volume, nullptr, pad_transform * _placement(volume));
+    }
+  }
+
+  return placement;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -252,6 +348,25 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Rebuild Sensitive Volume Table from Loaded World____________________________________________
+// Used for the geometry cache, where the world is read from GDML instead of constructed.
+// Copy numbers survive the round trip, so the table is indexed exactly as in Construct.
+void Detector::IndexVolumes(const G4VPhysicalVolume* world,
+                            const std::vector<G4LogicalVolume*>& sensitive) {
+  _volume_table.clear();
+  if (world)
+    _index_daughters(world->GetLogicalVolume(), _placement(world), sensitive);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Forget Constructed Volumes__________________________________________________________________
+void Detector::Reset() {
+  _scintillators.clear();
+  _rpcs.clear();
+  _volume_table.clear();
+}
+//----------------------------------------------------------------------------------------------
+
 } /* namespace Prototype */ ////////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
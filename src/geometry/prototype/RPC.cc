@@ -122,8 +122,10 @@ RPC::RPC(int input_id) : _pads(), _id(input_id), _name("RPC" + std::to_string(1
         Material::Gas,
         Construction::SensitiveAttributes());
       pad->lvolume_strips.push_back(strip);
-      pad->pvolume_strips.push_back(Construction::PlaceVolume(strip, pad->lvolume,
-        G4Translate3D(0.0, (strip_index - (StripsPerPad - 1) / 2.0) * StripSpacingY, 0.0)));
+      auto strip_volume = Construction::PlaceVolume(strip, pad->lvolume,
+        G4Translate3D(0.0, (strip_index - (StripsPerPad - 1) / 2.0) * StripSpacingY, 0.0));
+      strip_volume->SetCopyNo(static_cast<G4int>((1 + _id) * 1000 + (1 + pad_index) * 10 + (1 + strip_index)));
+      pad->pvolume_strips.push_back(strip_volume);
     }
 
     pad->pvolume = Construction::PlaceVolume(pad->lvolume, _volume,
@@ -145,40 +147,58 @@ G4Material* RPC::Material::PET = nullptr;
 
 //__Define RPC Material_________________________________________________________________________
 void RPC::Material::Define() {
-  auto C2H2F4 = new G4Material("C2H2F4", 4.1684*g/L, 3, G4State::kStateGas, temperature);
-  C2H2F4->AddElement(Construction::Material::C, 2);
-  C2H2F4->AddElement(Construction::Material::H, 2);
-  C2H2F4->AddElement(Construction::Material::F, 4);
-
-  auto isobutane = new G4Material("Isobutane", 2.4403*g/L, 2, G4State::kStateGas, temperature);
-  isobutane->AddElement(Construction::Material::C, 4);
-  isobutane->AddElement(Construction::Material::H, 10);
-
-  auto SF6 = new G4Material("SF6", 6.0380*g/L, 2, G4State::kStateGas, temperature);
-  SF6->AddElement(Construction::Material::S, 1);
-  SF6->AddElement(Construction::Material::F, 6);
-
-  auto argon = new G4Material("Argon", 1.6339*g/L, 1, G4State::kStateGas, temperature);
-  argon->AddElement(Construction::Material::Ar, 1);
-
-  const auto c2h2f4_partial_density    = atlas_gas_fraction * atlas_gas_c2h2f4_fraction    * C2H2F4->GetDensity();
-  const auto isobutane_partial_density = atlas_gas_fraction * atlas_gas_isobutane_fraction * isobutane->GetDensity();
-  const auto sf6_partial_density       = atlas_gas_fraction * atlas_gas_sf6_fraction       * SF6->GetDensity();
-
-  const auto argon_partial_density     = (1.0 - atlas_gas_fraction) * argon->GetDensity();
-
-  const auto gas_density = c2h2f4_partial_density + isobutane_partial_density + sf6_partial_density + argon_partial_density;
-
-  Material::Gas = new G4Material("Gas", gas_density, 4, G4State::kStateGas, temperature);
-  Material::Gas->AddMaterial(C2H2F4,    c2h2f4_partial_density    / gas_density);
-  Material::Gas->AddMaterial(isobutane, isobutane_partial_density / gas_density);
-  Material::Gas->AddMaterial(SF6,       sf6_partial_density       / gas_density);
-  Material::Gas->AddMaterial(argon,     argon_partial_density     / gas_density);
-
-  Material::PET = new G4Material("PET", 1.397*g/cm3, 3, G4State::kStateSolid);
-  Material::PET->AddElement(Construction::Material::C, 10);
-  Material::PET->AddElement(Construction::Material::H, 8);
-  Material::PET->AddElement(Construction::Material::O, 4);
+  const auto C2H2F4 = Construction::Material::Intern("C2H2F4", [](const auto& name) {
+    auto out = new G4Material(name, 4.1684*g/L, 3, G4State::kStateGas, temperature);
+    out->AddElement(Construction::Material::C, 2);
+    out->AddElement(Construction::Material::H, 2);
+    out->AddElement(Construction::Material::F, 4);
+    return out;
+  });
+
+  const auto isobutane = Construction::Material::Intern("Isobutane", [](const auto& name) {
+    auto out = new G4Material(name, 2.4403*g/L, 2, G4State::kStateGas, temperature);
+    out->AddElement(Construction::Material::C, 4);
+    out->AddElement(Construction::Material::H, 10);
+    return out;
+  });
+
+  const auto SF6 = Construction::Material::Intern("SF6", [](const auto& name) {
+    auto out = new G4Material(name, 6.0380*g/L, 2, G4State::kStateGas, temperature);
+    out->AddElement(Construction::Material::S, 1);
+    out->AddElement(Construction::Material::F, 6);
+    return out;
+  });
+
+  const auto argon = Construction::Material::Intern("Argon", [](const auto& name) {
+    auto out = new G4Material(name, 1.6339*g/L, 1, G4State::kStateGas, temperature);
+    out->AddElement(Construction::Material::Ar, 1);
+    return out;
+  });
+
+  Material::Gas = Construction::Material::Intern("Gas", [&](const auto& name) {
+    const auto c2h2f4_partial_density    = atlas_gas_fraction * atlas_gas_c2h2f4_fraction    * C2H2F4->GetDensity();
+    const auto isobutane_partial_density = atlas_gas_fraction * atlas_gas_isobutane_fraction * isobutane->GetDensity();
+    const auto sf6_partial_density       = atlas_gas_fraction * atlas_gas_sf6_fraction       * SF6->GetDensity();
+
+    const auto argon_partial_density     = (1.0 - atlas_gas_fraction) * argon->GetDensity();
+
+    const auto gas_density = c2h2f4_partial_density + isobutane_partial_density + sf6_partial_density + argon_partial_density;
+
+    auto out = new G4Material(name, gas_density, 4, G4State::kStateGas, temperature);
+    out->AddMaterial(C2H2F4,    c2h2f4_partial_density    / gas_density);
+    out->AddMaterial(isobutane, isobutane_partial_density / gas_density);
+    out->AddMaterial(SF6,       sf6_partial_density       / gas_density);
+    out->AddMaterial(argon,     argon_partial_density     / gas_density);
+    return out;
+  });
+
+  Material::PET = Construction::Material::Intern("PET", [](const auto& name) {
+    auto out = new G4Material(name, 1.397*g/cm3, 3, G4State::kStateSolid);
+    out->AddElement(Construction::Material::C, 10);
+    out->AddElement(Construction::Material::H, 8);
+    out->AddElement(Construction::Material::O, 4);
+    return out;
+  });
 }
 //----------------------------------------------------------------------------------------------
 
@@ -157,6 +157,9 @@ void Scintillator::Material::Define() {
   Material::Casing = Construction::Material::Aluminum;
   Material::Scintillator = Construction::Material::Polyvinyltoluene;
 
+  if (Material::Scintillator->GetMaterialPropertiesTable())
+    return;
+
   constexpr int_fast32_t nSci = 1;
   double eSci[nSci] = { 3.10*eV };
   double rSci[nSci] = { 1.58    };
@@ -178,12 +181,16 @@ Scintillator::PMTPoint Scintillator::PMTDistance(const G4ThreeVector position,
                                                  const Scintillator* sci,
                                                  const G4ThreeVector translation,
                                                  const G4RotationMatrix rotation) {
+  return PMTDistance(-(rotation*(translation - position)), sci);
+}
+//----------------------------------------------------------------------------------------------
 
-  const auto delta = rotation*(translation - position);
-
+//__Calculate Distance to PMT from Local Position_______________________________________________
+Scintillator::PMTPoint Scintillator::PMTDistance(const G4ThreeVector& local_position,
+                                                 const Scintillator* sci) {
   // Trapezoid coordinates
-  const auto x = -delta.x();
-  const auto y = -delta.z();
+  const auto x = local_position.x();
+  const auto y = local_position.z();
 
   const auto up_distance = 0.5 * sci->height - y;
 
@@ -195,6 +202,29 @@ Scintillator::PMTPoint Scintillator::PMTDistance(const G4ThreeVector position,
 }
 //----------------------------------------------------------------------------------------------
 
+//__Calculate Distance to PMT from Local Position and Scintillator Info_________________________
+// Used when the geometry comes from the cache and no Scintillator objects were built.
+Scintillator::PMTPoint Scintillator::PMTDistance(const G4ThreeVector& local_position,
+                                                 const Info& info) {
+  const auto border = 2.0 * (Thickness + Spacing);
+  const auto height   = info.trapezoid_height + border;
+  const auto minwidth = info.short_base + border;
+  const auto maxwidth = info.long_base + border;
+
+  // Trapezoid coordinates
+  const auto x = local_position.x();
+  const auto y = local_position.z();
+
+  const auto up_distance = 0.5 * height - y;
+
+  return {
+    up_distance,
+    std::hypot(y, 0.25 * (maxwidth + minwidth) - x),
+    std::hypot(up_distance, 0.5 * maxwidth - x)
+  };
+}
+//----------------------------------------------------------------------------------------------
+
 //__Register Scintillator with Detector_________________________________________________________
 void Scintillator::Register(G4VSensitiveDetector* detector) {
   sensitive->GetLogicalVolume()->SetSensitiveDetector(detector);
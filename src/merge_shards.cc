@@ -0,0 +1,202 @@
+/* src/merge_shards.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <TFile.h>
+#include <TKey.h>
+#include <TNamed.h>
+#include <TTree.h>
+
+#include "analysis.hh"
+
+#include "util/error.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Per-Shard Metadata Keys_____________________________________________________________________
+const std::set<std::string> _shard_keys{"SHARD", "SHARDS", "FIRST_EVENT", "LAST_EVENT"};
+//----------------------------------------------------------------------------------------------
+
+//__Metadata Keys Describing Shard Files________________________________________________________
+const std::set<std::string> _file_keys{"TIMESTAMP", "FILE", "SEGMENTS", "COLUMNAR_FILES"};
+//----------------------------------------------------------------------------------------------
+
+//__Combine Metadata Value of Later Shard_______________________________________________________
+// Performance counters and timings add up over the shards and memory takes the largest shard,
+// every other setting must agree with the first shard.
+void _combine_entry(const std::string& name,
+                    const std::string& value,
+                    const std::string& path,
+                    std::string& out) {
+  const auto perf = name.compare(0UL, 5UL, "PERF_") == 0;
+  const auto memory = name.compare(0UL, 7UL, "MEMORY_") == 0;
+  if (perf || memory) {
+    try {
+      const auto left = std::stod(out), right = std::stod(value);
+      const auto combined = perf ? left + right : std::max(left, right);
+      std::ostringstream stream;
+      stream << std::setprecision(15) << combined;
+      out = stream.str();
+      return;
+    } catch (...) {}
+  }
+  if (value != out && !_file_keys.count(name) && name.compare(0UL, 13UL, "COLUMNAR_FILE"))
+    std::cerr << "[WARNING] Mismatched " << name << " in " << path << ": " << value << " != " << out << "\n";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Shard File with Index_______________________________________________________________________
+struct _shard {
+  std::string path;
+  std::size_t index, count;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Read Metadata Entry from Shard______________________________________________________________
+std::string _read_entry(TFile& file,
+                        const std::string& name) {
+  const auto entry = dynamic_cast<TNamed*>(file.Get(name.c_str()));
+  return entry ? entry->GetTitle() : "";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load Shard Index from File__________________________________________________________________
+bool _load_shard(const std::string& path,
+                 _shard& out) {
+  TFile file(path.c_str(), "READ");
+  if (file.IsZombie())
+    return false;
+  util::error::exit_when(!_read_entry(file, "FILES").empty(),
+    "[FATAL ERROR] Unsupported Shard: ", path, "\n",
+    "              Shards written with \"/data/merge index\" cannot be merged.\n");
+  const auto index = _read_entry(file, "SHARD");
+  const auto count = _read_entry(file, "SHARDS");
+  out.path = path;
+  try {
+    out.index = index.empty() ? 0UL : std::stoul(index);
+    out.count = count.empty() ? 1UL : std::stoul(count);
+  } catch (...) {
+    return false;
+  }
+  file.Close();
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+//__Main Function: Merge Shards_________________________________________________________________
+int main(int argc, char* argv[]) {
+  using namespace MATHUSLA;
+  using namespace MATHUSLA::MU;
+
+  util::error::exit_when(argc < 3,
+    "Usage: ", argv[0], " <output file> <shard file>...\n");
+
+  std::vector<_shard> shards;
+  for (int i = 2; i < argc; ++i) {
+    _shard shard;
+    util::error::exit_when(!_load_shard(argv[i], shard),
+      "[FATAL ERROR] Unable to Read Shard: ", argv[i], "\n");
+    shards.push_back(shard);
+  }
+  std::sort(shards.begin(), shards.end(),
+    [](const auto& left, const auto& right) { return left.index < right.index; });
+
+  const auto count = shards.front().count;
+  for (std::size_t i{}; i < shards.size(); ++i) {
+    util::error::exit_when(shards[i].count != count,
+      "[FATAL ERROR] Mismatched Shard Counts: ", shards[i].path, "\n");
+    if (i && shards[i].index == shards[i - 1].index)
+      std::cerr << "[WARNING] Duplicate Shard " << shards[i].index << ": " << shards[i].path << "\n";
+  }
+  if (shards.size() != count)
+    std::cerr << "[WARNING] Merging " << shards.size() << " of " << count << " Shards\n";
+
+  auto output = TFile::Open(argv[1], "RECREATE");
+  util::error::exit_when(!output || output->IsZombie(),
+    "[FATAL ERROR] Unable to Open Output File: ", argv[1], "\n");
+
+  std::unordered_map<std::string, TTree*> trees;
+  std::vector<std::string> tree_order;
+  Analysis::SimSettingList metadata;
+  std::unordered_map<std::string, std::size_t> metadata_index;
+  for (std::size_t i{}; i < shards.size(); ++i) {
+    auto file = TFile::Open(shards[i].path.c_str(), "READ");
+    std::set<std::string> seen;
+    for (const auto object : *file->GetListOfKeys()) {
+      const auto key = static_cast<TKey*>(object);
+      const std::string name = key->GetName();
+      if (!seen.insert(name).second)
+        continue;
+      const std::string type = key->GetClassName();
+      if (type == "TTree" && name != "metadata") {
+        auto tree = dynamic_cast<TTree*>(file->Get(name.c_str()));
+        if (!tree)
+          continue;
+        output->cd();
+        auto& out = trees[name];
+        if (!out) {
+          out = tree->CloneTree(-1, "fast");
+          tree_order.push_back(name);
+        } else {
+          out->CopyEntries(tree, -1, "fast");
+        }
+        if (out)
+          out->ResetBranchAddresses();
+      } else if (type == "TNamed" && !_shard_keys.count(name)) {
+        auto entry = dynamic_cast<TNamed*>(file->Get(name.c_str()));
+        if (!entry)
+          continue;
+        const auto search = metadata_index.find(name);
+        if (search == metadata_index.end()) {
+          metadata_index[name] = metadata.size();
+          metadata.emplace_back(entry->GetName(), entry->GetTitle());
+        } else {
+          _combine_entry(name, entry->GetTitle(), shards[i].path, metadata[search->second].text);
+        }
+      }
+    }
+    file->Close();
+    delete file;
+  }
+
+  output->cd();
+  for (const auto& name : tree_order)
+    if (trees[name])
+      trees[name]->Write();
+  metadata.emplace_back("SHARDS", std::to_string(shards.size()));
+  Analysis::Save(output, metadata);
+  output->Close();
+  delete output;
+
+  std::cout << "Merged " << shards.size() << " Shards into " << argv[1] << "\n";
+  return 0;
+}
+//----------------------------------------------------------------------------------------------
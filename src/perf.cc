@@ -0,0 +1,198 @@
+/* src/perf.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "perf.hh"
+
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <Geant4/G4AutoLock.hh>
+#include <Geant4/G4Threading.hh>
+#include <Geant4/tls.hh>
+
+namespace MATHUSLA { namespace MU {
+
+namespace Perf { ///////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Registered Thread Records___________________________________________________________________
+std::vector<Record*> _records;
+G4Mutex _mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Thread Local Record_________________________________________________________________________
+G4ThreadLocal Record* _local = nullptr;
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Stage and Counter Names_____________________________________________________________________
+const std::array<std::string, StageCount> StageNames{{
+  "GENERATOR", "EVENT", "CONVERSION", "FILL", "MERGE"}};
+const std::array<std::string, CounterCount> CounterNames{{
+  "EVENTS", "PROCESS_HITS", "HITS", "EARLY_ABORTS", "WRITE_STALLS", "FRAMES", "REJECTED_FRAMES",
+  "TRIGGER_ACCEPTED", "TRIGGER_REJECTED"}};
+const std::array<std::string, MemoryCount> MemoryNames{{
+  "GEOMETRY", "PHYSICS", "HITS", "GENERATOR"}};
+//----------------------------------------------------------------------------------------------
+
+//__Performance Record for Current Thread_______________________________________________________
+Record& Local() {
+  if (!_local) {
+    _local = new Record;
+    _local->thread = G4Threading::G4GetThreadId();
+    G4AutoLock lock(&_mutex);
+    _records.push_back(_local);
+  }
+  return *_local;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Current Thread Record_________________________________________________________________
+void Reset() {
+  auto& record = Local();
+  const auto memory = record.memory;
+  const auto mark = record.resident_mark;
+  const auto thread = record.thread;
+  record = Record{};
+  record.memory = memory;
+  record.resident_mark = mark;
+  record.thread = thread;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sum Records over All Threads________________________________________________________________
+const Record Collect() {
+  Record out;
+  G4AutoLock lock(&_mutex);
+  for (const auto record : _records) {
+    for (std::size_t i{}; i < StageCount; ++i) {
+      out.time[i]  += record->time[i];
+      out.calls[i] += record->calls[i];
+    }
+    for (std::size_t i{}; i < CounterCount; ++i)
+      out.counts[i] += record->counts[i];
+    for (std::size_t i{}; i < MemoryCount; ++i)
+      out.memory[i] += record->memory[i];
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Resident Memory of Process in Bytes_________________________________________________________
+std::size_t ResidentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  std::size_t pages{}, resident{};
+  if (statm >> pages >> resident)
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage))
+    return 0UL;
+#if defined(__APPLE__)
+  return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+  return 1024UL * static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+}
+//----------------------------------------------------------------------------------------------
+
+//__Mark Resident Memory for Current Thread_____________________________________________________
+void MarkMemory() {
+  Local().resident_mark = ResidentBytes();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attribute Resident Growth since Mark to Category____________________________________________
+void MeasureMemory(const Memory category,
+                   const bool accumulate) {
+  auto& record = Local();
+  const auto resident = ResidentBytes();
+  const auto growth = resident > record.resident_mark ? resident - record.resident_mark : 0UL;
+  record.memory[category] = growth + (accumulate ? record.memory[category] : 0UL);
+  record.resident_mark = resident;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Memory in Category for Current Thread___________________________________________________
+void SetMemory(const Memory category,
+               const std::size_t bytes) {
+  Local().memory[category] = bytes;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Seconds Spent in Stage______________________________________________________________________
+double Seconds(const Record& record,
+               const Stage stage) {
+  return std::chrono::duration<double>(record.time[stage]).count();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Performance Summary Table_____________________________________________________________
+void Print(std::ostream& os,
+           const Record& record) {
+  const auto tracking = Seconds(record, Event) - Seconds(record, Conversion) - Seconds(record, Fill);
+  const auto events = record.counts[Events];
+  os << "\nPerformance Summary (thread seconds):\n";
+  for (std::size_t i{}; i < StageCount; ++i) {
+    const auto stage = static_cast<Stage>(i);
+    os << "  " << std::left << std::setw(16) << StageNames[i]
+       << std::right << std::setw(12) << std::fixed << std::setprecision(3) << Seconds(record, stage)
+       << " s  " << std::setw(10) << record.calls[i] << " calls\n";
+  }
+  os << "  " << std::left << std::setw(16) << "TRACKING"
+     << std::right << std::setw(12) << tracking << " s\n";
+  for (std::size_t i{}; i < CounterCount; ++i)
+    os << "  " << std::left << std::setw(16) << CounterNames[i]
+       << std::right << std::setw(12) << record.counts[i] << "\n";
+  if (events)
+    os << "  " << std::left << std::setw(16) << "HITS/EVENT"
+       << std::right << std::setw(12) << std::setprecision(2)
+       << static_cast<double>(record.counts[Hits]) / events << "\n";
+  os << std::defaultfloat << std::setprecision(6);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Memory Table per Thread_______________________________________________________________
+void PrintMemory(std::ostream& os) {
+  constexpr auto megabyte = 1024.0 * 1024.0;
+  os << "\nMemory Summary (MB):\n  " << std::left << std::setw(10) << "THREAD";
+  for (const auto& name : MemoryNames)
+    os << std::right << std::setw(12) << name;
+  os << "\n" << std::fixed << std::setprecision(2);
+  G4AutoLock lock(&_mutex);
+  for (const auto record : _records) {
+    os << "  " << std::left << std::setw(10)
+       << (record->thread < 0 ? std::string("MASTER") : "G4WT" + std::to_string(record->thread));
+    for (const auto bytes : record->memory)
+      os << std::right << std::setw(12) << bytes / megabyte;
+    os << "\n";
+  }
+  lock.unlock();
+  os << "  " << std::left << std::setw(10) << "RESIDENT"
+     << std::right << std::setw(12) << ResidentBytes() / megabyte << "\n";
+  os << std::defaultfloat << std::setprecision(6);
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Perf */ /////////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
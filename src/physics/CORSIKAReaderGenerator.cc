@@ -18,14 +18,21 @@
 
 #include "physics/CORSIKAReaderGenerator.hh"
 
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
 #include <Geant4/G4Threading.hh>
 #include <Geant4/G4AutoLock.hh>
 #include <Geant4/G4MTRunManager.hh>
+#include <Geant4/G4RunManager.hh>
 #include <Geant4/tls.hh>
 
 #include <TFile.h>
 #include <TTree.h>
 #include <TLeaf.h>
+#include <TLeafD.h>
+#include <TLeafF.h>
 
 #include "geometry/Construction.hh"
 #include "physics/Units.hh"
@@ -60,6 +67,9 @@ void CORSIKAEvent::clear() {
   py.clear();
   pz.clear();
   weight.clear();
+  cell_nx = cell_ny = 0;
+  cell_offset.clear();
+  cell_index.clear();
 }
 //----------------------------------------------------------------------------------------------
 
@@ -115,34 +125,98 @@ void CORSIKAEvent::push_back(const Particle& particle, double new_weight) {
 
 //__Particle Data Index Accessor Operator_______________________________________________________
 const Particle CORSIKAEvent::operator[](const std::size_t index) const {
-  return Particle{id[index], t[index], x[index], y[index], z[index], px[index], py[index], pz[index]};
+  Particle out{id[index], t[index], x[index], y[index], z[index], px[index], py[index], pz[index]};
+  out.weight = weight[index];
+  return out;
 }
 //----------------------------------------------------------------------------------------------
 
-namespace { ////////////////////////////////////////////////////////////////////////////////////
+//__Build Spatial Grid Index over Particle Positions____________________________________________
+void CORSIKAEvent::build_index() {
+  cell_offset.clear();
+  cell_index.clear();
+  cell_nx = cell_ny = 0;
+  const auto count = size();
+  if (!count)
+    return;
+
+  const auto x_range = std::minmax_element(x.cbegin(), x.cend());
+  const auto y_range = std::minmax_element(y.cbegin(), y.cend());
+  cell_x0 = *x_range.first;
+  cell_y0 = *y_range.first;
+
+  const auto side = std::min(1024.0, std::max(1.0, std::ceil(std::sqrt(count / 8.0))));
+  cell_size = std::max(*x_range.second - cell_x0, *y_range.second - cell_y0) / side;
+  if (cell_size <= 0)
+    cell_size = 1.0;
+  cell_nx = 1UL + static_cast<std::size_t>((*x_range.second - cell_x0) / cell_size);
+  cell_ny = 1UL + static_cast<std::size_t>((*y_range.second - cell_y0) / cell_size);
+
+  std::vector<std::size_t> cell(count);
+  cell_offset.assign(cell_nx * cell_ny + 1UL, 0UL);
+  for (std::size_t i{}; i < count; ++i) {
+    const auto ix = std::min(cell_nx - 1UL, static_cast<std::size_t>((x[i] - cell_x0) / cell_size));
+    const auto iy = std::min(cell_ny - 1UL, static_cast<std::size_t>((y[i] - cell_y0) / cell_size));
+    cell[i] = iy * cell_nx + ix;
+    ++cell_offset[cell[i] + 1UL];
+  }
+  for (std::size_t c{}; c < cell_nx * cell_ny; ++c)
+    cell_offset[c + 1UL] += cell_offset[c];
 
-//__Mutex for ROOT Interface____________________________________________________________________
-G4Mutex _mutex = G4MUTEX_INITIALIZER;
+  cell_index.resize(count);
+  auto next = cell_offset;
+  for (std::size_t i{}; i < count; ++i)
+    cell_index[next[cell[i]]++] = i;
+}
 //----------------------------------------------------------------------------------------------
 
-//__Get Range of Thread in Data_________________________________________________________________
-std::pair<std::size_t, std::size_t> _calculate_thread_range(const std::size_t total) {
-  const auto bucket_size = std::ceil(total / static_cast<long double>(G4Threading::GetNumberOfRunningWorkerThreads()));
-  const auto first = bucket_size * G4Threading::G4GetThreadId();
-  return {first, first + bucket_size};
+//__Select Particles Inside Window using Grid Index_____________________________________________
+void CORSIKAEvent::select(double x_min,
+                          double x_max,
+                          double y_min,
+                          double y_max,
+                          std::vector<std::size_t>& out) const {
+  out.clear();
+  if (!cell_nx || !cell_ny || x_max < x_min || y_max < y_min)
+    return;
+
+  const auto x_stop = (x_max - cell_x0) / cell_size;
+  const auto y_stop = (y_max - cell_y0) / cell_size;
+  if (x_stop < 0 || y_stop < 0)
+    return;
+
+  const auto ix_first = static_cast<std::size_t>(std::max(0.0, (x_min - cell_x0) / cell_size));
+  const auto iy_first = static_cast<std::size_t>(std::max(0.0, (y_min - cell_y0) / cell_size));
+  const auto ix_last  = std::min(cell_nx - 1UL, static_cast<std::size_t>(x_stop));
+  const auto iy_last  = std::min(cell_ny - 1UL, static_cast<std::size_t>(y_stop));
+
+  for (auto iy = iy_first; iy <= iy_last; ++iy) {
+    for (auto ix = ix_first; ix <= ix_last; ++ix) {
+      const auto c = iy * cell_nx + ix;
+      for (auto k = cell_offset[c]; k < cell_offset[c + 1UL]; ++k) {
+        const auto i = cell_index[k];
+        if (x[i] >= x_min && x[i] <= x_max && y[i] >= y_min && y[i] <= y_max)
+          out.push_back(i);
+      }
+    }
+  }
+  std::sort(out.begin(), out.end());
 }
 //----------------------------------------------------------------------------------------------
 
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Mutex for ROOT Interface____________________________________________________________________
+G4Mutex _mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
 //__CMS Plot Rotation Angle_____________________________________________________________________
 const auto CMS_ROTATION_ANGLE = 80.0L * deg;
 //----------------------------------------------------------------------------------------------
 
-//__Calculate CMS Final Rotation________________________________________________________________
-const std::pair<double, double> _cms_rotation(double x,
-                                              double y) {
-  return {x * std::cos(CMS_ROTATION_ANGLE / rad) + y * std::sin(CMS_ROTATION_ANGLE / rad),
-          x * std::sin(CMS_ROTATION_ANGLE / rad) - y * std::cos(CMS_ROTATION_ANGLE / rad)};
-}
+//__CMS Final Rotation Coefficients_____________________________________________________________
+const double _cms_cos = std::cos(CMS_ROTATION_ANGLE / rad);
+const double _cms_sin = std::sin(CMS_ROTATION_ANGLE / rad);
 //----------------------------------------------------------------------------------------------
 
 //__Particle PDG Codes__________________________________________________________________________
@@ -152,7 +226,7 @@ const std::pair<double, double> _cms_rotation(double x,
 
 //__Convert Primary ID from CORSIKA to PDG______________________________________________________
 std::pair<int, int> _convert_primary_id(int corsika_id) {
-  static const int id_table[] = {
+  static constexpr int id_table[] = {
        22,   -11,    11,     0,   -13,
        13,   111,   211,  -211,   130,
       321,  -321,  2112,  2212, -2212,
@@ -194,7 +268,9 @@ std::pair<int, int> _convert_primary_id(int corsika_id) {
         0,     0,     0,     0,     0,
         0,     0,     0,     0,     0
   };
-  return std::make_pair(id_table[corsika_id - 1], corsika_id);
+  constexpr int id_table_size = sizeof(id_table) / sizeof(id_table[0]);
+  return std::make_pair(corsika_id > 0 && corsika_id <= id_table_size ? id_table[corsika_id - 1] : 0,
+                        corsika_id);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -266,28 +342,33 @@ struct _event_subtree {
 };
 //----------------------------------------------------------------------------------------------
 
-//__Load Particle from Subtree__________________________________________________________________
-void _load_particle(const std::size_t i,
-                    _event_subtree& subtree,
-                    const int particle_id,
-                    const Particle& origin,
-                    CORSIKAEvent& out) {
-  const auto position = _cms_rotation(subtree.x->GetValue(i) * cm,
-                                      subtree.y->GetValue(i) * cm);
-  const auto momentum = _cms_rotation(subtree.px->GetValue(i) * GeVperC,
-                                      subtree.py->GetValue(i) * GeVperC);
-  out.push_back(particle_id,
-                subtree.t->GetValue(i) * ns,
-                position.first + origin.x,
-                position.second + origin.y,
-                -(subtree.obs->GetValue(subtree.z->GetValue(i) - 1) * cm - origin.z),
-                momentum.first,
-                momentum.second,
-                subtree.pz->GetValue(i) * GeVperC,
-                subtree.weight->GetValue(i));
+//__Read TTree Leaf into Contiguous Array______________________________________________________
+void _read_leaf(TLeaf* leaf,
+                const std::size_t count,
+                std::vector<double>& out) {
+  out.resize(count);
+  if (!leaf || !count)
+    return;
+  if (const auto leaf_d = dynamic_cast<TLeafD*>(leaf)) {
+    const auto data = static_cast<const Double_t*>(leaf_d->GetValuePointer());
+    std::copy(data, data + count, out.begin());
+  } else if (const auto leaf_f = dynamic_cast<TLeafF*>(leaf)) {
+    const auto data = static_cast<const Float_t*>(leaf_f->GetValuePointer());
+    std::copy(data, data + count, out.begin());
+  } else {
+    for (std::size_t i{}; i < count; ++i)
+      out[i] = leaf->GetValue(i);
+  }
 }
 //----------------------------------------------------------------------------------------------
 
+//__Staging Arrays for Shower Ingest____________________________________________________________
+struct _ingest_buffer {
+  std::vector<double> id, t, x, y, z, px, py, pz, weight, obs;
+  std::vector<std::size_t> keep;
+};
+//----------------------------------------------------------------------------------------------
+
 //__Perform Random Translation of Event Vector__________________________________________________
 std::pair<double, double> _random_translation(double max_radius) {
   const auto r = max_radius * std::sqrt(util::random::uniform());
@@ -296,6 +377,97 @@ std::pair<double, double> _random_translation(double max_radius) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Shared Shower Cache_________________________________________________________________________
+struct _shower_cache_entry {
+  CORSIKAConfig config;
+  std::shared_ptr<const CORSIKAEvent> event;
+};
+std::unordered_map<std::string, _shower_cache_entry> _shower_cache;
+//----------------------------------------------------------------------------------------------
+
+//__Shower Cache Key____________________________________________________________________________
+const std::string _shower_cache_key(const std::string& path,
+                                    const CORSIKAConfig& config,
+                                    const Particle& origin) {
+  return path
+    + '#' + std::to_string(config.event_id)
+    + '@' + std::to_string(origin.x)
+    + ',' + std::to_string(origin.y)
+    + ',' + std::to_string(origin.z);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load Shower from Current Subtree Entry_____________________________________________________
+void _load_shower(_event_subtree& subtree,
+                  const Particle& origin,
+                  CORSIKAConfig& config,
+                  CORSIKAEvent& event) {
+  subtree.load_config(config);
+  event.clear();
+
+  const auto signed_event_size = subtree.id->GetLen();
+  const auto event_size = signed_event_size > 0 ? static_cast<std::size_t>(signed_event_size) : 0UL;
+  const auto signed_obs_size = subtree.obs->GetLen();
+  const auto obs_size = signed_obs_size > 0 ? static_cast<std::size_t>(signed_obs_size) : 0UL;
+
+  _ingest_buffer buffer;
+  _read_leaf(subtree.id,     event_size, buffer.id);
+  _read_leaf(subtree.t,      event_size, buffer.t);
+  _read_leaf(subtree.x,      event_size, buffer.x);
+  _read_leaf(subtree.y,      event_size, buffer.y);
+  _read_leaf(subtree.z,      event_size, buffer.z);
+  _read_leaf(subtree.px,     event_size, buffer.px);
+  _read_leaf(subtree.py,     event_size, buffer.py);
+  _read_leaf(subtree.pz,     event_size, buffer.pz);
+  _read_leaf(subtree.weight, event_size, buffer.weight);
+  _read_leaf(subtree.obs,    obs_size,   buffer.obs);
+
+  buffer.keep.reserve(event_size);
+  event.id.reserve(event_size);
+  for (std::size_t i{}; i < event_size; ++i) {
+    const auto particle_id_pair = _convert_primary_id(static_cast<int>(buffer.id[i]));
+    if ((std::abs(particle_id_pair.first) == 13 && particle_id_pair.second > 10))
+      continue;
+    buffer.keep.push_back(i);
+    event.id.push_back(particle_id_pair.first);
+  }
+
+  const auto size = buffer.keep.size();
+  const auto keep = buffer.keep.data();
+  event.t.resize(size);
+  event.x.resize(size);
+  event.y.resize(size);
+  event.z.resize(size);
+  event.px.resize(size);
+  event.py.resize(size);
+  event.pz.resize(size);
+  event.weight.resize(size);
+
+  for (std::size_t k{}; k < size; ++k) {
+    const auto i = keep[k];
+    const auto x = buffer.x[i] * cm;
+    const auto y = buffer.y[i] * cm;
+    const auto px = buffer.px[i] * GeVperC;
+    const auto py = buffer.py[i] * GeVperC;
+    event.t[k] = buffer.t[i] * ns;
+    event.x[k] = x * _cms_cos + y * _cms_sin + origin.x;
+    event.y[k] = x * _cms_sin - y * _cms_cos + origin.y;
+    event.px[k] = px * _cms_cos + py * _cms_sin;
+    event.py[k] = px * _cms_sin - py * _cms_cos;
+    event.pz[k] = buffer.pz[i] * GeVperC;
+    event.weight[k] = buffer.weight[i];
+  }
+
+  for (std::size_t k{}; k < size; ++k) {
+    const auto level = static_cast<std::size_t>(buffer.z[keep[k]]);
+    const auto depth = level > 0 && level <= obs_size ? buffer.obs[level - 1] : 0.0;
+    event.z[k] = -(depth * cm - origin.z);
+  }
+
+  event.build_index();
+}
+//----------------------------------------------------------------------------------------------
+
 //__Collect Data From Tree______________________________________________________________________
 void _collect_source(const std::string& path,
                      const Particle& origin,
@@ -307,23 +479,11 @@ void _collect_source(const std::string& path,
     file.cd();
     auto spec_tree = dynamic_cast<TTree*>(file.Get("run"));
     auto data_tree = dynamic_cast<TTree*>(file.Get("sim"));
-    const auto data_entries = data_tree->GetEntries();
-    if (spec_tree && data_tree && (spec_tree->GetEntries() == 1) && (data_entries > 0)) {
+    if (spec_tree && data_tree && (spec_tree->GetEntries() == 1) && (data_tree->GetEntries() > 0)) {
       _event_subtree subtree{spec_tree, data_tree};
       subtree.spec_tree->GetEntry(0);
       subtree.data_tree->GetEntry(config.event_id);
-      subtree.load_config(config);
-
-      const auto signed_event_size = subtree.id->GetLen();
-      const auto event_size = signed_event_size > 0 ? static_cast<std::size_t>(signed_event_size) : 0UL;
-
-      event.reserve(event_size);
-      for (std::size_t i{}; i < event_size; ++i) {
-        const auto particle_id_pair = _convert_primary_id(subtree.id->GetValue(i));
-        if ((std::abs(particle_id_pair.first) == 13 && particle_id_pair.second > 10))
-          continue;
-        _load_particle(i, subtree, particle_id_pair.first, origin, event);
-      }
+      _load_shower(subtree, origin, config, event);
 
       if (event.empty()) {
         std::cout << "No Event in CORSIKA File. Exiting.\n";
@@ -338,11 +498,174 @@ void _collect_source(const std::string& path,
 }
 //----------------------------------------------------------------------------------------------
 
+//__Count Showers in Tree_______________________________________________________________________
+std::size_t _count_showers(const std::string& path) {
+  std::size_t out{};
+  TFile file(path.c_str(), "READ");
+  if (!file.IsZombie()) {
+    auto data_tree = dynamic_cast<TTree*>(file.Get("sim"));
+    if (data_tree && data_tree->GetEntries() > 0)
+      out = static_cast<std::size_t>(data_tree->GetEntries());
+  }
+  file.Close();
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stream Range of Showers From Tree___________________________________________________________
+std::size_t _collect_stream(const std::string& path,
+                            const Particle& origin,
+                            const CORSIKAConfig& base_config,
+                            const std::size_t first,
+                            const std::size_t last,
+                            std::deque<CORSIKAShower>& out) {
+  std::size_t next = first;
+  TFile file(path.c_str(), "READ");
+  if (!file.IsZombie()) {
+    file.cd();
+    auto spec_tree = dynamic_cast<TTree*>(file.Get("run"));
+    auto data_tree = dynamic_cast<TTree*>(file.Get("sim"));
+    if (spec_tree && data_tree && (spec_tree->GetEntries() == 1)) {
+      _event_subtree subtree{spec_tree, data_tree};
+      subtree.spec_tree->GetEntry(0);
+      const auto end = std::min(last, static_cast<std::size_t>(data_tree->GetEntries()));
+      for (; next < end; ++next) {
+        subtree.data_tree->GetEntry(next);
+        CORSIKAShower shower{base_config, {}};
+        shower.config.event_id = next;
+        _load_shower(subtree, origin, shower.config, shower.event);
+        if (!shower.event.empty())
+          out.push_back(std::move(shower));
+      }
+    } else {
+      next = last;
+    }
+  } else {
+    next = last;
+  }
+  file.Close();
+  return next;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Shared Shower Stream Cursor_________________________________________________________________
+std::string _stream_path;
+std::size_t _stream_cursor{}, _stream_last{};
+//----------------------------------------------------------------------------------------------
+
+//__Reset Shower Stream to Shard Range__________________________________________________________
+void _reset_stream(const std::string& path) {
+  if (_stream_path == path)
+    return;
+  const auto range = RunAction::ShardRange(_count_showers(path));
+  _stream_path = path;
+  _stream_cursor = range.first;
+  _stream_last = range.second;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Claim Block of Showers from Stream__________________________________________________________
+std::pair<std::size_t, std::size_t> _claim_stream(const std::size_t count) {
+  const auto first = _stream_cursor;
+  _stream_cursor = std::min(_stream_last, first + count);
+  return {first, _stream_cursor};
+}
+//----------------------------------------------------------------------------------------------
+
+//__Showers Shared Between Sub-Events___________________________________________________________
+struct _split_entry {
+  CORSIKAConfig config;
+  std::shared_ptr<const CORSIKAEvent> event;
+  std::size_t claims;
+};
+std::unordered_map<std::size_t, _split_entry> _split_showers;
+//----------------------------------------------------------------------------------------------
+
+//__Claim Streamed Shower for Sub-Event_________________________________________________________
+std::shared_ptr<const CORSIKAEvent> _claim_split_shower(const std::string& path,
+                                                        const Particle& origin,
+                                                        const std::size_t index,
+                                                        const std::size_t parts,
+                                                        CORSIKAConfig& config) {
+  auto search = _split_showers.find(index);
+  if (search == _split_showers.end()) {
+    std::deque<CORSIKAShower> buffer;
+    CORSIKAConfig base = config;
+    _collect_stream(path, origin, base, index, index + 1UL, buffer);
+    _split_entry entry{base, nullptr, 0UL};
+    if (!buffer.empty()) {
+      entry.config = buffer.front().config;
+      entry.event = std::make_shared<const CORSIKAEvent>(std::move(buffer.front().event));
+    }
+    search = _split_showers.emplace(index, std::move(entry)).first;
+  }
+  const auto max_radius = config.max_radius;
+  config = search->second.config;
+  config.max_radius = max_radius;
+  auto out = search->second.event;
+  if (++search->second.claims >= parts)
+    _split_showers.erase(search);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Translation Shared by All Sub-Events of a Shower____________________________________________
+std::pair<double, double> _split_translation(const std::size_t logical_event,
+                                             const double max_radius) {
+  util::random::philox engine(util::random::run_seed(),
+                              util::random::mix(RunAction::RunID(), logical_event, 0xC0851CAULL));
+  const auto r = max_radius * std::sqrt(util::random::canonical(engine));
+  const auto theta = 2.0L * 3.141592653589793238462643383279502884L * util::random::canonical(engine);
+  return std::make_pair(r * std::cos(theta), r * std::sin(theta));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load Shower from Shared Cache_______________________________________________________________
+std::shared_ptr<const CORSIKAEvent> _load_shared_source(const std::string& path,
+                                                        const Particle& origin,
+                                                        CORSIKAConfig& config) {
+  const auto key = _shower_cache_key(path, config, origin);
+  const auto max_radius = config.max_radius;
+
+  const auto search = _shower_cache.find(key);
+  if (search != _shower_cache.cend()) {
+    config = search->second.config;
+    config.max_radius = max_radius;
+    return search->second.event;
+  }
+
+  for (auto it = _shower_cache.begin(); it != _shower_cache.end();) {
+    if (it->second.event.use_count() == 1) {
+      it = _shower_cache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto event = std::make_shared<CORSIKAEvent>();
+  _collect_source(path, origin, config, *event);
+  _shower_cache[key] = _shower_cache_entry{config, event};
+  return event;
+}
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
+//__Read CORSIKA Shower from ROOT File__________________________________________________________
+void ReadCORSIKAShower(const std::string& path,
+                       const Particle& origin,
+                       CORSIKAConfig& config,
+                       CORSIKAEvent& event) {
+  event.clear();
+  _collect_source(path, origin, config, event);
+}
+//----------------------------------------------------------------------------------------------
+
 //__CORSIKA Reader Generator Constructor________________________________________________________
 CORSIKAReaderGenerator::CORSIKAReaderGenerator(const std::string& path)
-    : Generator("corsika_reader", "CORSIKA Reader Generator."), _last_event({}), _translation({0, 0}), _path(path) {
+    : Generator("corsika_reader", "CORSIKA Reader Generator."), _last_event({}), _extra(Tracking::EmptyExtra()), _event(nullptr),
+      _config(), _translation({0, 0}), _path(path), _stream(false), _read_ahead(4UL),
+      _cull(false), _cull_margin(10*m), _split(1UL) {
   _read_file = CreateCommand<Command::StringArg>("read_file", "Read CORSIKA ROOT File.");
   _read_file->AvailableForStates(G4State_PreInit, G4State_Idle);
 
@@ -357,32 +680,126 @@ CORSIKAReaderGenerator::CORSIKAReaderGenerator(const std::string& path)
   _set_max_radius->SetRange("radius >= 0");
   _set_max_radius->SetDefaultUnit("m");
   _set_max_radius->SetUnitCandidates("m cm");
+
+  _set_stream = CreateCommand<Command::BoolArg>("stream", "Stream Through All Showers in File.");
+  _set_stream->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_stream->SetParameterName("stream", false);
+
+  _set_read_ahead = CreateCommand<Command::IntegerArg>("read_ahead", "Set Number of Showers Buffered per Thread.");
+  _set_read_ahead->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_read_ahead->SetParameterName("count", false, false);
+  _set_read_ahead->SetRange("count > 0");
+
+  _set_cull = CreateCommand<Command::BoolArg>("cull", "Skip Particles Far From Detector.");
+  _set_cull->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_cull->SetParameterName("cull", false);
+
+  _set_cull_margin = CreateCommand<Command::DoubleUnitArg>("cull_margin", "Set Culling Margin Around Detector.");
+  _set_cull_margin->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_cull_margin->SetParameterName("margin", false, false);
+  _set_cull_margin->SetRange("margin >= 0");
+  _set_cull_margin->SetDefaultUnit("m");
+  _set_cull_margin->SetUnitCandidates("m cm");
+
+  _set_split = CreateCommand<Command::IntegerArg>("split", "Split Each Shower into Sub-Events.");
+  _set_split->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_split->SetParameterName("count", false, false);
+  _set_split->SetRange("count > 0");
 }
 //----------------------------------------------------------------------------------------------
 
 //__Generate Initial Particles__________________________________________________________________
 void CORSIKAReaderGenerator::GeneratePrimaryVertex(G4Event* event) {
   _last_event.clear();
-  _translation = _random_translation(_config.max_radius);
-  for (std::size_t i{}; i < _event.size(); ++i) {
-    auto particle = _event[i];
+  std::size_t logical_event{}, part{}, parts = 1UL;
+  if (_split > 1UL) {
+    const auto event_id = static_cast<std::size_t>(event->GetEventID());
+    logical_event = event_id / _split;
+    part = event_id % _split;
+    parts = _split;
+    if (_stream) {
+      G4AutoLock lock(&_mutex);
+      _event = _claim_split_shower(_path, _particle, logical_event, _split, _config);
+    }
+    Tracking::SetSubEvent(logical_event, _split, part);
+  } else if (_stream && !NextShower()) {
+    G4RunManager::GetRunManager()->AbortRun(true);
+    return;
+  }
+  if (!_event)
+    return;
+  _translation = _split > 1UL ? _split_translation(logical_event, _config.max_radius)
+                              : _random_translation(_config.max_radius);
+  const double extra[] = {static_cast<double>(_config.event_id),
+                          _translation.first,
+                          _translation.second,
+                          _config.energy,
+                          _config.theta,
+                          _config.phi,
+                          _config.z0,
+                          static_cast<double>(_config.electron_count),
+                          static_cast<double>(_config.muon_count),
+                          static_cast<double>(_config.hadron_count),
+                          static_cast<double>(_config.primary_id.second)};
+  for (std::size_t i{}; i < sizeof(extra) / sizeof(extra[0]); ++i)
+    _extra[i].assign(1UL, extra[i]);
+  const auto& shower = *_event;
+
+  if (_cull) {
+    const auto& extent = Construction::Builder::GetDetectorExtent();
+    shower.select(extent.GetXmin() - _cull_margin + _translation.first,
+                  extent.GetXmax() + _cull_margin + _translation.first,
+                  extent.GetYmin() - _cull_margin + _translation.second,
+                  extent.GetYmax() + _cull_margin + _translation.second,
+                  _selection);
+  } else {
+    _selection.resize(shower.size());
+    std::iota(_selection.begin(), _selection.end(), 0UL);
+  }
+
+  _last_event.reserve(_selection.size() / parts + 1UL);
+  for (std::size_t k = part; k < _selection.size(); k += parts) {
+    auto particle = shower[_selection[k]];
     particle.x -= _translation.first;
     particle.y -= _translation.second;
     if (std::abs(particle.x) >= Construction::WorldLength / 2.0L
         || std::abs(particle.y) >= Construction::WorldLength / 2.0L)
       continue;
     _last_event.push_back(particle);
-    AddParticle(particle, *event);
   }
+  AddParticles(_last_event, *event);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Get Previous Event__________________________________________________________________________
-ParticleVector CORSIKAReaderGenerator::GetLastEvent() const {
+ParticleView CORSIKAReaderGenerator::GetLastEvent() const {
   return _last_event;
 }
 //----------------------------------------------------------------------------------------------
 
+//__Release Showers of Previous Run____________________________________________________________
+// Sub-events skipped by replay, shard or abort never claim their shower, so the master drops
+// the shared showers before the workers start, like Tracking::ClearSubEvents.
+void CORSIKAReaderGenerator::BeginOfRun() {
+  if (G4Threading::IsWorkerThread())
+    return;
+  G4AutoLock lock(&_mutex);
+  _split_showers.clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Buffered Shower Memory______________________________________________________________________
+std::size_t CORSIKAReaderGenerator::BufferBytes() const {
+  constexpr auto entry_bytes = sizeof(int) + 8UL * sizeof(double);
+  auto out = _last_event.capacity() * sizeof(Particle) + _selection.capacity() * sizeof(std::size_t);
+  if (_event)
+    out += _event->size() * entry_bytes;
+  for (const auto& shower : _stream_buffer)
+    out += shower.event.size() * entry_bytes;
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Messenger Set Value_________________________________________________________________________
 void CORSIKAReaderGenerator::SetNewValue(G4UIcommand* command,
                                          G4String value) {
@@ -392,6 +809,16 @@ void CORSIKAReaderGenerator::SetNewValue(G4UIcommand* command,
     _config.event_id = _set_event_id->GetNewIntValue(value);
   } else if (command == _set_max_radius) {
     _config.max_radius = _set_max_radius->GetNewDoubleValue(value);
+  } else if (command == _set_stream) {
+    _stream = _set_stream->GetNewBoolValue(value);
+  } else if (command == _set_read_ahead) {
+    _read_ahead = static_cast<std::size_t>(_set_read_ahead->GetNewIntValue(value));
+  } else if (command == _set_cull) {
+    _cull = _set_cull->GetNewBoolValue(value);
+  } else if (command == _set_cull_margin) {
+    _cull_margin = _set_cull_margin->GetNewDoubleValue(value);
+  } else if (command == _set_split) {
+    _split = static_cast<std::size_t>(_set_split->GetNewIntValue(value));
   } else {
     Generator::SetNewValue(command, value);
   }
@@ -399,13 +826,58 @@ void CORSIKAReaderGenerator::SetNewValue(G4UIcommand* command,
 //----------------------------------------------------------------------------------------------
 
 //__Set Pythia Object from Settings_____________________________________________________________
+// The master never generates events but its specification is written as the run metadata, so
+// it reads the shower configuration too: the shared shower outside of streaming, and only the
+// first shower of the shard otherwise, without moving the shared stream cursor.
 void CORSIKAReaderGenerator::SetFile(const std::string& path) {
   _path = path;
+  G4AutoLock lock(&_mutex);
+  _stream_buffer.clear();
   if (G4Threading::IsWorkerThread()) {
+    if (_stream) {
+      _reset_stream(_path);
+      _event = nullptr;
+    } else {
+      _event = _load_shared_source(_path, _particle, _config);
+    }
+  } else if (_stream) {
+    const auto first = RunAction::ShardRange(_count_showers(_path)).first;
+    std::deque<CORSIKAShower> header;
+    _collect_stream(_path, _particle, _config, first, first + 1UL, header);
+    if (!header.empty()) {
+      const auto max_radius = _config.max_radius;
+      _config = header.front().config;
+      _config.max_radius = max_radius;
+    }
+    _event = nullptr;
+  } else {
+    _event = _load_shared_source(_path, _particle, _config);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load Next Shower in Stream__________________________________________________________________
+bool CORSIKAReaderGenerator::NextShower() {
+  while (_stream_buffer.empty()) {
     G4AutoLock lock(&_mutex);
-    _event.clear();
-    _collect_source(_path, _particle, _config, _event);
+    const auto block = _claim_stream(_read_ahead);
+    if (block.first == block.second)
+      break;
+    _collect_stream(_path, _particle, _config, block.first, block.second, _stream_buffer);
   }
+
+  if (_stream_buffer.empty()) {
+    _event = nullptr;
+    return false;
+  }
+
+  auto& shower = _stream_buffer.front();
+  const auto max_radius = _config.max_radius;
+  _config = shower.config;
+  _config.max_radius = max_radius;
+  _event = std::make_shared<const CORSIKAEvent>(std::move(shower.event));
+  _stream_buffer.pop_front();
+  return true;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -430,26 +902,16 @@ const Analysis::SimSettingList CORSIKAReaderGenerator::GetSpecification() const
     "_AZIMUTH_MAX",      std::to_string(_config.azimuth_max),
     "_ZENITH_MIN",       std::to_string(_config.zenith_min),
     "_ZENITH_MAX",       std::to_string(_config.zenith_max),
-    "_MAX_SHIFT_RADIUS", Units::to_string(_config.max_radius, Units::Length, Units::LengthString)
+    "_MAX_SHIFT_RADIUS", Units::to_string(_config.max_radius, Units::Length, Units::LengthString),
+    "_CULL_MARGIN",      _cull ? Units::to_string(_cull_margin, Units::Length, Units::LengthString) : "OFF",
+    "_SPLIT",            std::to_string(_split)
   );
 }
 //----------------------------------------------------------------------------------------------
 
 //__CORSIKA Reader Generator Extra Details______________________________________________________
-const std::vector<std::vector<double>> CORSIKAReaderGenerator::ExtraDetails() const {
-  auto out = Tracking::EmptyExtra();
-  out[0].push_back(_config.event_id);
-  out[1].push_back(_translation.first);
-  out[2].push_back(_translation.second);
-  out[3].push_back(_config.energy);
-  out[4].push_back(_config.theta);
-  out[5].push_back(_config.phi);
-  out[6].push_back(_config.z0);
-  out[7].push_back(_config.electron_count);
-  out[8].push_back(_config.muon_count);
-  out[9].push_back(_config.hadron_count);
-  out[10].push_back(_config.primary_id.second);
-  return out;
+const std::vector<std::vector<double>>& CORSIKAReaderGenerator::ExtraDetails() const {
+  return _extra;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -4,13 +4,22 @@
 #include "analysis.hh"
 
 #include <Geant4/G4AutoLock.hh>
+#include <Geant4/G4RunManager.hh>
 
 #include <string>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <limits>
 #include <ios>
 #include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace MATHUSLA { namespace MU { namespace Physics {
 
@@ -18,55 +27,159 @@ namespace {
 
 G4Mutex mutex = G4MUTEX_INITIALIZER;
 
+std::unordered_map<std::string, std::weak_ptr<ParticleFile>> open_files;
+
+constexpr std::size_t binary_header_size = sizeof(ParticleFile::Magic) + sizeof(std::uint64_t);
+
+bool is_binary_particle_file(const std::string &pathname) {
+  char magic[sizeof(ParticleFile::Magic)] = {};
+  std::ifstream input_stream(pathname, std::ios::binary);
+  return input_stream.read(magic, sizeof(magic))
+      && std::memcmp(magic, ParticleFile::Magic, sizeof(magic)) == 0;
+}
+
 } // anonymous namespace
 
+const char ParticleFile::Magic[8] = {'M', 'U', 'P', 'A', 'R', 'T', '0', '1'};
+
+ParticleFile::ParticleFile() = default;
+
+ParticleFile::~ParticleFile() {
+  if (_mapping != nullptr) {
+    munmap(_mapping, _mapping_size);
+  }
+}
+
+std::shared_ptr<ParticleFile> ParticleFile::Open(const std::string &pathname) {
+  G4AutoLock lock(mutex);
+  auto &entry = open_files[pathname];
+  if (auto existing = entry.lock()) {
+    return existing;
+  }
+
+  std::shared_ptr<ParticleFile> out(new ParticleFile());
+  if (is_binary_particle_file(pathname)) {
+    const auto descriptor = open(pathname.c_str(), O_RDONLY);
+    struct stat info;
+    if (descriptor < 0 || fstat(descriptor, &info) != 0) {
+      if (descriptor >= 0) {
+        close(descriptor);
+      }
+      throw std::runtime_error("Unable to open particle parameters file");
+    }
+    const auto file_size = static_cast<std::size_t>(info.st_size);
+    auto mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED) {
+      throw std::runtime_error("Unable to map particle parameters file");
+    }
+    out->_mapping = mapping;
+    out->_mapping_size = file_size;
+
+    std::uint64_t count = 0;
+    if (file_size >= binary_header_size) {
+      std::memcpy(&count, static_cast<const char *>(mapping) + sizeof(Magic), sizeof(count));
+    }
+    if (file_size < binary_header_size
+        || (file_size - binary_header_size) / sizeof(ParticleRecord) < count) {
+      throw std::runtime_error("Truncated binary particle parameters file");
+    }
+    out->_records = reinterpret_cast<const ParticleRecord *>(static_cast<const char *>(mapping) + binary_header_size);
+    out->_size = static_cast<std::size_t>(count);
+  } else {
+    out->_owned = ReadParticleTextFile(pathname);
+    out->_records = out->_owned.data();
+    out->_size = out->_owned.size();
+  }
+
+  entry = out;
+  return out;
+}
+
+const Particle ParticleFile::operator[](const std::size_t index) const {
+  const auto &record = _records[index];
+  Particle out{};
+  out.id = static_cast<int>(record.id);
+  out.x = record.x;
+  out.y = record.y;
+  out.z = record.z;
+  out.px = record.px;
+  out.py = record.py;
+  out.pz = record.pz;
+  return out;
+}
+
+std::vector<ParticleRecord> ReadParticleTextFile(const std::string &pathname) {
+  std::vector<ParticleRecord> out;
+  std::ifstream input_stream(pathname);
+  while (input_stream) {
+    const auto next_char = input_stream.peek();
+    if (next_char == std::ifstream::traits_type::eof()) {
+            break;
+    }
+    if (next_char == ' ' || next_char == '\t' || next_char == '\r' || next_char == '\n') {
+            input_stream.ignore();
+            continue;
+    }
+    if (next_char == '#') {
+            input_stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            continue;
+    }
+    out.emplace_back();
+    auto &new_parameters = out.back();
+    if ( ! (input_stream >> new_parameters.id
+                         >> new_parameters.x
+                         >> new_parameters.y
+                         >> new_parameters.z
+                         >> new_parameters.px
+                         >> new_parameters.py
+                         >> new_parameters.pz)) {
+      throw std::runtime_error("Unable to parse particle parameters file");
+    }
+  }
+  if ( ! input_stream) {
+    throw std::runtime_error("Unable to read particle parameters file");
+  }
+  return out;
+}
+
+void WriteParticleBinaryFile(const std::string &pathname, const std::vector<ParticleRecord> &records) {
+  std::ofstream output_stream(pathname, std::ios::binary | std::ios::trunc);
+  const std::uint64_t count = records.size();
+  output_stream.write(ParticleFile::Magic, sizeof(ParticleFile::Magic));
+  output_stream.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  output_stream.write(reinterpret_cast<const char *>(records.data()),
+                      static_cast<std::streamsize>(records.size() * sizeof(ParticleRecord)));
+  if ( ! output_stream) {
+    throw std::runtime_error("Unable to write binary particle parameters file");
+  }
+}
+
 FileReaderGenerator::FileReaderGenerator(const std::string &name,
                                          const std::string &description)
     : Generator(name, description, {}) {
   GenerateCommands();
 }
 
+// Event i of the run reads particle i of the file, so shards, resumed runs and replays see
+// the same particles as the unsharded run whatever the thread that simulates the event.
 void FileReaderGenerator::GeneratePrimaryVertex(G4Event *event) {
-  std::size_t particle_parameters_index = _particle_parameters.size();
-  {
-    G4AutoLock lock(mutex);
-    particle_parameters_index = _event_counter;
-    ++_event_counter;
+  if ( ! _particle_file) {
+    return;
   }
-  AddParticle(_particle_parameters.at(particle_parameters_index), *event);
+  const auto index = static_cast<std::size_t>(event->GetEventID());
+  if (index >= _particle_file->size()) {
+    std::cout << "Particle parameters file exhausted. Ending run.\n";
+    event->SetEventAborted();
+    G4RunManager::GetRunManager()->AbortRun(true);
+    return;
+  }
+  AddParticle((*_particle_file)[index], *event);
 }
 
 void FileReaderGenerator::SetNewValue(G4UIcommand *command, G4String value) {
   if (command == _ui_pathname) {
-    std::ifstream input_stream(value);
-    while (input_stream) {
-      const auto next_char = input_stream.peek();
-      if (next_char == std::ifstream::traits_type::eof()) {
-              break;
-      }
-      if (next_char == ' ' || next_char == '\t' || next_char == '\r' || next_char == '\n') {
-              input_stream.ignore();
-              continue;
-      }
-      if (next_char == '#') {
-              input_stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-              continue;
-      }
-      _particle_parameters.emplace_back();
-      auto &new_parameters = _particle_parameters.back();
-      if ( ! (input_stream >> new_parameters.id
-                           >> new_parameters.x
-                           >> new_parameters.y
-                           >> new_parameters.z
-                           >> new_parameters.px
-                           >> new_parameters.py
-                           >> new_parameters.pz)) {
-        throw std::runtime_error("Unable to parse particle parameters file");
-      }
-    }
-    if ( ! input_stream) {
-      throw std::runtime_error("Unable to read particle parameters file");
-    }
+    _particle_file = ParticleFile::Open(value);
   } else {
     Generator::SetNewValue(command, value);
   }
@@ -174,6 +174,45 @@ bool InPropagationList(const PropagationList& list,
 }
 //----------------------------------------------------------------------------------------------
 
+//__Compile Propagation List into Per-ID Windows________________________________________________
+PropagationFilter::PropagationFilter(const PropagationList& list) {
+  for (const auto& cut : list) {
+    _windows[cut.id].push_back({cut.min, cut.max,
+                                cut.min.pT  || cut.max.pT,
+                                cut.min.eta || cut.max.eta,
+                                cut.min.phi || cut.max.phi});
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Any Cut Exists for ID______________________________________________________________
+bool PropagationFilter::contains(int id) const {
+  return _windows.find(id) != _windows.cend();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Kinematics Pass Any Window for ID__________________________________________________
+bool PropagationFilter::operator()(int id,
+                                   const PseudoLorentzTriplet& triplet) const {
+  const auto search = _windows.find(id);
+  if (search == _windows.cend())
+    return false;
+  for (const auto& window : search->second) {
+    if ((!window.pT  || (window.min.pT  <= triplet.pT  && triplet.pT  <= window.max.pT))
+     && (!window.eta || (window.min.eta <= triplet.eta && triplet.eta <= window.max.eta))
+     && (!window.phi || (window.min.phi <= triplet.phi && triplet.phi <= window.max.phi)))
+      return true;
+  }
+  return false;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Particle Passes Filter_____________________________________________________________
+bool PropagationFilter::operator()(const BasicParticle& particle) const {
+  return contains(particle.id) && (*this)(particle.id, particle.pseudo_lorentz_triplet());
+}
+//----------------------------------------------------------------------------------------------
+
 //__Generator Messenger Directory Path__________________________________________________________
 const std::string Generator::MessengerDirectory = "/gen/";
 //----------------------------------------------------------------------------------------------
@@ -254,6 +293,11 @@ void Generator::GenerateCommands() {
   _ui_vertex->SetParameterName("x0", "y0", "z0", false, false);
   _ui_vertex->SetDefaultUnit("m");
   _ui_vertex->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_weight = CreateCommand<Command::DoubleArg>("weight", "Set Particle Weight.");
+  _ui_weight->SetParameterName("weight", false);
+  _ui_weight->SetRange("weight > 0");
+  _ui_weight->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -264,8 +308,8 @@ void Generator::GeneratePrimaryVertex(G4Event* event) {
 //----------------------------------------------------------------------------------------------
 
 //__Get Last Event Data_________________________________________________________________________
-ParticleVector Generator::GetLastEvent() const {
-  return ParticleVector{_particle};
+ParticleView Generator::GetLastEvent() const {
+  return ParticleView(&_particle, 1UL);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -292,6 +336,8 @@ void Generator::SetNewValue(G4UIcommand* command,
     _particle.t = _ui_t0->GetNewDoubleValue(value);
   } else if (command == _ui_vertex) {
     _particle.set_vertex(_ui_vertex->GetNew3VectorValue(value));
+  } else if (command == _ui_weight) {
+    _particle.weight = _ui_weight->GetNewDoubleValue(value);
   }
 }
 //----------------------------------------------------------------------------------------------
@@ -340,7 +386,7 @@ const Analysis::SimSettingList Generator::GetSpecification() const {
 //----------------------------------------------------------------------------------------------
 
 //__Generator Extra Details_____________________________________________________________________
-const std::vector<std::vector<double>> Generator::ExtraDetails() const {
+const std::vector<std::vector<double>>& Generator::ExtraDetails() const {
   return Tracking::EmptyExtra();
 }
 //----------------------------------------------------------------------------------------------
@@ -18,6 +18,26 @@
 
 #include "physics/HepMCGenerator.hh"
 
+#ifdef MU__WITH_HEPMC3
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <Geant4/G4AutoLock.hh>
+#include <Geant4/G4RunManager.hh>
+#include <Geant4/G4Threading.hh>
+
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/GenParticle.h>
+#include <HepMC3/GenVertex.h>
+#include <HepMC3/ReaderFactory.h>
+
+#include "action.hh"
+#include "geometry/Cavern.hh"
+#include "geometry/Earth.hh"
 #include "physics/Units.hh"
 
 namespace MATHUSLA { namespace MU {
@@ -26,83 +46,243 @@ namespace Physics { ////////////////////////////////////////////////////////////
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
-/* FIXME:
+//__Final State Particles of HepMC Event________________________________________________________
+struct _hepmc_event {
+  int number;
+  ParticleVector particles;
+};
+//----------------------------------------------------------------------------------------------
+
+//__HepMC Event Stream Shared by Worker Threads_________________________________________________
+struct _hepmc_stream {
+  std::string path;
+  std::size_t capacity, claimed;
+  std::deque<_hepmc_event> buffer;
+  std::mutex mutex;
+  std::condition_variable ready, space;
+  bool running, finished;
+  std::thread thread;
+  ~_hepmc_stream();
+};
+std::shared_ptr<_hepmc_stream> _stream;
+G4Mutex _mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Stop Read-Ahead Thread______________________________________________________________________
+_hepmc_stream::~_hepmc_stream() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+  }
+  space.notify_all();
+  if (thread.joinable())
+    thread.join();
+}
+//----------------------------------------------------------------------------------------------
 
-//__Convert HepMC Four Vector to Geant4 ThreeVector_____________________________________________
-const G4ThreeVector _to_G4ThreeVector(const HepMC::FourVector& vector) {
-  return G4ThreeVector(vector.x(), vector.y(), vector.z());
+//__Convert HepMC Particle to Particle in Collision Frame_______________________________________
+Particle _convert_particle(const HepMC3::ConstGenParticlePtr& particle,
+                           const HepMC3::FourVector& event_position) {
+  const auto vertex = particle->production_vertex();
+  const auto& position = vertex ? vertex->position() : event_position;
+  const auto& momentum = particle->momentum();
+  Particle out{particle->pid(),
+               position.t() * mm / c_light,
+               position.x() * mm,
+               position.y() * mm,
+               position.z() * mm};
+  out.set_pseudo_lorentz_triplet(momentum.pt() * GeVperC, momentum.eta(), momentum.phi() * rad);
+  return out;
 }
 //----------------------------------------------------------------------------------------------
 
-//__Add HepMC Particles to Vertex_______________________________________________________________
-void _add_to_vertex(G4PrimaryVertex* vertex,
-                    const PropagationList& propagation,
-                    const std::vector<HepMC::GenParticlePtr>& particles) {
-  for (const auto& particle : particles) {
-    const auto momentum = _to_G4ThreeVector(particle->momentum());
-    // if (InPropagationList(propagation, particle->pid(), momentum)) {
-      vertex->SetPrimary(CreateParticle(particle->pid(), momentum));
-    // }
+//__Read Events of Process Shard Ahead of Workers_______________________________________________
+void _read_stream(_hepmc_stream* stream) {
+  const auto reader = HepMC3::deduce_reader(stream->path);
+  const auto shard_index = RunAction::ShardIndex();
+  const auto shard_count = RunAction::ShardCount();
+  HepMC3::GenEvent event(HepMC3::Units::GEV, HepMC3::Units::MM);
+  for (std::size_t index{}; reader && !reader->failed(); ++index) {
+    if (!reader->read_event(event) || reader->failed())
+      break;
+    if (index % shard_count != shard_index)
+      continue;
+    event.set_units(HepMC3::Units::GEV, HepMC3::Units::MM);
+    _hepmc_event next{event.event_number(), {}};
+    for (const auto& particle : event.particles())
+      if (particle->status() == 1)
+        next.particles.push_back(_convert_particle(particle, event.event_pos()));
+    Cavern::CollisionTransform().apply(next.particles.begin(), next.particles.end());
+
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    stream->space.wait(lock, [&]() { return !stream->running || stream->buffer.size() < stream->capacity; });
+    if (!stream->running)
+      break;
+    stream->buffer.push_back(std::move(next));
+    stream->ready.notify_one();
   }
+  if (reader)
+    reader->close();
+  std::lock_guard<std::mutex> lock(stream->mutex);
+  stream->finished = true;
+  stream->ready.notify_all();
 }
 //----------------------------------------------------------------------------------------------
 
-*/
+//__Open Shared Stream for File_________________________________________________________________
+void _open_stream(const std::string& path,
+                  const std::size_t capacity) {
+  G4AutoLock lock(&_mutex);
+  if (_stream && _stream->path == path) {
+    std::lock_guard<std::mutex> stream_lock(_stream->mutex);
+    if (!_stream->finished)
+      return;
+  }
+  _stream = std::make_shared<_hepmc_stream>();
+  _stream->path = path;
+  _stream->capacity = capacity;
+  _stream->claimed = 0UL;
+  _stream->running = true;
+  _stream->finished = false;
+  _stream->thread = std::thread(_read_stream, _stream.get());
+}
+//----------------------------------------------------------------------------------------------
 
-} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+//__Claim Next Event from Shared Stream_________________________________________________________
+bool _claim_event(_hepmc_event& out) {
+  // hold a reference so a stream reopened by another run outlives this wait
+  std::shared_ptr<_hepmc_stream> stream;
+  {
+    G4AutoLock lock(&_mutex);
+    stream = _stream;
+  }
+  if (!stream)
+    return false;
+  std::unique_lock<std::mutex> lock(stream->mutex);
+  stream->ready.wait(lock, [&]() { return stream->finished || !stream->buffer.empty(); });
+  if (stream->buffer.empty())
+    return false;
+  out = std::move(stream->buffer.front());
+  stream->buffer.pop_front();
+  ++stream->claimed;
+  stream->space.notify_one();
+  return true;
+}
+//----------------------------------------------------------------------------------------------
 
-/*
+//__Count of Claimed Events_____________________________________________________________________
+std::size_t _claimed_events() {
+  G4AutoLock lock(&_mutex);
+  if (!_stream)
+    return 0UL;
+  std::lock_guard<std::mutex> stream_lock(_stream->mutex);
+  return _stream->claimed;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__HepMC Generator Constructor_________________________________________________________________
-HepMCGenerator::HepMCGenerator(const PropagationList& propagation,
-                               bool unique_events)
-    : Generator("hepmc", "HepMC ROOT Reader"),
-      _reader(nullptr), _propagation_list(propagation), _unique(unique_events) {
-  _read_file = CreateCommand<Command::StringArg>("readFile", "Read HepMC ROOT File.");
+HepMCGenerator::HepMCGenerator(const PropagationList& propagation)
+    : Generator("hepmc", "HepMC3 File Reader Generator."), _propagation_list(propagation),
+      _propagation_filter(propagation), _read_ahead(64UL), _event_number(-1) {
+  _read_file = CreateCommand<Command::StringArg>("read_file", "Read HepMC3 File.");
   _read_file->SetParameterName("file", false);
   _read_file->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _set_read_ahead = CreateCommand<Command::IntegerArg>("read_ahead", "Set Number of Events Read Ahead.");
+  _set_read_ahead->SetParameterName("count", false, false);
+  _set_read_ahead->SetRange("count > 0");
+  _set_read_ahead->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _add_cut = CreateCommand<Command::StringArg>("cuts/add", "Add Cut to HepMC Filter");
+  _add_cut->SetParameterName("cut", false);
+  _add_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _clear_cuts = CreateCommand<Command::NoArg>("cuts/clear", "Clear Cuts from HepMC Filter");
+  _clear_cuts->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
-//__Messenger Set Value_________________________________________________________________________
-void HepMCGenerator::SetNewValue(G4UIcommand* command, G4String value) {
-  if (command == _read_file) {
-    if (_reader) {
-      //_reader->close();
-      delete _reader;
-    }
-    _reader = new HepMC::ReaderAscii(value);
+//__Generate Initial Particles__________________________________________________________________
+void HepMCGenerator::GeneratePrimaryVertex(G4Event* event) {
+  _last_event.clear();
+  _hepmc_event next;
+  if (!_claim_event(next)) {
+    G4RunManager::GetRunManager()->AbortRun(true);
+    return;
+  }
+  _event_number = next.number;
+  const auto propagate_all = _propagation_filter.empty();
+  ParticleVector propagate;
+  for (const auto& particle : next.particles) {
+    if (!propagate_all && !_propagation_filter.contains(particle.id))
+      continue;
+    _last_event.push_back(particle);
+    if (propagate_all || _propagation_filter(particle.id, particle.pseudo_lorentz_triplet()))
+      propagate.push_back(particle);
   }
+  AddParticles(propagate, *event);
 }
 //----------------------------------------------------------------------------------------------
 
-//__Generate Primary Verticies__________________________________________________________________
-void HepMCGenerator::GeneratePrimaryVertex(G4Event* event) {
-  if (_reader && !_reader->failed()) {
-    _reader->read_event(_current_event);
-
-    if (_reader->failed())
-      return;
+//__Get Last Event Data_________________________________________________________________________
+ParticleView HepMCGenerator::GetLastEvent() const {
+  return _last_event;
+}
+//----------------------------------------------------------------------------------------------
 
-    for (const auto& vertex : _current_event.vertices()) {
-      auto propagated_vertex = DefaultVertex(); // FIXME: is this correct?
-      _add_to_vertex(propagated_vertex, _propagation_list, vertex->particles_in());
-      _add_to_vertex(propagated_vertex, _propagation_list, vertex->particles_out());
-      if (propagated_vertex->GetNumberOfParticle() != 0)
-        event->AddPrimaryVertex(propagated_vertex);
-    }
+//__Messenger Set Value_________________________________________________________________________
+void HepMCGenerator::SetNewValue(G4UIcommand* command,
+                                 G4String value) {
+  if (command == _read_file) {
+    SetFile(value);
+  } else if (command == _set_read_ahead) {
+    _read_ahead = static_cast<std::size_t>(_set_read_ahead->GetNewIntValue(value));
+  } else if (command == _add_cut) {
+    for (const auto& cut : ParsePropagationList(value))
+      _propagation_list.push_back(cut);
+    _propagation_filter = PropagationFilter(_propagation_list);
+  } else if (command == _clear_cuts) {
+    _propagation_list.clear();
+    _propagation_filter = PropagationFilter();
+  } else {
+    Generator::SetNewValue(command, value);
   }
 }
 //----------------------------------------------------------------------------------------------
 
-//__Get PythiaGenerator Specifications__________________________________________________________
-const Analysis::SimSettingList HepMCGenerator::GetSpecification() const {
-  return {};
+//__Set HepMC3 Input File_______________________________________________________________________
+void HepMCGenerator::SetFile(const std::string& path) {
+  _path = path;
+  _event_number = -1;
+  if (G4Threading::IsWorkerThread())
+    _open_stream(_path, _read_ahead);
 }
 //----------------------------------------------------------------------------------------------
 
-*/
+//__HepMC Generator Specifications______________________________________________________________
+const Analysis::SimSettingList HepMCGenerator::GetSpecification() const {
+  std::vector<std::string> cut_strings;
+  cut_strings.reserve(_propagation_list.size());
+  for (const auto& cut : _propagation_list)
+    cut_strings.push_back(GetParticleCutString(cut));
+
+  auto out = Analysis::Settings(SimSettingPrefix,
+    "",            _name,
+    "_INPUT_FILE", _path,
+    "_READ_AHEAD", std::to_string(_read_ahead));
+  auto cuts = Analysis::IndexedSettings(SimSettingPrefix, "_CUTS_", cut_strings);
+  out.insert(out.cend(),
+             std::make_move_iterator(cuts.begin()),
+             std::make_move_iterator(cuts.end()));
+  out.emplace_back(SimSettingPrefix, "_EVENTS", std::to_string(_claimed_events()));
+  return out;
+}
+//----------------------------------------------------------------------------------------------
 
 } /* namespace Physics */ //////////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
+
+#endif /* MU__WITH_HEPMC3 */
@@ -0,0 +1,208 @@
+/*
+ * src/physics/MixtureGenerator.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/MixtureGenerator.hh"
+
+#include <algorithm>
+
+#include <Geant4/G4Exception.hh>
+
+#include "tracking.hh"
+
+#include "util/random.hh"
+#include "util/string.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Stream Key for Component Selection__________________________________________________________
+constexpr std::uint64_t _selection_key = 0x4D4958ULL;
+//----------------------------------------------------------------------------------------------
+
+//__Uniform Value in [0, 1) from Event Seed_____________________________________________________
+double _seed_uniform(const std::uint64_t seed) {
+  return static_cast<double>(util::random::mix(seed, _selection_key) >> 11) * 0x1.0p-53;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Mixture Generator Constructor_______________________________________________________________
+MixtureGenerator::MixtureGenerator(const GeneratorMap& generators)
+    : Generator("mixture", "Rate-Weighted Mixture of Generators."),
+      _generators(generators), _current(nullptr) {
+  _add = CreateCommand<Command::StringArg>("add", "Add Generator with Relative Rate.");
+  _add->SetParameterName("component", false);
+  _add->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _clear = CreateCommand<Command::NoArg>("clear", "Clear Mixture Components.");
+  _clear->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Generate Initial Particles from Selected Component__________________________________________
+void MixtureGenerator::GeneratePrimaryVertex(G4Event* event) {
+  if (_components.empty())
+    return;
+  if (!_current)
+    _current = _components.front().generator;
+  _current->GeneratePrimaryVertex(event);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Last Event Data_________________________________________________________________________
+ParticleView MixtureGenerator::GetLastEvent() const {
+  return _current ? _current->GetLastEvent() : ParticleView();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Extra Details of Selected Component_____________________________________________________
+const std::vector<std::vector<double>>& MixtureGenerator::ExtraDetails() const {
+  return _current ? _current->ExtraDetails() : Tracking::EmptyExtra();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Buffered Event Memory of Components_________________________________________________________
+std::size_t MixtureGenerator::BufferBytes() const {
+  std::size_t out{};
+  for (auto component = _components.cbegin(); component != _components.cend(); ++component) {
+    const auto generator = component->generator;
+    if (std::none_of(_components.cbegin(), component,
+          [&](const auto& previous) { return previous.generator == generator; }))
+      out += generator->BufferBytes();
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Every Component is Indexed by Event________________________________________________
+bool MixtureGenerator::IsEventIndexed() const {
+  return std::all_of(_components.cbegin(), _components.cend(),
+    [](const auto& component) { return component.generator->IsEventIndexed(); });
+}
+//----------------------------------------------------------------------------------------------
+
+//__Prepare Components for Run__________________________________________________________________
+void MixtureGenerator::BeginOfRun() {
+  for (auto component = _components.cbegin(); component != _components.cend(); ++component) {
+    const auto generator = component->generator;
+    if (std::none_of(_components.cbegin(), component,
+          [&](const auto& previous) { return previous.generator == generator; }))
+      generator->BeginOfRun();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Select Component for Next Event_____________________________________________________________
+void MixtureGenerator::SetEventSeed(std::uint64_t seed) {
+  _current = nullptr;
+  if (_components.empty())
+    return;
+  const auto target = _seed_uniform(seed) * _components.back().cumulative;
+  for (const auto& component : _components) {
+    if (target < component.cumulative) {
+      _current = component.generator;
+      break;
+    }
+  }
+  if (!_current)
+    _current = _components.back().generator;
+  _current->SetEventSeed(seed);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Component to Mixture____________________________________________________________________
+bool MixtureGenerator::AddComponent(const std::string& name,
+                                    const double rate) {
+  const auto search = _generators.find(name);
+  if (search == _generators.end() || search->second == this || !(rate > 0)
+      || search->second->SubEventCount() > 1UL)
+    return false;
+  const auto cumulative = rate + (_components.empty() ? 0 : _components.back().cumulative);
+  _components.push_back({name, search->second, rate, cumulative});
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Clear Mixture Components____________________________________________________________________
+void MixtureGenerator::ClearComponents() {
+  _components.clear();
+  _current = nullptr;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Mixture Generator Messenger Set Value_______________________________________________________
+void MixtureGenerator::SetNewValue(G4UIcommand* command,
+                                   G4String value) {
+  if (command == _add) {
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ");
+    double rate{};
+    try {
+      rate = tokens.size() == 2UL ? std::stod(tokens[1]) : 0.0;
+    } catch (...) {}
+    if (!rate || !AddComponent(tokens[0], rate)) {
+      G4Exception("MixtureGenerator::SetNewValue", "InvalidMixtureComponent", JustWarning,
+        ("Unable to Add Mixture Component \"" + value + "\": Expected \"<generator> <rate>\" "
+         "with a Known Generator other than mixture, a Positive Rate and no Split Showers.").c_str());
+    }
+  } else if (command == _clear) {
+    ClearComponents();
+  } else {
+    Generator::SetNewValue(command, value);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Mixture Generator Information String________________________________________________________
+std::ostream& MixtureGenerator::Print(std::ostream& os) const {
+  os << "Generator Info:\n  "
+     << "Name:        " << _name        << "\n  "
+     << "Description: " << _description << "\n  "
+     << "Components:  " << _components.size() << "\n";
+  const auto total = _components.empty() ? 1 : _components.back().cumulative;
+  for (const auto& component : _components)
+    os << "    " << component.name << ": " << component.rate / total << "\n";
+  return os;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Mixture Generator Specifications____________________________________________________________
+const Analysis::SimSettingList MixtureGenerator::GetSpecification() const {
+  Analysis::SimSettingList out;
+  out.emplace_back(SimSettingPrefix, "", _name);
+  const auto total = _components.empty() ? 1 : _components.back().cumulative;
+  for (std::size_t i{}; i < _components.size(); ++i) {
+    const auto& component = _components[i];
+    const auto prefix = SimSettingPrefix + "_MIXTURE_" + std::to_string(i);
+    out.emplace_back(prefix, "_RATE", std::to_string(component.rate / total));
+    for (const auto& entry : component.generator->GetSpecification()) {
+      const auto matched = entry.name.compare(0, SimSettingPrefix.size(), SimSettingPrefix) == 0;
+      out.emplace_back(prefix, matched ? entry.name.substr(SimSettingPrefix.size()) : "_" + entry.name, entry.text);
+    }
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
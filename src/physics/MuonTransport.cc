@@ -0,0 +1,281 @@
+/* src/physics/MuonTransport.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/MuonTransport.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include <Geant4/G4FastSimulationManager.hh>
+#include <Geant4/G4RegionStore.hh>
+#include <Geant4/Randomize.hh>
+#include <Geant4/tls.hh>
+
+#include "physics/Units.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Table Bins per Axis_________________________________________________________________________
+constexpr std::size_t _bin_count = 16UL;
+//----------------------------------------------------------------------------------------------
+
+//__Thread Local Transport Model________________________________________________________________
+G4ThreadLocal MuonTransportModel* _model = nullptr;
+bool _registered = false;
+//----------------------------------------------------------------------------------------------
+
+//__Clamp Value to Bin Index____________________________________________________________________
+std::size_t _bin_index(const double value,
+                       const double min,
+                       const double width) {
+  const auto index = std::floor((value - min) / width);
+  return index <= 0.0 ? 0UL : std::min(_bin_count - 1UL, static_cast<std::size_t>(index));
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Muon Transport Messenger Directory Path_____________________________________________________
+const std::string MuonTransportModel::MessengerDirectory = "/fast/";
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Model Constructor____________________________________________________________
+MuonTransportModel::MuonTransportModel()
+    : G4VFastSimulationModel("MuonTransport"),
+      G4UImessenger(MessengerDirectory, "Fast Muon Transport Through Rock."),
+      _enabled(false), _bins(_bin_count * _bin_count),
+      _log_energy_min(0), _log_energy_width(1), _depth_min(0), _depth_width(1) {
+  _enable = CreateCommand<Command::BoolArg>("enable", "Use Tabulated Muon Transport in Rock.");
+  _enable->SetParameterName("enable", false);
+  _enable->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _table = CreateCommand<Command::StringArg>("table", "Load Muon Transport Table.");
+  _table->SetParameterName("path", false);
+  _table->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Particle is a Muon_________________________________________________________________
+G4bool MuonTransportModel::IsApplicable(const G4ParticleDefinition& particle) {
+  return std::abs(particle.GetPDGEncoding()) == 13;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Model for Muons Entering or Inside Rock_____________________________________________
+G4bool MuonTransportModel::ModelTrigger(const G4FastTrack& track) {
+  return _enabled && !_samples.empty() && !track.OnTheBoundaryButExiting();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Transport Muon to Rock Exit_________________________________________________________________
+void MuonTransportModel::DoIt(const G4FastTrack& track,
+                              G4FastStep& step) {
+  const auto primary   = track.GetPrimaryTrack();
+  const auto solid     = track.GetEnvelopeSolid();
+  const auto position  = track.GetPrimaryTrackLocalPosition();
+  const auto direction = track.GetPrimaryTrackLocalDirection();
+  const auto energy    = primary->GetKineticEnergy();
+
+  const auto length = solid->DistanceToOut(position, direction);
+  const auto depth = length * primary->GetMaterial()->GetDensity() / (g/cm2);
+  const auto transport = Interpolate(energy, depth);
+
+  step.ProposePrimaryTrackPathLength(length);
+
+  const auto exit_energy = transport.stopped ? 0.0 : energy - transport.loss;
+  if (exit_energy <= 0.0) {
+    step.KillPrimaryTrack();
+    step.ProposeTotalEnergyDeposited(energy);
+    return;
+  }
+
+  auto normal = direction.orthogonal().unit();
+  normal.rotate(twopi * G4UniformRand(), direction);
+
+  auto exit_direction = (std::cos(transport.deflection) * direction + std::sin(transport.deflection) * normal).unit();
+
+  auto exit_position = position + length * direction;
+  const auto displaced = exit_position + transport.displacement * normal;
+  const auto inside = solid->Inside(displaced);
+  if (inside == kSurface) {
+    exit_position = displaced;
+  } else if (inside == kInside) {
+    exit_position = displaced + solid->DistanceToOut(displaced, exit_direction) * exit_direction;
+  } else {
+    // clamp a displacement past the rock back onto its surface along the exit direction
+    const auto distance = solid->DistanceToIn(displaced, -exit_direction);
+    if (distance != kInfinity)
+      exit_position = displaced - distance * exit_direction;
+  }
+  if (solid->SurfaceNormal(exit_position).dot(exit_direction) <= 0.0)
+    exit_direction = direction;
+
+  const auto mass = primary->GetDynamicParticle()->GetMass();
+  const auto beta = std::sqrt(energy * (energy + 2.0 * mass)) / (energy + mass);
+
+  step.ProposePrimaryTrackFinalPosition(exit_position);
+  step.ProposePrimaryTrackFinalMomentumDirection(exit_direction);
+  step.ProposePrimaryTrackFinalKineticEnergy(exit_energy);
+  step.ProposePrimaryTrackFinalTime(primary->GetGlobalTime() + length / (beta * c_light));
+  step.ProposeTotalEnergyDeposited(energy - exit_energy);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Messenger Set New Value______________________________________________________
+void MuonTransportModel::SetNewValue(G4UIcommand* command,
+                                     G4String value) {
+  if (command == _enable) {
+    _enabled = _enable->GetNewBoolValue(value);
+  } else if (command == _table) {
+    if (!Load(value))
+      std::cout << "[ERROR] Unable to Load Muon Transport Table: " << value << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load Muon Transport Table___________________________________________________________________
+bool MuonTransportModel::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file)
+    return false;
+
+  std::vector<Sample> samples;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream stream(line);
+    Sample sample;
+    if (stream >> sample.energy_in >> sample.depth >> sample.energy_out
+               >> sample.displacement >> sample.deflection
+        && sample.energy_in > 0.0 && sample.depth > 0.0)
+      samples.push_back(sample);
+  }
+  if (samples.empty())
+    return false;
+
+  auto log_energy_max = std::log10(samples.front().energy_in);
+  auto depth_max = samples.front().depth;
+  _log_energy_min = log_energy_max;
+  _depth_min = depth_max;
+  for (const auto& sample : samples) {
+    const auto log_energy = std::log10(sample.energy_in);
+    _log_energy_min = std::min(_log_energy_min, log_energy);
+    log_energy_max  = std::max(log_energy_max,  log_energy);
+    _depth_min = std::min(_depth_min, sample.depth);
+    depth_max  = std::max(depth_max,  sample.depth);
+  }
+  _log_energy_width = log_energy_max > _log_energy_min ? (log_energy_max - _log_energy_min) / _bin_count : 1.0;
+  _depth_width = depth_max > _depth_min ? (depth_max - _depth_min) / _bin_count : 1.0;
+
+  std::vector<std::vector<std::size_t>> bins(_bin_count * _bin_count);
+  for (std::size_t index{}; index < samples.size(); ++index) {
+    const auto& sample = samples[index];
+    bins[_bin_index(std::log10(sample.energy_in), _log_energy_min, _log_energy_width) * _bin_count
+         + _bin_index(sample.depth, _depth_min, _depth_width)].push_back(index);
+  }
+
+  _bins = bins;
+  for (std::size_t i{}; i < _bin_count; ++i) {
+    for (std::size_t j{}; j < _bin_count; ++j) {
+      auto& bin = _bins[i * _bin_count + j];
+      if (!bin.empty())
+        continue;
+      auto best = 2UL * _bin_count * _bin_count;
+      for (std::size_t k{}; k < _bin_count; ++k) {
+        for (std::size_t l{}; l < _bin_count; ++l) {
+          const auto& other = bins[k * _bin_count + l];
+          const auto distance = (i > k ? i - k : k - i) * (i > k ? i - k : k - i)
+                              + (j > l ? j - l : l - j) * (j > l ? j - l : l - j);
+          if (!other.empty() && distance < best) {
+            best = distance;
+            bin = other;
+          }
+        }
+      }
+    }
+  }
+
+  _samples = std::move(samples);
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set if Fast Simulation Process is Registered for Muons______________________________________
+void MuonTransportModel::SetRegistered(const bool registered) {
+  _registered = registered;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attach Thread Local Model to Regions________________________________________________________
+void MuonTransportModel::Attach(const std::vector<std::string>& regions) {
+  if (_model || !_registered)
+    return;
+  _model = new MuonTransportModel;
+  for (const auto& name : regions) {
+    const auto region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (!region)
+      continue;
+    auto manager = region->GetFastSimulationManager();
+    if (!manager)
+      manager = new G4FastSimulationManager(region);
+    manager->AddFastSimulationModel(_model);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sample Transport Table______________________________________________________________________
+const MuonTransportModel::Sample& MuonTransportModel::_sample(const std::size_t energy_bin,
+                                                              const double depth) const {
+  const auto& bin = _bins[energy_bin * _bin_count + _bin_index(depth, _depth_min, _depth_width)];
+  const auto index = std::min(bin.size() - 1UL, static_cast<std::size_t>(G4UniformRand() * bin.size()));
+  return _samples[bin[index]];
+}
+//----------------------------------------------------------------------------------------------
+
+//__Interpolate Transport between Neighbouring Energy Bins______________________________________
+// The muon energy falls between the centres of two energy bins. One sample is drawn from the
+// lower bin with probability 1-t or from the upper bin with probability t, so the interpolated
+// distribution keeps the full spread of the table, and only the depth scaling is applied to it.
+MuonTransportModel::Transport MuonTransportModel::Interpolate(const double energy,
+                                                              const double depth) const {
+  const auto position = (std::log10(energy / GeV) - _log_energy_min) / _log_energy_width - 0.5;
+  const auto lower = _bin_index(position, 0.0, 1.0);
+  const auto t = std::max(0.0, std::min(1.0, position - lower));
+  const auto bin = G4UniformRand() < t ? std::min(_bin_count - 1UL, lower + 1UL) : lower;
+
+  const auto& sample = _sample(bin, depth);
+  if (sample.energy_out <= 0.0)
+    return {true, 0.0, 0.0, 0.0};
+
+  const auto scale = depth / sample.depth;
+  return {false,
+          scale * (sample.energy_in - sample.energy_out) * GeV,
+          sample.displacement * std::pow(scale, 1.5) * m,
+          sample.deflection * std::sqrt(scale)};
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
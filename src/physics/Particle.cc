@@ -18,8 +18,14 @@
 
 #include "physics/Particle.hh"
 
+#include <unordered_map>
+#include <vector>
+
+#include <Geant4/G4IonTable.hh>
 #include <Geant4/G4ParticleDefinition.hh>
 #include <Geant4/G4ParticleTable.hh>
+#include <Geant4/G4PrimaryParticle.hh>
+#include <Geant4/G4PrimaryVertex.hh>
 #include <Geant4/G4SystemOfUnits.hh>
 
 #include "geometry/Cavern.hh"
@@ -53,9 +59,42 @@ const G4ThreeVector Convert(const PseudoLorentzTriplet& triplet) {
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
-//__Get Particle Definition from Geant4_________________________________________________________
+//__Find Particle Definition in Geant4 Tables___________________________________________________
+G4ParticleDefinition* _find_particle_def(int id) {
+  const auto table = G4ParticleTable::GetParticleTable();
+  const auto out = table->FindParticle(id);
+  return out || id < 1000000000 ? out : table->GetIonTable()->GetIon(id);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Cached Particle Definitions by PDG__________________________________________________________
+constexpr int _flat_pdg_limit = 4096;
+struct _definition_table {
+  std::vector<G4ParticleDefinition*> flat;
+  std::unordered_map<int, G4ParticleDefinition*> sparse;
+};
+G4ThreadLocal _definition_table* _definitions = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Get Particle Definition from Cache__________________________________________________________
 G4ParticleDefinition* _get_particle_def(int id) {
-  return G4ParticleTable::GetParticleTable()->FindParticle(id);
+  if (!_definitions) {
+    _definitions = new _definition_table;
+    _definitions->flat.assign(2UL * _flat_pdg_limit, nullptr);
+  }
+  if (-_flat_pdg_limit <= id && id < _flat_pdg_limit) {
+    auto& out = _definitions->flat[id + _flat_pdg_limit];
+    if (!out)
+      out = _find_particle_def(id);
+    return out;
+  }
+  const auto search = _definitions->sparse.find(id);
+  if (search != _definitions->sparse.cend())
+    return search->second;
+  const auto out = _find_particle_def(id);
+  if (out)
+    _definitions->sparse.emplace(id, out);
+  return out;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -64,7 +103,20 @@ template<class Function, class Output>
 Output _get_particle_property(int id,
                               Function f,
                               Output default_value={}) {
-  return id == 0 ? default_value : f(_get_particle_def(id));
+  if (id == 0)
+    return default_value;
+  const auto definition = _get_particle_def(id);
+  return definition ? f(definition) : default_value;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Create Primary Particle from Cached Definition______________________________________________
+G4PrimaryParticle* _create_primary(const Particle& particle) {
+  const auto definition = _get_particle_def(particle.id);
+  const auto out = definition ? new G4PrimaryParticle(definition, particle.px, particle.py, particle.pz)
+                              : new G4PrimaryParticle(particle.id, particle.px, particle.py, particle.pz);
+  out->SetWeight(particle.weight);
+  return out;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -280,11 +332,32 @@ void Particle::set_vertex(const G4ThreeVector& vertex) {
 void AddParticle(const Particle& particle,
                  G4Event& event) {
   const auto vertex = new G4PrimaryVertex(particle.x, particle.y, particle.z, particle.t);
-  vertex->SetPrimary(new G4PrimaryParticle(particle.id, particle.px, particle.py, particle.pz));
+  vertex->SetPrimary(_create_primary(particle));
   event.AddPrimaryVertex(vertex);
 }
 //----------------------------------------------------------------------------------------------
 
+//__Add Range of Particles To Event Sharing Vertices____________________________________________
+void AddParticles(const Particle* first,
+                  const Particle* last,
+                  G4Event& event) {
+  while (first != last) {
+    const auto vertex = new G4PrimaryVertex(first->x, first->y, first->z, first->t);
+    const auto& origin = *first;
+    do {
+      vertex->SetPrimary(_create_primary(*first));
+      ++first;
+    } while (first != last && first->t == origin.t
+             && first->x == origin.x && first->y == origin.y && first->z == origin.z);
+    event.AddPrimaryVertex(vertex);
+  }
+}
+void AddParticles(const ParticleVector& particles,
+                  G4Event& event) {
+  AddParticles(particles.data(), particles.data() + particles.size(), event);
+}
+//----------------------------------------------------------------------------------------------
+
 } /* namespace Physics */ //////////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
@@ -18,11 +18,21 @@
 
 #include "physics/PythiaGenerator.hh"
 
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+#include <Geant4/G4AutoLock.hh>
+
 #include <Pythia8/ParticleData.h>
 
 #include "geometry/Earth.hh"
 #include "geometry/Cavern.hh"
 #include "physics/Units.hh"
+#include "util/io.hh"
+#include "util/random.hh"
 #include "util/string.hh"
 
 namespace MATHUSLA { namespace MU {
@@ -38,7 +48,8 @@ G4ThreadLocal bool PythiaGenerator::_settings_on = false;
 //__Pythia Generator Construction_______________________________________________________________
 PythiaGenerator::PythiaGenerator(const PropagationList& propagation,
                                  Pythia8::Pythia* pythia)
-    : Generator("pythia", "Pythia8 Generator."), _propagation_list(propagation) {
+    : Generator("pythia", "Pythia8 Generator."), _propagation_list(propagation),
+      _propagation_filter(propagation), _event_seed(0ULL), _async(false), _queue_size(16UL), _producing(false) {
   _pythia_settings = new std::vector<std::string>();
   SetPythia(pythia);
 
@@ -60,6 +71,19 @@ PythiaGenerator::PythiaGenerator(const PropagationList& propagation,
   _process = CreateCommand<Command::StringArg>("process", "Specify Pythia Process.");
   _process->SetParameterName("process", false);
   _process->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _set_async = CreateCommand<Command::BoolArg>("async", "Generate Pythia Events on Producer Thread.");
+  _set_async->SetParameterName("async", false);
+  _set_async->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _set_queue_size = CreateCommand<Command::IntegerArg>("queue_size", "Set Producer Thread Queue Size.");
+  _set_queue_size->SetParameterName("size", false, false);
+  _set_queue_size->SetRange("size > 0");
+  _set_queue_size->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _set_cache = CreateCommand<Command::StringArg>("cache", "Set Pythia Cross Section Cache Directory.");
+  _set_cache->SetParameterName("dir", false);
+  _set_cache->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -91,12 +115,21 @@ PythiaGenerator::PythiaGenerator(const std::vector<std::string>& settings) : Pyt
 PythiaGenerator::PythiaGenerator(const std::string& path) : PythiaGenerator({}, path) {}
 //----------------------------------------------------------------------------------------------
 
+//__Pythia Generator Destructor_________________________________________________________________
+PythiaGenerator::~PythiaGenerator() {
+  StopProducer();
+  if (!_cache_dir.empty())
+    _store_cross_section(_pythia, _cross_section_path(_cache_dir, _built_settings, _built_path));
+}
+//----------------------------------------------------------------------------------------------
+
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
 //__Setup Pythia Randomness_____________________________________________________________________
 Pythia8::Pythia* _setup_random(Pythia8::Pythia* pythia) {
   pythia->readString("Random:setSeed = on");
-  pythia->readString("Random:seed = 0");
+  pythia->readString("Random:seed = "
+    + std::to_string(1ULL + util::random::mix(util::random::run_seed()) % 900000000ULL));
   return pythia;
 }
 //----------------------------------------------------------------------------------------------
@@ -113,91 +146,184 @@ Pythia8::Pythia* _reconstruct_pythia(Pythia8::Pythia* pythia) {
 }
 //----------------------------------------------------------------------------------------------
 
-//__Create Pythia from Settings_________________________________________________________________
-Pythia8::Pythia* _create_pythia(std::vector<std::string>* settings,
-                                bool& settings_on) {
-  auto pythia = new Pythia8::Pythia();
-  for (const auto& setting : *settings)
-    pythia->readString(setting);
+//__Shared Pythia Settings Snapshots____________________________________________________________
+// Uninitialized Pythia objects holding the settings and particle data of a configuration, so
+// threads skip the XML database and readString replay. Each thread still runs a full init().
+std::unordered_map<std::string, std::unique_ptr<Pythia8::Pythia>> _snapshots;
+G4Mutex _template_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Key of Pythia Configuration_________________________________________________________________
+const std::string _snapshot_key(const std::vector<std::string>& settings,
+                                const std::string& path) {
+  std::string out = path.empty() ? "" : "file: " + path + "\n";
+  for (const auto& setting : settings)
+    out.append(setting).push_back('\n');
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Create Pythia from Shared Settings Snapshot_________________________________________________
+Pythia8::Pythia* _create_pythia(const std::vector<std::string>& settings,
+                                const std::string& path) {
+  G4AutoLock lock(&_template_mutex);
+  auto& base = _snapshots[_snapshot_key(settings, path)];
+  if (!base) {
+    base.reset(new Pythia8::Pythia());
+    if (!path.empty())
+      base->readFile(path);
+    for (const auto& setting : settings)
+      base->readString(setting);
+  }
+  auto pythia = new Pythia8::Pythia(base->settings, base->particleData, false);
+  lock.unlock();
   _setup_random(pythia);
   pythia->init();
-  settings_on = true;
   return pythia;
 }
 //----------------------------------------------------------------------------------------------
 
-//__Convert Pythia Particle to Particle_________________________________________________________
+//__Path of Cached Cross Section________________________________________________________________
+const std::string _cross_section_path(const std::string& dir,
+                                      const std::vector<std::string>& settings,
+                                      const std::string& path) {
+  const auto key = _snapshot_key(settings, path);
+  if (key.empty())
+    return "";
+  std::ostringstream out;
+  out << dir << "/pythia_" << std::hex << std::setw(16) << std::setfill('0')
+      << std::hash<std::string>{}(key) << ".sigma";
+  return out.str();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Cached Cross Section Estimate_______________________________________________________________
+struct _cross_section {
+  double sigma, error;
+  long accepted;
+};
+bool _load_cross_section(const std::string& path,
+                         _cross_section& out) {
+  std::ifstream file(path);
+  return file && (file >> out.sigma >> out.error >> out.accepted);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Store Cross Section Estimate in Cache_______________________________________________________
+void _store_cross_section(Pythia8::Pythia* pythia,
+                          const std::string& path) {
+  if (!pythia || path.empty())
+    return;
+  const _cross_section next{pythia->info.sigmaGen(), pythia->info.sigmaErr(), pythia->info.nAccepted()};
+  if (next.accepted <= 0L)
+    return;
+  G4AutoLock lock(&_template_mutex);
+  _cross_section previous;
+  if (_load_cross_section(path, previous) && previous.accepted >= next.accepted)
+    return;
+  std::ofstream file(path);
+  file << std::setprecision(10) << next.sigma << ' ' << next.error << ' ' << next.accepted << '\n';
+}
+//----------------------------------------------------------------------------------------------
+
+//__Convert Pythia Particle to Particle in Collision Frame______________________________________
 Particle _convert_particle(Pythia8::Particle& particle) {
-  const auto xz = Cavern::rotate_from_P1(particle.zProd() * mm, -particle.xProd() * mm);
   Particle out{particle.id(),
                particle.tProd() * mm / c_light,
-               static_cast<double>(xz.first),
+               particle.xProd() * mm,
                particle.yProd() * mm,
-               static_cast<double>(xz.second + Earth::TotalShift() + Cavern::IP())};
+               particle.zProd() * mm};
   out.set_pseudo_lorentz_triplet(particle.pT() * GeVperC, particle.eta(), particle.phi() * rad);
   return out;
 }
 //----------------------------------------------------------------------------------------------
 
-//__Convert and Pushback Pythia8 Particle if Predicate__________________________________________
-template<class Predicate>
-bool _push_back_convert_if(ParticleVector& out,
-                           Pythia8::Particle& particle,
-                           Predicate predicate) {
-  const auto next = _convert_particle(particle);
-  const auto passed_selection = predicate(next);
-  if (passed_selection)
-    out.push_back(next);
-  return passed_selection;
-}
-//----------------------------------------------------------------------------------------------
-
-//__Convert Pythia Hard and Soft Processes______________________________________________________
-template<class Predicate>
-ParticleVector _convert_pythia_event(Pythia8::Pythia* pythia,
-                                     const std::string& type,
-                                     Predicate predicate) {
+//__Convert and Filter Pythia Hard and Soft Processes___________________________________________
+void _convert_pythia_event(Pythia8::Pythia* pythia,
+                           const std::string& type,
+                           const PropagationFilter& filter,
+                           ParticleVector& last_event,
+                           ParticleVector& propagate,
+                           std::vector<std::size_t>& selected) {
   const auto type_string = util::string::strip(type);
   auto& event = type_string == "hard" ? pythia->process : pythia->event;
   const auto starting_index = type_string == "soft" ? pythia->process.size() : 0;
-  ParticleVector out;
+  last_event.clear();
+  propagate.clear();
+  selected.clear();
   for (int i = starting_index; i < event.size(); ++i) {
-    if (!event[i].isFinal())
+    auto& particle = event[i];
+    if (!particle.isFinal() || !filter.contains(particle.id()))
       continue;
-    _push_back_convert_if(out, event[i], predicate);
+    if (filter(particle.id(), {particle.pT() * GeVperC, particle.eta(), particle.phi() * rad}))
+      selected.push_back(last_event.size());
+    last_event.push_back(_convert_particle(particle));
   }
-  return out;
+  Cavern::CollisionTransform().apply(last_event.begin(), last_event.end());
+  propagate.reserve(selected.size());
+  for (const auto index : selected)
+    propagate.push_back(last_event[index]);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Generate and Filter Next Pythia Event_______________________________________________________
+void _generate_event(Pythia8::Pythia* pythia,
+                     const std::string& process,
+                     const PropagationFilter& filter,
+                     ParticleVector& last_event,
+                     ParticleVector& propagate,
+                     std::vector<std::size_t>& selected) {
+  pythia->next();
+  _convert_pythia_event(pythia, process, filter, last_event, propagate, selected);
 }
 //----------------------------------------------------------------------------------------------
 
+//__Maximum Pythia Trials per Queued Event______________________________________________________
+constexpr std::uint_fast64_t _max_producer_trials = 10000ULL;
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Generate Initial Particles__________________________________________________________________
 void PythiaGenerator::GeneratePrimaryVertex(G4Event* event) {
-  if (!_settings_on && !_pythia_settings->empty()) {
-    _pythia = _create_pythia(_pythia_settings, _settings_on);
-  } else if (!_pythia) {
+  if (!_settings_on && (!_pythia_settings->empty() || !_path.empty())) {
+    if (!_cache_dir.empty())
+      _store_cross_section(_pythia, _cross_section_path(_cache_dir, _built_settings, _built_path));
+    delete _pythia;
+    _pythia = _create_pythia(*_pythia_settings, _path);
+    _built_settings = *_pythia_settings;
+    _built_path = _path;
+    _settings_on = true;
+  }
+  if (!_pythia) {
     std::cout << "\n[ERROR] No Pythia Configuration Specified.\n";
+    return;
   }
 
-  ++_counter;
-  _pythia->next();
-
-  _last_event = _convert_pythia_event(_pythia, _process_string, [&](const auto& next) {
-    for (const auto& entry : _propagation_list)
-      if (next.id == entry.id)
-        return true;
-    return false;
-  });
+  if (_async) {
+    if (!_producing)
+      StartProducer();
+    ProducedEvent next;
+    if (!_queue->pop(next)) {
+      std::cout << "\n[ERROR] Pythia Producer Thread Stopped.\n";
+      return;
+    }
+    _counter += next.trials;
+    _last_event = std::move(next.last_event);
+    AddParticles(next.propagate, *event);
+    return;
+  }
 
-  for (const auto& particle : _last_event)
-    if (InPropagationList(_propagation_list, particle))
-      AddParticle(particle, *event);
+  ++_counter;
+  _pythia->rndm.init(static_cast<int>(1ULL + _event_seed % 900000000ULL));
+  ParticleVector propagate;
+  _generate_event(_pythia, _process_string, _propagation_filter, _last_event, propagate, _selected);
+  AddParticles(propagate, *event);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Get Last Event Data_________________________________________________________________________
-ParticleVector PythiaGenerator::GetLastEvent() const {
+ParticleView PythiaGenerator::GetLastEvent() const {
   return _last_event;
 }
 //----------------------------------------------------------------------------------------------
@@ -205,18 +331,32 @@ ParticleVector PythiaGenerator::GetLastEvent() const {
 //__Messenger Set Value_________________________________________________________________________
 void PythiaGenerator::SetNewValue(G4UIcommand* command,
                                   G4String value) {
+  if (command == _read_string || command == _read_file || command == _add_cut
+      || command == _clear_cuts || command == _process
+      || command == _set_async || command == _set_queue_size)
+    StopProducer();
+
   if (command == _read_string) {
     _pythia_settings->push_back(value);
-    _settings_on = true;
+    _settings_on = false;
   } else if (command == _read_file) {
     SetPythia(value);
   } else if (command == _add_cut) {
     for (const auto& cut : ParsePropagationList(value))
       _propagation_list.push_back(cut);
+    _propagation_filter = PropagationFilter(_propagation_list);
   } else if (command == _clear_cuts) {
     _propagation_list.clear();
+    _propagation_filter = PropagationFilter();
   } else if (command == _process) {
     _process_string = value;
+  } else if (command == _set_async) {
+    _async = _set_async->GetNewBoolValue(value);
+  } else if (command == _set_queue_size) {
+    _queue_size = static_cast<std::size_t>(_set_queue_size->GetNewIntValue(value));
+  } else if (command == _set_cache) {
+    _cache_dir = value;
+    util::io::create_directory(_cache_dir);
   } else {
     Generator::SetNewValue(command, value);
   }
@@ -227,9 +367,14 @@ void PythiaGenerator::SetNewValue(G4UIcommand* command,
 void PythiaGenerator::SetPythia(Pythia8::Pythia* pythia) {
   if (!pythia)
     return;
+  StopProducer();
   _counter = 0ULL;
   _pythia_settings->clear();
-  _settings_on = false;
+  _path.clear();
+  _built_settings.clear();
+  _built_path.clear();
+  _settings_on = true;
+  delete _pythia;
   _pythia = _reconstruct_pythia(pythia);
   _pythia->init();
 }
@@ -237,22 +382,73 @@ void PythiaGenerator::SetPythia(Pythia8::Pythia* pythia) {
 
 //__Set Pythia Object from Settings_____________________________________________________________
 void PythiaGenerator::SetPythia(const std::vector<std::string>& settings) {
+  StopProducer();
   *_pythia_settings = settings;
   _counter = 0ULL;
-  _pythia = _create_pythia(_pythia_settings, _settings_on);
+  _path.clear();
+  _settings_on = false;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Set Pythia Object from Settings_____________________________________________________________
 void PythiaGenerator::SetPythia(const std::string& path) {
+  StopProducer();
   _counter = 0ULL;
   _pythia_settings->clear();
   _settings_on = false;
   _path = path;
-  _pythia = new Pythia8::Pythia();
-  _pythia->readFile(_path);
-  _setup_random(_pythia);
-  _pythia->init();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Pythia Seed for Next Event______________________________________________________________
+void PythiaGenerator::SetEventSeed(std::uint64_t seed) {
+  _event_seed = seed;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Start Pythia Producer Thread________________________________________________________________
+void PythiaGenerator::StartProducer() {
+  StopProducer();
+  if (!_pythia)
+    return;
+
+  _queue.reset(new util::queue::blocking<ProducedEvent>(_queue_size));
+  _producing = true;
+
+  const auto pythia = _pythia;
+  const auto process = _process_string;
+  const auto filter = _propagation_filter;
+  const auto queue = _queue.get();
+  const auto producing = &_producing;
+  _producer = std::thread([=]() {
+    try {
+      ProducedEvent next{};
+      std::vector<std::size_t> selected;
+      while (producing->load(std::memory_order_acquire)) {
+        ++next.trials;
+        _generate_event(pythia, process, filter, next.last_event, next.propagate, selected);
+        if (next.propagate.empty() && next.trials < _max_producer_trials)
+          continue;
+        if (!queue->push(std::move(next)))
+          return;
+        next = ProducedEvent{};
+      }
+    } catch (...) {
+      // the consumer rethrows the error once it has drained the queue
+      queue->close(std::current_exception());
+    }
+  });
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stop Pythia Producer Thread_________________________________________________________________
+void PythiaGenerator::StopProducer() {
+  _producing = false;
+  if (_queue)
+    _queue->close();
+  if (_producer.joinable())
+    _producer.join();
+  _queue.reset();
 }
 //----------------------------------------------------------------------------------------------
 
@@ -267,6 +463,13 @@ const Analysis::SimSettingList PythiaGenerator::GetSpecification() const {
 
   config.emplace_back(SimSettingPrefix, "_PROCESS", _process_string);
 
+  _cross_section sigma;
+  if (!_cache_dir.empty()
+      && _load_cross_section(_cross_section_path(_cache_dir, *_pythia_settings, _path), sigma)) {
+    config.emplace_back(SimSettingPrefix, "_SIGMA", std::to_string(sigma.sigma) + " mb");
+    config.emplace_back(SimSettingPrefix, "_SIGMA_ERROR", std::to_string(sigma.error) + " mb");
+  }
+
   Analysis::SimSettingList out;
   out.reserve(2UL + config.size() + _propagation_list.size());
   out.emplace_back(SimSettingPrefix, "", _name);
@@ -18,6 +18,7 @@
 
 #include "physics/Generator.hh"
 
+#include <algorithm>
 #include <ostream>
 
 #include <Geant4/Randomize.hh>
@@ -43,11 +44,43 @@ RangeGenerator::RangeGenerator(const std::string& name,
                                const std::string& description,
                                const Particle& min,
                                const Particle& max)
-    : Generator(name, description, min), _min(min), _max(max) {
+    : Generator(name, description, min), _min(min), _max(max), _bias_fraction(0),
+      _pT_bias({0, 0, false}), _eta_bias({0, 0, false}), _phi_bias({0, 0, false}), _ke_bias({0, 0, false}) {
   GenerateCommands();
 }
 //----------------------------------------------------------------------------------------------
 
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Sample Uniform Range with Optional Bias Window______________________________________________
+template<class Window>
+double _sample_biased(const double min,
+                      const double max,
+                      const Window& window,
+                      const double fraction,
+                      double& weight) {
+  const auto low  = std::min(min, max);
+  const auto high = std::max(min, max);
+  const auto window_low  = std::max(low,  std::min(window.min, window.max));
+  const auto window_high = std::min(high, std::max(window.min, window.max));
+
+  if (!window.on || fraction <= 0 || high <= low || window_high <= window_low)
+    return G4RandFlat::shoot(min, max);
+
+  const auto x = G4RandFlat::shoot() < fraction ? G4RandFlat::shoot(window_low, window_high)
+                                                : G4RandFlat::shoot(low, high);
+
+  const auto flat_density = 1.0 / (high - low);
+  auto biased_density = (1.0 - fraction) * flat_density;
+  if (window_low <= x && x <= window_high)
+    biased_density += fraction / (window_high - window_low);
+  weight *= flat_density / biased_density;
+  return x;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
 //__Generate UI Commands________________________________________________________________________
 void RangeGenerator::GenerateCommands() {
   _ui_pT_min = CreateCommand<Command::DoubleUnitArg>("pT_min", "Set Minimum Transverse Momentum.");
@@ -97,26 +130,83 @@ void RangeGenerator::GenerateCommands() {
   _ui_ke_max->SetDefaultUnit("GeV");
   _ui_ke_max->SetUnitCandidates("eV keV MeV GeV");
   _ui_ke_max->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_bias_fraction = CreateCommand<Command::DoubleArg>("bias_fraction", "Set Fraction of Events Sampled in Bias Windows.");
+  _ui_bias_fraction->SetParameterName("fraction", false);
+  _ui_bias_fraction->SetRange("fraction >= 0 && fraction <= 1");
+  _ui_bias_fraction->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_pT_bias_min = CreateCommand<Command::DoubleUnitArg>("pT_bias_min", "Set Minimum Biased Transverse Momentum.");
+  _ui_pT_bias_min->SetParameterName("pT_bias_min", false, false);
+  _ui_pT_bias_min->SetRange("pT_bias_min >= 0");
+  _ui_pT_bias_min->SetDefaultUnit("GeV/c");
+  _ui_pT_bias_min->SetUnitCandidates("eV/c keV/c MeV/c GeV/c");
+  _ui_pT_bias_min->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_pT_bias_max = CreateCommand<Command::DoubleUnitArg>("pT_bias_max", "Set Maximum Biased Transverse Momentum.");
+  _ui_pT_bias_max->SetParameterName("pT_bias_max", false, false);
+  _ui_pT_bias_max->SetRange("pT_bias_max >= 0");
+  _ui_pT_bias_max->SetDefaultUnit("GeV/c");
+  _ui_pT_bias_max->SetUnitCandidates("eV/c keV/c MeV/c GeV/c");
+  _ui_pT_bias_max->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_eta_bias_min = CreateCommand<Command::DoubleArg>("eta_bias_min", "Set Minimum Biased Pseudorapidity.");
+  _ui_eta_bias_min->SetParameterName("eta_bias_min", false);
+  _ui_eta_bias_min->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_eta_bias_max = CreateCommand<Command::DoubleArg>("eta_bias_max", "Set Maximum Biased Pseudorapidity.");
+  _ui_eta_bias_max->SetParameterName("eta_bias_max", false);
+  _ui_eta_bias_max->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_phi_bias_min = CreateCommand<Command::DoubleUnitArg>("phi_bias_min", "Set Minimum Biased Semi-Opening Angle.");
+  _ui_phi_bias_min->SetParameterName("phi_bias_min", false, false);
+  _ui_phi_bias_min->SetDefaultUnit("deg");
+  _ui_phi_bias_min->SetUnitCandidates("degree deg radian rad milliradian mrad");
+  _ui_phi_bias_min->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_phi_bias_max = CreateCommand<Command::DoubleUnitArg>("phi_bias_max", "Set Maximum Biased Semi-Opening Angle.");
+  _ui_phi_bias_max->SetParameterName("phi_bias_max", false, false);
+  _ui_phi_bias_max->SetDefaultUnit("deg");
+  _ui_phi_bias_max->SetUnitCandidates("degree deg radian rad milliradian mrad");
+  _ui_phi_bias_max->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_ke_bias_min = CreateCommand<Command::DoubleUnitArg>("ke_bias_min", "Set Minimum Biased Kinetic Energy.");
+  _ui_ke_bias_min->SetParameterName("ke_bias_min", false, false);
+  _ui_ke_bias_min->SetRange("ke_bias_min >= 0");
+  _ui_ke_bias_min->SetDefaultUnit("GeV");
+  _ui_ke_bias_min->SetUnitCandidates("eV keV MeV GeV");
+  _ui_ke_bias_min->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_ke_bias_max = CreateCommand<Command::DoubleUnitArg>("ke_bias_max", "Set Maximum Biased Kinetic Energy.");
+  _ui_ke_bias_max->SetParameterName("ke_bias_max", false, false);
+  _ui_ke_bias_max->SetRange("ke_bias_max >= 0");
+  _ui_ke_bias_max->SetDefaultUnit("GeV");
+  _ui_ke_bias_max->SetUnitCandidates("eV keV MeV GeV");
+  _ui_ke_bias_max->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Generate Initial Particles__________________________________________________________________
 void RangeGenerator::GeneratePrimaryVertex(G4Event* event) {
-  const auto eta = G4RandFlat::shoot(_min.eta(), _max.eta());
-  const auto phi = G4RandFlat::shoot(_min.phi(), _max.phi());
+  double weight = 1.0;
+  const auto eta = _sample_biased(_min.eta(), _max.eta(), _eta_bias, _bias_fraction, weight);
+  const auto phi = _sample_biased(_min.phi(), _max.phi(), _phi_bias, _bias_fraction, weight);
   if (_using_range_ke) {
     _particle.set_pseudo_lorentz_triplet(1, eta, phi);
-    _particle.set_ke(G4RandFlat::shoot(_min.ke(), _max.ke()));
+    _particle.set_ke(_sample_biased(_min.ke(), _max.ke(), _ke_bias, _bias_fraction, weight));
   } else {
-    _particle.set_pseudo_lorentz_triplet(G4RandFlat::shoot(_min.pT(), _max.pT()), eta, phi);
+    _particle.set_pseudo_lorentz_triplet(
+      _sample_biased(_min.pT(), _max.pT(), _pT_bias, _bias_fraction, weight), eta, phi);
   }
-  AddParticle(_particle, *event);
+  auto particle = _particle;
+  particle.weight *= weight;
+  AddParticle(particle, *event);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Get Last Event Data_________________________________________________________________________
-ParticleVector RangeGenerator::GetLastEvent() const {
-  return ParticleVector{};
+ParticleView RangeGenerator::GetLastEvent() const {
+  return ParticleView();
 }
 //----------------------------------------------------------------------------------------------
 
@@ -180,6 +270,32 @@ void RangeGenerator::SetNewValue(G4UIcommand* command,
     _min.set_p_mag(magnitude);
     _max.set_p_mag(magnitude);
     _using_range_ke = true;
+  } else if (command == _ui_bias_fraction) {
+    _bias_fraction = _ui_bias_fraction->GetNewDoubleValue(value);
+  } else if (command == _ui_pT_bias_min) {
+    _pT_bias.min = _ui_pT_bias_min->GetNewDoubleValue(value);
+    _pT_bias.on = true;
+  } else if (command == _ui_pT_bias_max) {
+    _pT_bias.max = _ui_pT_bias_max->GetNewDoubleValue(value);
+    _pT_bias.on = true;
+  } else if (command == _ui_eta_bias_min) {
+    _eta_bias.min = _ui_eta_bias_min->GetNewDoubleValue(value);
+    _eta_bias.on = true;
+  } else if (command == _ui_eta_bias_max) {
+    _eta_bias.max = _ui_eta_bias_max->GetNewDoubleValue(value);
+    _eta_bias.on = true;
+  } else if (command == _ui_phi_bias_min) {
+    _phi_bias.min = _ui_phi_bias_min->GetNewDoubleValue(value);
+    _phi_bias.on = true;
+  } else if (command == _ui_phi_bias_max) {
+    _phi_bias.max = _ui_phi_bias_max->GetNewDoubleValue(value);
+    _phi_bias.on = true;
+  } else if (command == _ui_ke_bias_min) {
+    _ke_bias.min = _ui_ke_bias_min->GetNewDoubleValue(value);
+    _ke_bias.on = true;
+  } else if (command == _ui_ke_bias_max) {
+    _ke_bias.max = _ui_ke_bias_max->GetNewDoubleValue(value);
+    _ke_bias.on = true;
   } else {
     Generator::SetNewValue(command, value);
   }
@@ -219,7 +335,7 @@ std::ostream& RangeGenerator::Print(std::ostream& os) const {
 
 //__RangeGenerator Specifications_______________________________________________________________
 const Analysis::SimSettingList RangeGenerator::GetSpecification() const {
-  return Analysis::Settings(SimSettingPrefix,
+  auto out = Analysis::Settings(SimSettingPrefix,
     "",         _name,
     "_PDG_ID",  std::to_string(_particle.id),
     (_using_range_ke ? "_KE_MIN" : "_PT_MIN"),
@@ -238,6 +354,26 @@ const Analysis::SimSettingList RangeGenerator::GetSpecification() const {
                    + std::to_string(_particle.x / Units::Length) + ", "
                    + std::to_string(_particle.y / Units::Length) + ", "
                    + std::to_string(_particle.z / Units::Length) + ")");
+
+  if (_bias_fraction > 0) {
+    out.emplace_back(SimSettingPrefix, "_BIAS_FRACTION", std::to_string(_bias_fraction));
+    if (_pT_bias.on && !_using_range_ke)
+      out.emplace_back(SimSettingPrefix, "_PT_BIAS",
+        std::to_string(_pT_bias.min / Units::Momentum) + ":"
+          + std::to_string(_pT_bias.max / Units::Momentum) + " " + Units::MomentumString);
+    if (_ke_bias.on && _using_range_ke)
+      out.emplace_back(SimSettingPrefix, "_KE_BIAS",
+        std::to_string(_ke_bias.min / Units::Energy) + ":"
+          + std::to_string(_ke_bias.max / Units::Energy) + " " + Units::EnergyString);
+    if (_eta_bias.on)
+      out.emplace_back(SimSettingPrefix, "_ETA_BIAS",
+        std::to_string(_eta_bias.min) + ":" + std::to_string(_eta_bias.max));
+    if (_phi_bias.on)
+      out.emplace_back(SimSettingPrefix, "_PHI_BIAS",
+        std::to_string(_phi_bias.min / Units::Angle) + ":"
+          + std::to_string(_phi_bias.max / Units::Angle) + " " + Units::AngleString);
+  }
+  return out;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -0,0 +1,378 @@
+/*
+ * src/reader.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reader.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <TBranch.h>
+#include <TClass.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TNamed.h>
+#include <TROOT.h>
+#include <TTree.h>
+
+namespace MATHUSLA { namespace MU {
+
+namespace Reader { /////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Trees which are not Detector Data___________________________________________________________
+const std::vector<std::string> _auxiliary_trees{"metadata", "runs"};
+//----------------------------------------------------------------------------------------------
+
+//__TTree Cache Size____________________________________________________________________________
+long long _cache_size = 32LL * 1024LL * 1024LL;
+//----------------------------------------------------------------------------------------------
+
+//__Branch Addresses for Current File___________________________________________________________
+struct _binding {
+  std::vector<double> real;
+  std::vector<float> real_float;
+  std::vector<int> integer;
+  std::vector<std::vector<float>> float_vector;
+  std::vector<std::vector<double>*> real_address;
+  std::vector<std::vector<float>*> float_address;
+  std::vector<std::vector<int>*> integer_address;
+
+  explicit _binding(const std::size_t size)
+      : real(size), real_float(size), integer(size), float_vector(size),
+        real_address(size, nullptr), float_address(size, nullptr), integer_address(size, nullptr) {}
+};
+//----------------------------------------------------------------------------------------------
+
+//__Check if Path is a Directory________________________________________________________________
+bool _is_directory(const std::string& path) {
+  struct stat info;
+  return !stat(path.c_str(), &info) && S_ISDIR(info.st_mode);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Recursive Directory Traversal_______________________________________________________________
+void _collect_paths(const std::string& directory,
+                    const std::string& extension,
+                    std::vector<std::string>& paths) {
+  const auto dir = opendir(directory.c_str());
+  if (!dir)
+    return;
+  while (const auto entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name == "." || name == "..")
+      continue;
+    const auto path = directory + "/" + name;
+    if (_is_directory(path)) {
+      _collect_paths(path, extension, paths);
+    } else if (extension.empty() || name.substr(1UL + name.find_last_of('.')) == extension) {
+      paths.push_back(path);
+    }
+  }
+  closedir(dir);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Column Type of Branch_______________________________________________________________________
+ColumnType _column_type(TBranch* branch) {
+  TClass* type_class = nullptr;
+  EDataType type = kOther_t;
+  if (branch->GetExpectedType(type_class, type))
+    return ColumnType::Unknown;
+  if (type_class) {
+    const std::string name = type_class->GetName();
+    return name == "vector<double>" ? ColumnType::RealVector
+         : name == "vector<float>"  ? ColumnType::FloatVector
+         : name == "vector<int>"    ? ColumnType::IntegerVector
+                                    : ColumnType::Unknown;
+  }
+  switch (type) {
+    case kDouble_t: return ColumnType::Real;
+    case kFloat_t:  return ColumnType::Float;
+    case kInt_t:    return ColumnType::Integer;
+    default:        return ColumnType::Unknown;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Read Column Types of Open Tree______________________________________________________________
+Schema _read_schema(TTree* tree) {
+  Schema out;
+  for (const auto object : *tree->GetListOfBranches()) {
+    const auto branch = static_cast<TBranch*>(object);
+    out.push_back({branch->GetName(), _column_type(branch)});
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Bind Requested Columns to Row_______________________________________________________________
+void _bind_columns(TTree* tree,
+                   const std::vector<std::string>& columns,
+                   Row& row,
+                   _binding& binding) {
+  tree->SetBranchStatus("*", false);
+  tree->SetCacheSize(_cache_size);
+  for (std::size_t i{}; i < columns.size(); ++i) {
+    const auto name = columns[i].c_str();
+    const auto branch = tree->GetBranch(name);
+    const auto type = branch ? _column_type(branch) : ColumnType::Unknown;
+    row.schema.push_back({columns[i], type});
+    if (type == ColumnType::Unknown)
+      continue;
+    tree->SetBranchStatus(name, true);
+    tree->AddBranchToCache(branch, true);
+    switch (type) {
+      case ColumnType::Real:
+        tree->SetBranchAddress(name, &binding.real[i]);
+        break;
+      case ColumnType::Float:
+        tree->SetBranchAddress(name, &binding.real_float[i]);
+        break;
+      case ColumnType::Integer:
+        tree->SetBranchAddress(name, &binding.integer[i]);
+        break;
+      case ColumnType::RealVector:
+        binding.real_address[i] = &row.reals[i];
+        tree->SetBranchAddress(name, &binding.real_address[i]);
+        break;
+      case ColumnType::FloatVector:
+        binding.float_address[i] = &binding.float_vector[i];
+        tree->SetBranchAddress(name, &binding.float_address[i]);
+        break;
+      case ColumnType::IntegerVector:
+        binding.integer_address[i] = &row.integers[i];
+        tree->SetBranchAddress(name, &binding.integer_address[i]);
+        break;
+      default:
+        break;
+    }
+  }
+  tree->StopCacheLearningPhase();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Copy Scalar and Single Precision Columns into Row___________________________________________
+void _unpack_columns(const _binding& binding,
+                     Row& row) {
+  for (std::size_t i{}; i < row.schema.size(); ++i) {
+    switch (row.schema[i].type) {
+      case ColumnType::Real:    row.real[i] = binding.real[i];       break;
+      case ColumnType::Float:   row.real[i] = binding.real_float[i]; break;
+      case ColumnType::Integer: row.real[i] = binding.integer[i];    break;
+      case ColumnType::FloatVector:
+        row.reals[i].assign(binding.float_vector[i].cbegin(), binding.float_vector[i].cend());
+        break;
+      default:
+        break;
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Traverse Tree Entries of One File___________________________________________________________
+std::size_t _read_file(const std::string& path,
+                       const std::size_t file_index,
+                       const std::string& tree_name,
+                       const std::vector<std::string>& columns,
+                       const std::size_t worker,
+                       const RowFunction& function) {
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+  if (!file || file->IsZombie()) {
+    std::cerr << "[WARNING] Unable to Read File: " << path << "\n";
+    return 0UL;
+  }
+  const auto name = tree_name.empty() ? DefaultTree(path) : tree_name;
+  const auto tree = dynamic_cast<TTree*>(file->Get(name.c_str()));
+  if (!tree)
+    return 0UL;
+
+  std::vector<std::string> selected = columns;
+  if (selected.empty())
+    for (const auto& column : _read_schema(tree))
+      selected.push_back(column.name);
+
+  const auto size = selected.size();
+  Row row;
+  row.real.assign(size, 0.0);
+  row.reals.resize(size);
+  row.integers.resize(size);
+  row.path = path;
+  row.file = file_index;
+  row.worker = worker;
+  _binding binding(size);
+  _bind_columns(tree, selected, row, binding);
+
+  const auto entries = tree->GetEntries();
+  std::size_t out{};
+  for (long long entry{}; entry < entries; ++entry) {
+    if (tree->GetEntry(entry) < 0)
+      continue;
+    row.entry = entry;
+    _unpack_columns(binding, row);
+    function(row);
+    ++out;
+  }
+  tree->ResetBranchAddresses();
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Find Column Index in Row____________________________________________________________________
+std::size_t Row::Index(const std::string& name) const {
+  for (std::size_t i{}; i < schema.size(); ++i)
+    if (schema[i].name == name)
+      return i;
+  return npos;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Number of Values in Column__________________________________________________________________
+std::size_t Row::Size(const std::size_t column) const {
+  switch (schema[column].type) {
+    case ColumnType::RealVector:
+    case ColumnType::FloatVector:   return reals[column].size();
+    case ColumnType::IntegerVector: return integers[column].size();
+    case ColumnType::Unknown:       return 0UL;
+    default:                        return 1UL;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Collect Simulation Files under Path_________________________________________________________
+std::vector<std::string> FindFiles(const std::string& path,
+                                   const std::string& extension) {
+  std::vector<std::string> out;
+  if (!_is_directory(path)) {
+    out.push_back(path);
+    return out;
+  }
+  _collect_paths(path, extension, out);
+  std::sort(out.begin(), out.end());
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Name of First Detector Tree in File_________________________________________________________
+const std::string DefaultTree(const std::string& path) {
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+  if (!file || file->IsZombie())
+    return "";
+  for (const auto object : *file->GetListOfKeys()) {
+    const auto key = static_cast<TKey*>(object);
+    const std::string name = key->GetName();
+    if (std::string(key->GetClassName()) == "TTree"
+        && std::find(_auxiliary_trees.cbegin(), _auxiliary_trees.cend(), name) == _auxiliary_trees.cend())
+      return name;
+  }
+  return "";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Read Column Types of Tree___________________________________________________________________
+Schema ReadSchema(const std::string& path,
+                  const std::string& tree) {
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+  if (!file || file->IsZombie())
+    return {};
+  const auto name = tree.empty() ? DefaultTree(path) : tree;
+  const auto data = dynamic_cast<TTree*>(file->Get(name.c_str()));
+  return data ? _read_schema(data) : Schema{};
+}
+//----------------------------------------------------------------------------------------------
+
+//__Read Simulation Metadata____________________________________________________________________
+Metadata ReadMetadata(const std::string& path) {
+  Metadata out;
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+  if (!file || file->IsZombie())
+    return out;
+  for (const auto object : *file->GetListOfKeys()) {
+    const auto key = static_cast<TKey*>(object);
+    if (std::string(key->GetClassName()) != "TNamed")
+      continue;
+    const auto entry = dynamic_cast<TNamed*>(key->ReadObj());
+    if (entry)
+      out.emplace_back(entry->GetName(), entry->GetTitle());
+    delete entry;
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__TTree Cache Size in Bytes___________________________________________________________________
+void SetCacheSize(const long long bytes) {
+  _cache_size = std::max(0LL, bytes);
+}
+long long GetCacheSize() {
+  return _cache_size;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Traverse Tree Entries of Files in Parallel__________________________________________________
+std::size_t Traverse(const std::vector<std::string>& paths,
+                     const std::string& tree,
+                     const std::vector<std::string>& columns,
+                     const RowFunction& function,
+                     const std::size_t threads) {
+  const auto count = std::max(1UL, std::min(threads, paths.size()));
+  std::atomic<std::size_t> next{0UL}, total{0UL};
+  const auto work = [&](const std::size_t worker) {
+    for (auto index = next++; index < paths.size(); index = next++)
+      total += _read_file(paths[index], index, tree, columns, worker, function);
+  };
+
+  if (count == 1UL) {
+    work(0UL);
+  } else {
+    ROOT::EnableThreadSafety();
+    std::vector<std::thread> workers;
+    for (std::size_t i{}; i < count; ++i)
+      workers.emplace_back(work, i);
+    for (auto& worker : workers)
+      worker.join();
+  }
+  return total;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Column Type Name____________________________________________________________________________
+const std::string TypeName(const ColumnType type) {
+  switch (type) {
+    case ColumnType::Real:          return "double";
+    case ColumnType::Float:         return "float";
+    case ColumnType::Integer:       return "int";
+    case ColumnType::RealVector:    return "vector<double>";
+    case ColumnType::FloatVector:   return "vector<float>";
+    case ColumnType::IntegerVector: return "vector<int>";
+    default:                        return "unknown";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Reader */ ///////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
@@ -15,21 +15,40 @@
  * limitations under the License.
  */
 
+#include <limits>
+
 #include <Geant4/G4MTRunManager.hh>
+#include <Geant4/G4Threading.hh>
+#include <Geant4/G4Version.hh>
+#if G4VERSION_NUMBER >= 1070
+#include <Geant4/G4TaskRunManager.hh>
+#endif
 #include <Geant4/FTFP_BERT.hh>
+#include <Geant4/G4DecayPhysics.hh>
+#include <Geant4/G4EmParameters.hh>
+#include <Geant4/G4EmStandardPhysics.hh>
+#include <Geant4/G4FastSimulationPhysics.hh>
+#include <Geant4/G4PhysListFactory.hh>
 #include <Geant4/G4StepLimiterPhysics.hh>
 #include <Geant4/G4UIExecutive.hh>
+#include <Geant4/G4VModularPhysicsList.hh>
+#ifdef MU__WITH_VIS
 #include <Geant4/G4VisExecutive.hh>
+#endif
 #include <Geant4/tls.hh>
 
 #include "action.hh"
+#include "analysis.hh"
 #include "geometry/Construction.hh"
 #include "geometry/Earth.hh"
+#include "physics/MuonTransport.hh"
 #include "physics/Units.hh"
 #include "ui.hh"
 
 #include "util/command_line_parser.hh"
 #include "util/error.hh"
+#include "util/random.hh"
+#include "util/string.hh"
 
 //__Main Function: Simulation___________________________________________________________________
 int main(int argc, char* argv[]) {
@@ -42,22 +61,31 @@ int main(int argc, char* argv[]) {
   option gen_opt     ('g', "gen",      "Generator",                 option::required_arguments);
   option det_opt     ('d', "det",      "Detector",                  option::required_arguments);
   option shift_opt   (0,   "shift",    "Shift Last Earth Layer",    option::required_arguments);
+  option physics_opt (0,   "physics",  "Physics List",              option::required_arguments);
   option data_opt    ('o' ,"out",      "Data Output Directory",     option::required_arguments);
+  option file_opt    (0,   "file",     "Data Output File",          option::required_arguments);
   option export_opt  ('E', "export",   "Export Output Directory",   option::required_arguments);
+  option cache_opt   (0,   "cache",    "Geometry Cache Directory",  option::required_arguments);
   option script_opt  ('s', "script",   "Custom Script",             option::required_arguments);
   option events_opt  ('e', "events",   "Event Count",               option::required_arguments);
   option save_all_opt(0,   "save_all", "Save All Generator Events", option::no_arguments);
+  option float_opt   (0,   "float",    "Single Precision Output",   option::no_arguments);
+  option columns_opt (0,   "columns",  "Detector Data Columns",     option::required_arguments);
+  option seed_opt    (0,   "seed",     "Random Seed",               option::required_arguments);
+  option replay_opt  (0,   "replay",   "Replay Event IDs",          option::required_arguments);
+  option shard_opt   (0,   "shard",    "Process Shard i/N",         option::required_arguments);
+  option resume_opt  (0,   "resume",   "Resume from Checkpoint",    option::required_arguments);
   option vis_opt     ('v', "vis",      "Visualization",             option::no_arguments);
   option quiet_opt   ('q', "quiet",    "Quiet Mode",                option::no_arguments);
+  option task_opt    (0,   "tasking",  "Task-Based Run Manager",    option::no_arguments);
+  option fast_opt    (0,   "fast_muons", "Fast Muon Transport",       option::no_arguments);
   option thread_opt  ('j', "threads",
-    "Multi-Threading Mode: Specify Optional number of threads (default: 2)",
+    "Multi-Threading Mode: Specify Optional number of threads or auto (default: 2)",
     option::optional_arguments);
 
-  //TODO: pass quiet argument to builder and action initiaization to improve quietness
-
   const auto script_argc = -1 + util::cli::parse(argv,
-    {&help_opt, &gen_opt, &det_opt, &shift_opt, &data_opt, &export_opt, &script_opt, &events_opt,
-     &save_all_opt, &vis_opt, &quiet_opt, &thread_opt});
+    {&help_opt, &gen_opt, &det_opt, &shift_opt, &physics_opt, &data_opt, &file_opt, &export_opt, &cache_opt, &script_opt,
+     &events_opt, &save_all_opt, &float_opt, &columns_opt, &seed_opt, &replay_opt, &shard_opt, &resume_opt, &vis_opt, &quiet_opt, &task_opt, &fast_opt, &thread_opt});
 
   util::error::exit_when(script_argc && !script_opt.argument,
     "[FATAL ERROR] Illegal Forwarding Arguments:\n"
@@ -66,20 +94,79 @@ int main(int argc, char* argv[]) {
   G4UIExecutive* ui = nullptr;
   if (argc == 1 || vis_opt.count) {
     ui = new G4UIExecutive(argc, argv);
+#ifdef MU__WITH_VIS
     vis_opt.count = 1;
+#else
+    util::error::exit_when(vis_opt.count,
+      "[FATAL ERROR] Visualization Unavailable:\n",
+      "              Rebuild with MU_WITH_VIS to use --vis.\n");
+#endif
   }
 
   util::error::exit_when(script_opt.argument && events_opt.argument,
     "[FATAL ERROR] Incompatible Arguments:\n",
     "              A script OR an event count can be provided, but not both.\n");
 
+  std::size_t shard_index{}, shard_count = 1UL;
+  if (shard_opt.argument) {
+    std::vector<std::string> shard_tokens;
+    util::string::split(shard_opt.argument, shard_tokens, "/");
+    shard_count = 0UL;
+    if (shard_tokens.size() == 2UL) {
+      try {
+        shard_index = std::stoul(shard_tokens[0]);
+        shard_count = std::stoul(shard_tokens[1]);
+      } catch (...) {
+        shard_count = 0UL;
+      }
+    }
+    util::error::exit_when(!shard_count || shard_index >= shard_count,
+      "[FATAL ERROR] Illegal Shard Argument:\n",
+      "              Expected --shard=<index>/<count> with 0 <= index < count.\n");
+    util::error::exit_when(!seed_opt.argument,
+      "[FATAL ERROR] Missing Seed:\n",
+      "              Sharded runs must share a random seed, set with --seed.\n");
+  }
+  RunAction::SetShard(shard_index, shard_count);
+  if (file_opt.argument)
+    RunAction::SetOutputFile(file_opt.argument);
+
+  long seed = static_cast<long>(time(nullptr));
+  if (seed_opt.argument)
+    util::error::exit_when(!util::string::to_long(seed_opt.argument, seed),
+      "[FATAL ERROR] Illegal Seed Argument:\n",
+      "              Expected --seed=<integer>.\n");
+
+  int last_replay_event = -1;
+  if (replay_opt.argument) {
+    std::vector<std::string> replay_ids;
+    util::string::split(replay_opt.argument, replay_ids, ", ");
+    for (const auto& id : replay_ids) {
+      if (id.empty())
+        continue;
+      long event{};
+      util::error::exit_when(!util::string::to_long(id, event) || event < 0 || event > std::numeric_limits<int>::max(),
+        "[FATAL ERROR] Illegal Replay Argument: ", id, "\n",
+        "              Expected --replay=<event IDs> with non-negative integer IDs.\n");
+      last_replay_event = std::max(last_replay_event, static_cast<int>(event));
+    }
+  }
   G4Random::setTheEngine(new CLHEP::RanecuEngine);
-  G4Random::setTheSeed(time(nullptr));
+  G4Random::setTheSeed(shard_count > 1UL
+    ? static_cast<long>(util::random::mix(static_cast<std::uint64_t>(seed), shard_index) & 0x7FFFFFFFULL)
+    : seed);
+  util::random::set_run_seed(static_cast<std::uint64_t>(seed));
+
+  util::error::exit_when(resume_opt.argument && !RunAction::Resume(resume_opt.argument),
+    "[FATAL ERROR] Unable to Resume from Checkpoint: ", resume_opt.argument ? resume_opt.argument : "", "\n",
+    "              Expected a run<k>.checkpoint manifest written by /data/checkpoint.\n");
 
   if (thread_opt.argument) {
     auto opt = std::string(thread_opt.argument);
     if (opt == "on") {
       thread_opt.count = 2;
+    } else if (opt == "auto") {
+      thread_opt.count = static_cast<std::size_t>(std::max(1, G4Threading::G4GetNumberOfCores()));
     } else if (opt == "off" || opt == "0") {
       thread_opt.count = 1;
     } else {
@@ -92,10 +179,18 @@ int main(int argc, char* argv[]) {
   } else if (!thread_opt.count) {
     thread_opt.count = 2;
   }
+#if G4VERSION_NUMBER >= 1070
+  auto run = task_opt.count ? new G4TaskRunManager : new G4MTRunManager;
+#else
+  util::error::exit_when(task_opt.count,
+    "[FATAL ERROR] Task-Based Run Manager Unavailable:\n",
+    "              --tasking requires Geant4 10.7 or later.\n");
   auto run = new G4MTRunManager;
+#endif
   run->SetNumberOfThreads(thread_opt.count);
   std::cout << "Running " << thread_opt.count
-            << (thread_opt.count > 1 ? " Threads" : " Thread") << "\n";
+            << (thread_opt.count > 1 ? " Threads" : " Thread")
+            << (task_opt.count ? " (Tasking)\n" : "\n");
 
   run->SetPrintProgress(1000);
   run->SetRandomNumberStore(false);
@@ -105,34 +200,81 @@ int main(int argc, char* argv[]) {
   if (shift_opt.argument)
     Earth::LastShift(std::stold(shift_opt.argument) * m);
 
-  auto physics = new FTFP_BERT;
+  const std::string physics_name = physics_opt.argument ? physics_opt.argument : "FTFP_BERT";
+  G4VModularPhysicsList* physics = nullptr;
+  if (physics_name == "FTFP_BERT") {
+    physics = new FTFP_BERT;
+  } else if (physics_name == "muon") {
+    physics = new G4VModularPhysicsList;
+    physics->RegisterPhysics(new G4EmStandardPhysics);
+    physics->RegisterPhysics(new G4DecayPhysics);
+  } else {
+    G4PhysListFactory factory;
+    util::error::exit_when(!factory.IsReferencePhysList(physics_name),
+      "[FATAL ERROR] Unknown Physics List: ", physics_name, "\n",
+      "              Expected muon or a Geant4 reference list such as FTFP_BERT.\n");
+    physics = factory.GetReferencePhysList(physics_name);
+  }
   physics->RegisterPhysics(new G4StepLimiterPhysics);
+  // after the physics constructors, which reset the EM parameters; the kill policy needs CSDA ranges
+  G4EmParameters::Instance()->SetBuildCSDARange(true);
+  if (fast_opt.count) {
+    auto fast_physics = new G4FastSimulationPhysics;
+    fast_physics->ActivateFastSimulation("mu-");
+    fast_physics->ActivateFastSimulation("mu+");
+    physics->RegisterPhysics(fast_physics);
+  }
+  Physics::MuonTransportModel::SetRegistered(fast_opt.count);
   run->SetUserInitialization(physics);
 
   const auto detector = det_opt.argument ? det_opt.argument : "Prototype";
   const auto export_dir = export_opt.argument ? export_opt.argument : "";
   run->SetUserInitialization(new Construction::Builder(detector, export_dir, save_all_opt.count));
+  if (cache_opt.argument)
+    Construction::Builder::SetCacheDirectory(cache_opt.argument);
+  Construction::Builder::SetMaterialDump(ui && !quiet_opt.count);
+  Construction::Builder::SetQuiet(quiet_opt.count);
+
+  Analysis::ROOT::SetSinglePrecision(float_opt.count);
+  if (columns_opt.argument) {
+    Analysis::ROOT::DataKeyList columns;
+    util::string::split(columns_opt.argument, columns, ", ");
+    Analysis::ROOT::SetColumnSelection(columns);
+  }
 
   const auto generator = gen_opt.argument ? gen_opt.argument : "basic";
   const auto data_dir = data_opt.argument ? data_opt.argument : "data";
-  run->SetUserInitialization(new ActionInitialization(generator, data_dir));
+  run->SetUserInitialization(new ActionInitialization(generator, data_dir, quiet_opt.count));
 
-  auto vis = new G4VisExecutive("Quiet");
-  vis->Initialize();
+#ifdef MU__WITH_VIS
+  G4VisExecutive* vis = nullptr;
+  if (vis_opt.count) {
+    vis = new G4VisExecutive("Quiet");
+    vis->Initialize();
+  }
+#endif
 
-  Command::Execute("/run/initialize",
-                   "/control/saveHistory scripts/G4History",
-                   "/control/stopSavingHistory");
+  Command::Execute("/run/initialize");
+  if (ui)
+    Command::Execute("/control/saveHistory scripts/G4History",
+                     "/control/stopSavingHistory");
 
   Command::Execute(quiet_opt.count ? "/control/execute scripts/settings/quiet"
                                    : "/control/execute scripts/settings/verbose");
 
   if (vis_opt.count) {
-    Command::Execute("/control/execute scripts/settings/init_vis");
+    Command::Execute(quiet_opt.count ? "/vis/verbose 0" : "/vis/verbose 2",
+                     "/control/execute scripts/settings/init_vis");
     if (ui->IsGUI())
       Command::Execute("/control/execute scripts/settings/init_gui");
   }
 
+  if (replay_opt.argument) {
+    Command::Execute("/gen/replay " + std::string(replay_opt.argument));
+    if (!script_opt.argument && !events_opt.argument && last_replay_event >= 0)
+      Command::Execute("/run/beamOn " + std::to_string(last_replay_event + 1));
+  }
+
   if (script_opt.argument) {
     util::error::exit_when(script_argc % 2,
       "[FATAL ERROR] Illegal Number of Script Forwarding Arguments:\n",
@@ -156,7 +298,9 @@ int main(int argc, char* argv[]) {
     delete ui;
   }
 
+#ifdef MU__WITH_VIS
   delete vis;
+#endif
   delete run;
   return 0;
 }
@@ -17,15 +17,24 @@
 
 #include "tracking.hh"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <numeric>
+#include <unordered_map>
 
 #include <Geant4/G4SDManager.hh>
 #include <Geant4/G4RunManager.hh>
+#include <Geant4/G4VVisManager.hh>
+#include <Geant4/G4AutoLock.hh>
 #include <Geant4/tls.hh>
 
+#include "perf.hh"
 #include "physics/Units.hh"
 #include "ui.hh"
 
+#include "util/random.hh"
+
 namespace MATHUSLA { namespace MU {
 
 namespace Tracking { ///////////////////////////////////////////////////////////////////////////
@@ -38,12 +47,12 @@ G4ThreadLocal G4Allocator<Hit>* HitAllocator = nullptr;
 Hit::Hit(const G4ParticleDefinition* particle,
          const int track,
          const int parent,
-         const std::string& chamber,
+         const int detector,
          const double deposit,
          const G4LorentzVector position,
          const G4LorentzVector momentum)
     : G4VHit(), _particle(particle), _trackID(track), _parentID(parent),
-      _chamberID(chamber), _deposit(deposit), _position(position),
+      _detectorID(detector), _deposit(deposit), _position(position),
       _momentum(momentum) {}
 //----------------------------------------------------------------------------------------------
 
@@ -56,15 +65,33 @@ Hit::Hit(const G4Step* step,
   const auto step_point = post ? step->GetPostStepPoint()
                                : step->GetPreStepPoint();
 
-  _particle  = track->GetParticleDefinition();
-  _trackID   = track->GetTrackID();
-  _parentID  = track->GetParentID();
-  _chamberID = track->GetTouchable()->GetHistory()->GetTopVolume()->GetName();
-  _deposit   = step->GetTotalEnergyDeposit()                / Units::Energy;
-  _position  = G4LorentzVector(step_point->GetGlobalTime()  / Units::Time,
-                               step_point->GetPosition()    / Units::Length);
-  _momentum  = G4LorentzVector(step_point->GetTotalEnergy() / Units::Energy,
-                               step_point->GetMomentum()    / Units::Momentum);
+  _particle   = track->GetParticleDefinition();
+  _trackID    = track->GetTrackID();
+  _parentID   = track->GetParentID();
+  _detectorID = track->GetTouchable()->GetHistory()->GetTopVolume()->GetCopyNo();
+  _deposit    = step->GetTotalEnergyDeposit()                / Units::Energy;
+  _position   = G4LorentzVector(step_point->GetGlobalTime()  / Units::Time,
+                                step_point->GetPosition()    / Units::Length);
+  _momentum   = G4LorentzVector(step_point->GetTotalEnergy() / Units::Energy,
+                                step_point->GetMomentum()    / Units::Momentum);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Absorb Hit into Aggregated Hit______________________________________________________________
+void Hit::Absorb(const Hit& other,
+                 const bool weighted) {
+  const auto total = _deposit + other._deposit;
+  auto position = other._position.t() < _position.t() ? other._position : _position;
+  if (weighted && total > 0.0)
+    position.setVect((_deposit * _position.vect() + other._deposit * other._position.vect()) / total);
+  if (other._position.t() < _position.t()) {
+    _particle = other._particle;
+    _trackID  = other._trackID;
+    _parentID = other._parentID;
+    _momentum = other._momentum;
+  }
+  _position = position;
+  _deposit  = total;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -82,7 +109,7 @@ void Hit::Print(std::ostream& os) const {
   os << " "            << GetParticleName()
      << " | "          << _trackID
      << " | "          << _parentID
-     << " | "          << _chamberID
+     << " | "          << _detectorID
      << " | Deposit: " << std::setw(WIDTH) << G4BestUnit(_deposit * Units::Energy, "Energy")
      << " | ["
       << std::setw(WIDTH) << G4BestUnit(_position.t() * Units::Time, "Time") << " "
@@ -141,7 +168,7 @@ std::ostream& operator<<(std::ostream& os,
         + hit->GetParticleName().length()
         + std::to_string(new_trackID).length()
         + std::to_string(hit->GetParentID()).length()
-        + hit->GetChamberID().length();
+        + std::to_string(hit->GetDetectorID()).length();
       os << std::string(barlength, '-') << '\n';
     }
 
@@ -165,80 +192,762 @@ HitCollection* GenerateHitCollection(G4VSensitiveDetector* detector,
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
-//__Convert HitCollection to Analysis Form______________________________________________________
-template<class NameMap>
-const Analysis::ROOT::DataEntryList _convert_to_analysis(const HitCollection* collection,
-                                                         NameMap name_map) {
-  constexpr const std::size_t column_count = 14UL;
+//__Push Back to Integer Column_________________________________________________________________
+inline void _push_back(Analysis::ROOT::IntegerDataEntry* column,
+                       const int value) {
+  if (column) column->push_back(value);
+}
+//----------------------------------------------------------------------------------------------
 
-  Analysis::ROOT::DataEntryList out;
-  out.reserve(column_count);
+//__Reserve Integer Column______________________________________________________________________
+inline void _reserve(Analysis::ROOT::IntegerDataEntry* column,
+                     const std::size_t size) {
+  if (column) column->reserve(size);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Copy Column into Detached Vector____________________________________________________________
+void _extract(const Analysis::ROOT::RealColumn& column,
+              std::vector<double>& out) {
+  const auto size = column.size();
+  for (std::size_t i{}; i < size; ++i)
+    out.push_back(column[i]);
+}
+void _extract(const Analysis::ROOT::IntegerDataEntry* column,
+              std::vector<int>& out) {
+  if (column) out.insert(out.end(), column->cbegin(), column->cend());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Copy Detached Vector into Column____________________________________________________________
+void _restore(const std::vector<double>& data,
+              Analysis::ROOT::RealColumn& column) {
+  column.clear();
+  column.reserve(data.size());
+  for (const auto value : data)
+    column.push_back(value);
+}
+void _restore(const std::vector<int>& data,
+              Analysis::ROOT::IntegerDataEntry* column) {
+  if (column) column->assign(data.cbegin(), data.cend());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sub-Event State_____________________________________________________________________________
+struct _sub_event_entry {
+  HitData hits;
+  Physics::ParticleVector particles;
+  std::size_t parts;
+};
+std::unordered_map<std::size_t, _sub_event_entry> _sub_events;
+G4Mutex _sub_event_mutex = G4MUTEX_INITIALIZER;
+G4ThreadLocal std::size_t _sub_event_key{};
+G4ThreadLocal std::size_t _sub_event_count = 1UL;
+G4ThreadLocal std::size_t _sub_event_part{};
+//----------------------------------------------------------------------------------------------
+
+//__Overlay Readout Frame State_________________________________________________________________
+struct _overlay_frame {
+  HitData hits;
+  Physics::ParticleVector particles;
+  std::size_t parts;
+  double time;
+};
+std::size_t _overlay_events = 1UL;
+double _overlay_rate = 1*hertz;
+std::size_t _overlay_trigger = 1UL;
+G4ThreadLocal _overlay_frame* _frame = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Settings____________________________________________________________________________
+std::size_t _trigger_hits = 1UL;
+std::size_t _trigger_layers{};
+double _trigger_deposit{};
+double _trigger_window{};
+std::function<int(int)> _trigger_layer = [](const int) { return 0; };
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Hit with Layer______________________________________________________________________
+struct _trigger_hit {
+  double time;
+  int layer;
+};
+//----------------------------------------------------------------------------------------------
 
-  const auto size = collection->GetSize();
-  for (std::size_t i = 0; i < column_count; ++i) {
-    Analysis::ROOT::DataEntry entry;
-    entry.reserve(size);
-    out.push_back(entry);
+//__Count Layer in Trigger Window_______________________________________________________________
+std::size_t _add_layer(std::vector<std::pair<int, std::size_t>>& counts,
+                       const int layer,
+                       const int change) {
+  for (auto it = counts.begin(); it != counts.end(); ++it) {
+    if (it->first != layer)
+      continue;
+    it->second += change;
+    if (!it->second)
+      counts.erase(it);
+    return counts.size();
   }
+  if (change > 0)
+    counts.emplace_back(layer, 1UL);
+  return counts.size();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Hit Aggregation Settings____________________________________________________________________
+AggregationMode _aggregation_mode = AggregationMode::Off;
+double _aggregation_window = 10*ns;
+bool _aggregation_weighted = false;
+//----------------------------------------------------------------------------------------------
+
+//__Hit Aggregation Key_________________________________________________________________________
+std::uint64_t _aggregation_key(const int detector,
+                               const int track) {
+  const auto key = static_cast<std::uint64_t>(static_cast<std::uint32_t>(detector));
+  return _aggregation_mode == AggregationMode::Track
+    ? key << 32 | static_cast<std::uint32_t>(track)
+    : key;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Digitization Settings_______________________________________________________________________
+DigitizationMode _digitization_mode = DigitizationMode::Off;
+double _digitization_window = 20*ns;
+//----------------------------------------------------------------------------------------------
+
+//__Append Single Hit to Detached Hit Data______________________________________________________
+void _append(const HitData& in,
+             const std::size_t index,
+             const double deposit,
+             HitData& out) {
+  out.deposit.push_back(deposit);
+  out.time.push_back(in.time[index]);
+  out.detector.push_back(in.detector[index]);
+  out.pdg.push_back(in.pdg[index]);
+  out.track.push_back(in.track[index]);
+  out.parent.push_back(in.parent[index]);
+  out.x.push_back(in.x[index]);
+  out.y.push_back(in.y[index]);
+  out.z.push_back(in.z[index]);
+  out.e.push_back(in.e[index]);
+  out.px.push_back(in.px[index]);
+  out.py.push_back(in.py[index]);
+  out.pz.push_back(in.pz[index]);
+  out.weight.push_back(in.weight[index]);
+}
+//----------------------------------------------------------------------------------------------
 
-  for (std::size_t i = 0; i < size; ++i) {
-    const auto hit = dynamic_cast<Hit*>(collection->GetHit(i));
-    out[0].push_back(hit->GetDeposit());
-    out[1].push_back(hit->GetPosition().t());
-    out[2].push_back(name_map(hit->GetChamberID()));
-    out[3].push_back(hit->GetPDGEncoding());
-    out[4].push_back(hit->GetTrackID());
-    out[5].push_back(hit->GetParentID());
-    out[6].push_back(hit->GetPosition().x());
-    out[7].push_back(hit->GetPosition().y());
-    out[8].push_back(hit->GetPosition().z());
-    out[9].push_back(hit->GetMomentum().e());
-    out[10].push_back(hit->GetMomentum().px());
-    out[11].push_back(hit->GetMomentum().py());
-    out[12].push_back(hit->GetMomentum().pz());
-    out[13].push_back(1);
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Hit Aggregation Mode________________________________________________________________________
+void SetAggregationMode(const AggregationMode mode) {
+  _aggregation_mode = mode;
+}
+AggregationMode GetAggregationMode() {
+  return _aggregation_mode;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Hit Aggregation Time Window_________________________________________________________________
+void SetAggregationWindow(const double window) {
+  _aggregation_window = window;
+}
+double GetAggregationWindow() {
+  return _aggregation_window;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Hit Aggregation Energy-Weighted Position____________________________________________________
+void SetAggregationWeighted(const bool weighted) {
+  _aggregation_weighted = weighted;
+}
+bool IsAggregationWeighted() {
+  return _aggregation_weighted;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Find Aggregated Hit for Detector and Track__________________________________________________
+std::size_t HitAggregator::Find(const int detector,
+                                const int track,
+                                const double time) const {
+  if (_aggregation_mode == AggregationMode::Off || !_size)
+    return npos;
+  const auto slot = Probe(_aggregation_key(detector, track));
+  if (slot == npos || _slots[slot].generation != _generation)
+    return npos;
+  if (_aggregation_mode == AggregationMode::Window
+      && std::abs(time - _slots[slot].time) >= _aggregation_window / Units::Time)
+    return npos;
+  return _slots[slot].index;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Insert Aggregated Hit for Detector and Track________________________________________________
+void HitAggregator::Insert(const int detector,
+                           const int track,
+                           const double time,
+                           const std::size_t index) {
+  if (_aggregation_mode == AggregationMode::Off)
+    return;
+  if (2UL * (_size + 1UL) > _slots.size())
+    Grow();
+  const auto key = _aggregation_key(detector, track);
+  auto& slot = _slots[Probe(key)];
+  if (slot.generation != _generation)
+    ++_size;
+  slot = {key, index, time, _generation};
+}
+//----------------------------------------------------------------------------------------------
+
+//__Find Slot for Key in Open-Addressed Table___________________________________________________
+std::size_t HitAggregator::Probe(const std::uint64_t key) const {
+  if (_slots.empty())
+    return npos;
+  const auto mask = _slots.size() - 1UL;
+  auto slot = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 17) & mask;
+  while (_slots[slot].generation == _generation && _slots[slot].key != key)
+    slot = (slot + 1UL) & mask;
+  return slot;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Grow Open-Addressed Table___________________________________________________________________
+void HitAggregator::Grow() {
+  auto previous = std::move(_slots);
+  _slots.assign(previous.empty() ? 64UL : 2UL * previous.size(), Slot{0ULL, 0UL, 0.0, 0ULL});
+  _size = 0UL;
+  for (const auto& slot : previous) {
+    if (slot.generation != _generation)
+      continue;
+    _slots[Probe(slot.key)] = slot;
+    ++_size;
   }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Hit Collection is Required for Printing or Visualization___________________________
+bool IsHitCollectionRequired(const int verbose_level) {
+  return verbose_level >= 2 || G4VVisManager::GetConcreteInstance();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attach Hit Buffer to NTuple Columns_________________________________________________________
+void HitBuffer::Attach(const std::string& name,
+                       const std::size_t first_column) {
+  _deposit  = Analysis::ROOT::GetRealColumn(name, first_column);
+  _time     = Analysis::ROOT::GetRealColumn(name, first_column + 1UL);
+  _detector = Analysis::ROOT::GetIntegerColumn(name, first_column + 2UL);
+  _pdg      = Analysis::ROOT::GetIntegerColumn(name, first_column + 3UL);
+  _track    = Analysis::ROOT::GetIntegerColumn(name, first_column + 4UL);
+  _parent   = Analysis::ROOT::GetIntegerColumn(name, first_column + 5UL);
+  _x        = Analysis::ROOT::GetRealColumn(name, first_column + 6UL);
+  _y        = Analysis::ROOT::GetRealColumn(name, first_column + 7UL);
+  _z        = Analysis::ROOT::GetRealColumn(name, first_column + 8UL);
+  _e        = Analysis::ROOT::GetRealColumn(name, first_column + 9UL);
+  _px       = Analysis::ROOT::GetRealColumn(name, first_column + 10UL);
+  _py       = Analysis::ROOT::GetRealColumn(name, first_column + 11UL);
+  _pz       = Analysis::ROOT::GetRealColumn(name, first_column + 12UL);
+  _weight   = Analysis::ROOT::GetRealColumn(name, first_column + 13UL);
+  Clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Clear Hit Buffer____________________________________________________________________________
+void HitBuffer::Clear() {
+  for (auto column : {&_deposit, &_time, &_x, &_y, &_z, &_e, &_px, &_py, &_pz, &_weight})
+    column->clear();
+  for (auto column : {_detector, _pdg, _track, _parent})
+    if (column) column->clear();
+  _aggregator.Clear();
+  _size = 0UL;
+}
+//----------------------------------------------------------------------------------------------
 
+//__Hit Buffer Memory in Bytes__________________________________________________________________
+std::size_t HitBuffer::GetMemoryBytes() const {
+  auto out = _aggregator.GetMemoryBytes();
+  for (auto column : {&_deposit, &_time, &_x, &_y, &_z, &_e, &_px, &_py, &_pz, &_weight})
+    out += column->capacity_bytes();
+  for (auto column : {_detector, _pdg, _track, _parent})
+    if (column) out += column->capacity() * sizeof(int);
   return out;
 }
 //----------------------------------------------------------------------------------------------
 
-} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+//__Append Hit to Buffer________________________________________________________________________
+void HitBuffer::Append(const int pdg,
+                       const int track,
+                       const int parent,
+                       const int detector,
+                       const double deposit,
+                       const G4LorentzVector& position,
+                       const G4LorentzVector& momentum,
+                       const double weight) {
+  const auto index = _aggregator.Find(detector, track, position.t());
+  if (index != HitAggregator::npos) {
+    Merge(index, pdg, track, parent, deposit, position, momentum, weight);
+    return;
+  }
+  _aggregator.Insert(detector, track, position.t(), _size);
+
+  Perf::Count(Perf::Hits);
+
+  _deposit.push_back(deposit);
+  _time.push_back(position.t());
+  _push_back(_detector, detector);
+  _push_back(_pdg, pdg);
+  _push_back(_track, track);
+  _push_back(_parent, parent);
+  _x.push_back(position.x());
+  _y.push_back(position.y());
+  _z.push_back(position.z());
+  _e.push_back(momentum.e());
+  _px.push_back(momentum.px());
+  _py.push_back(momentum.py());
+  _pz.push_back(momentum.pz());
+  _weight.push_back(weight);
+  ++_size;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Append Hit to Buffer________________________________________________________________________
+void HitBuffer::Append(const G4Step* step,
+                       const int detector,
+                       const bool post) {
+  const auto track = step->GetTrack();
+  const auto step_point = post ? step->GetPostStepPoint()
+                               : step->GetPreStepPoint();
+  Append(track->GetParticleDefinition()->GetPDGEncoding(),
+         track->GetTrackID(),
+         track->GetParentID(),
+         detector,
+         step->GetTotalEnergyDeposit() / Units::Energy,
+         G4LorentzVector(step_point->GetGlobalTime()  / Units::Time,
+                         step_point->GetPosition()    / Units::Length),
+         G4LorentzVector(step_point->GetTotalEnergy() / Units::Energy,
+                         step_point->GetMomentum()    / Units::Momentum),
+         track->GetWeight());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Merge Step into Aggregated Hit______________________________________________________________
+void HitBuffer::Merge(const std::size_t index,
+                      const int pdg,
+                      const int track,
+                      const int parent,
+                      const double deposit,
+                      const G4LorentzVector& position,
+                      const G4LorentzVector& momentum,
+                      const double weight) {
+  if (index >= _deposit.size())
+    return;
+
+  const auto previous = _deposit[index];
+  const auto total = previous + deposit;
+  const auto earlier = position.t() < _time[index];
+  if (_aggregation_weighted && total > 0.0) {
+    _x.set(index, (previous * _x[index] + deposit * position.x()) / total);
+    _y.set(index, (previous * _y[index] + deposit * position.y()) / total);
+    _z.set(index, (previous * _z[index] + deposit * position.z()) / total);
+  } else if (earlier) {
+    _x.set(index, position.x());
+    _y.set(index, position.y());
+    _z.set(index, position.z());
+  }
+  if (earlier) {
+    _time.set(index, position.t());
+    if (_pdg)    (*_pdg)[index]    = pdg;
+    if (_track)  (*_track)[index]  = track;
+    if (_parent) (*_parent)[index] = parent;
+    _e.set(index, momentum.e());
+    _px.set(index, momentum.px());
+    _py.set(index, momentum.py());
+    _pz.set(index, momentum.pz());
+    _weight.set(index, weight);
+  }
+  _deposit.set(index, total);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Copy Hit Buffer into Detached Hit Data______________________________________________________
+void HitBuffer::Extract(HitData& out) const {
+  _extract(_deposit, out.deposit);
+  _extract(_time, out.time);
+  _extract(_detector, out.detector);
+  _extract(_pdg, out.pdg);
+  _extract(_track, out.track);
+  _extract(_parent, out.parent);
+  _extract(_x, out.x);
+  _extract(_y, out.y);
+  _extract(_z, out.z);
+  _extract(_e, out.e);
+  _extract(_px, out.px);
+  _extract(_py, out.py);
+  _extract(_pz, out.pz);
+  _extract(_weight, out.weight);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Replace Hit Buffer with Detached Hit Data___________________________________________________
+void HitBuffer::Restore(const HitData& data) {
+  _restore(data.deposit, _deposit);
+  _restore(data.time, _time);
+  _restore(data.detector, _detector);
+  _restore(data.pdg, _pdg);
+  _restore(data.track, _track);
+  _restore(data.parent, _parent);
+  _restore(data.x, _x);
+  _restore(data.y, _y);
+  _restore(data.z, _z);
+  _restore(data.e, _e);
+  _restore(data.px, _px);
+  _restore(data.py, _py);
+  _restore(data.pz, _pz);
+  _restore(data.weight, _weight);
+  _aggregator.Clear();
+  _size = data.deposit.size();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread-Local Event Hit Buffer___________________________________________________________
+HitBuffer& GetHitBuffer() {
+  static G4ThreadLocal HitBuffer _buffer{};
+  return _buffer;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attach Thread-Local Hit Buffers to Detector NTuples_________________________________________
+void AttachHitBuffers(const std::string& name) {
+  GetHitBuffer().Attach(name);
+  if (_digitization_mode == DigitizationMode::Beside)
+    GetDigitizedHitBuffer().Attach(DigitizedDataName(name));
+}
+//----------------------------------------------------------------------------------------------
 
-//__Convert HitCollection to Analysis Form______________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const HitCollection* collection) {
-  return _convert_to_analysis(collection, [](const auto& id) { return std::stold(id); });
+//__Get Thread-Local Digitized Hit Buffer_______________________________________________________
+HitBuffer& GetDigitizedHitBuffer() {
+  static G4ThreadLocal HitBuffer _buffer{};
+  return _buffer;
 }
 //----------------------------------------------------------------------------------------------
 
-//__Convert HitCollection to Analysis Form______________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const HitCollection* collection,
-                                                      const Analysis::ROOT::NameToDataMap& map) {
-  const auto map_end = map.cend();
-  return _convert_to_analysis(collection, [&](const auto& id) {
-    const auto search = map.find(id);
-    return search != map_end ? search->second : -1;
+//__Digitization Mode___________________________________________________________________________
+void SetDigitizationMode(const DigitizationMode mode) {
+  _digitization_mode = mode;
+}
+DigitizationMode GetDigitizationMode() {
+  return _digitization_mode;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Digitization Time Window____________________________________________________________________
+void SetDigitizationWindow(const double window) {
+  _digitization_window = window;
+}
+double GetDigitizationWindow() {
+  return _digitization_window;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Name of Digitized Data Tree_________________________________________________________________
+const std::string DigitizedDataName(const std::string& name) {
+  return name + "_digi";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Digitize Hits by Detector and Time Window___________________________________________________
+void Digitize(const HitData& hits,
+              const std::function<double(int)>& threshold,
+              HitData& out) {
+  const auto size = hits.deposit.size();
+  if (!size || hits.detector.size() != size)
+    return;
+
+  static G4ThreadLocal std::vector<std::size_t>* _order = nullptr;
+  if (!_order)
+    _order = new std::vector<std::size_t>;
+  auto& order = *_order;
+  order.resize(size);
+  std::iota(order.begin(), order.end(), 0UL);
+  std::sort(order.begin(), order.end(), [&](const auto left, const auto right) {
+    return hits.detector[left] != hits.detector[right] ? hits.detector[left] < hits.detector[right]
+                                                         : hits.time[left] < hits.time[right];
   });
+
+  const auto window = _digitization_window / Units::Time;
+  for (std::size_t begin{}; begin < size;) {
+    const auto detector = hits.detector[order[begin]];
+    auto end = begin;
+    while (end < size && hits.detector[order[end]] == detector)
+      ++end;
+
+    const auto minimum = threshold(detector) / Units::Energy;
+    for (auto start = begin; start < end;) {
+      const auto stop_time = hits.time[order[start]] + window;
+      auto first_above = end;
+      double summed{};
+      auto next = start;
+      for (; next < end && hits.time[order[next]] < stop_time; ++next) {
+        summed += hits.deposit[order[next]];
+        if (first_above == end && summed >= minimum)
+          first_above = next;
+      }
+      if (first_above == end) {
+        ++start;
+      } else {
+        _append(hits, order[first_above], summed, out);
+        start = next;
+      }
+    }
+    begin = end;
+  }
 }
 //----------------------------------------------------------------------------------------------
 
-//__Convert G4Event to Analysis Form____________________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const G4Event* event) {
-  constexpr const std::size_t column_count = 12UL;
+//__Mark Current Event as Part of Split Logical Event___________________________________________
+void SetSubEvent(const std::size_t key,
+                 const std::size_t count,
+                 const std::size_t part) {
+  _sub_event_key = key;
+  _sub_event_count = std::max(1UL, count);
+  _sub_event_part = part;
+}
+bool InSubEvent() {
+  return _sub_event_count > 1UL;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Merge Sub-Event Hits and Particles into Logical Event_______________________________________
+bool MergeSubEvent(Physics::ParticleVector& particles) {
+  if (!InSubEvent())
+    return true;
 
-  Analysis::ROOT::DataEntryList out;
-  out.reserve(column_count);
+  auto& buffer = GetHitBuffer();
+  G4AutoLock lock(&_sub_event_mutex);
+  auto& entry = _sub_events[_sub_event_key];
+  const auto first = entry.hits.deposit.size();
+  buffer.Extract(entry.hits);
+  // interleave track IDs of the parts, ID k of part p becomes (k - 1) * parts + p + 1
+  const auto count = static_cast<int>(_sub_event_count), part = static_cast<int>(_sub_event_part);
+  for (auto column : {&entry.hits.track, &entry.hits.parent})
+    for (auto i = first; i < column->size(); ++i)
+      if ((*column)[i] > 0)
+        (*column)[i] = ((*column)[i] - 1) * count + part + 1;
+  entry.particles.insert(entry.particles.end(), particles.cbegin(), particles.cend());
+  if (++entry.parts < _sub_event_count) {
+    buffer.Clear();
+    return false;
+  }
+
+  buffer.Restore(entry.hits);
+  particles = std::move(entry.particles);
+  _sub_events.erase(_sub_event_key);
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Drop Incomplete Logical Events______________________________________________________________
+void ClearSubEvents() {
+  G4AutoLock lock(&_sub_event_mutex);
+  _sub_events.clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Events Overlaid into One Readout Frame______________________________________________________
+void SetOverlayEvents(const std::size_t count) {
+  _overlay_events = std::max(1UL, count);
+}
+std::size_t GetOverlayEvents() {
+  return _overlay_events;
+}
+bool InOverlay() {
+  return _overlay_events > 1UL;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Overlay Event Rate__________________________________________________________________________
+void SetOverlayRate(const double rate) {
+  if (rate > 0.0)
+    _overlay_rate = rate;
+}
+double GetOverlayRate() {
+  return _overlay_rate;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Minimum Hits in Written Readout Frame_______________________________________________________
+void SetOverlayTrigger(const std::size_t hits) {
+  _overlay_trigger = std::max(1UL, hits);
+}
+std::size_t GetOverlayTrigger() {
+  return _overlay_trigger;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Overlay Event into Thread-Local Readout Frame_______________________________________________
+// Arrivals follow a Poisson process at the overlay rate, so every event is shifted by the sum of
+// exponential gaps since the start of its frame. Returns true once the frame is complete, with
+// the frame hits restored into the hit buffer and the frame particles in place of the event's.
+bool OverlayEvent(Physics::ParticleVector& particles,
+                  const std::uint64_t stream) {
+  if (!InOverlay())
+    return true;
+  if (!_frame)
+    _frame = new _overlay_frame{};
+
+  auto& frame = *_frame;
+  util::random::philox engine(util::random::run_seed(), stream);
+  frame.time -= std::log(1.0 - util::random::canonical(engine)) / _overlay_rate;
+
+  auto& buffer = GetHitBuffer();
+  const auto first = frame.hits.time.size();
+  buffer.Extract(frame.hits);
+  for (auto i = first; i < frame.hits.time.size(); ++i)
+    frame.hits.time[i] += frame.time;
+  for (auto particle : particles) {
+    particle.t += frame.time;
+    frame.particles.push_back(particle);
+  }
+
+  if (++frame.parts < _overlay_events) {
+    buffer.Clear();
+    return false;
+  }
+
+  buffer.Restore(frame.hits);
+  particles = std::move(frame.particles);
+  ClearOverlay();
+  Perf::Count(Perf::Frames);
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Drop Incomplete Readout Frame of Current Thread_____________________________________________
+void ClearOverlay() {
+  if (!_frame)
+    return;
+  _frame->hits.clear();
+  _frame->particles.clear();
+  _frame->parts = 0UL;
+  _frame->time = 0.0;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Hit Multiplicity and Distinct Layers________________________________________________
+void SetTriggerHits(const std::size_t hits) {
+  _trigger_hits = std::max(1UL, hits);
+}
+std::size_t GetTriggerHits() {
+  return _trigger_hits;
+}
+void SetTriggerLayers(const std::size_t layers) {
+  _trigger_layers = layers;
+}
+std::size_t GetTriggerLayers() {
+  return _trigger_layers;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Hit Deposit Threshold_______________________________________________________________
+void SetTriggerDeposit(const double deposit) {
+  _trigger_deposit = std::max(0.0, deposit);
+}
+double GetTriggerDeposit() {
+  return _trigger_deposit;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Coincidence Time Window_____________________________________________________________
+void SetTriggerWindow(const double window) {
+  _trigger_window = std::max(0.0, window);
+}
+double GetTriggerWindow() {
+  return _trigger_window;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Detector Layer Function for Trigger_________________________________________________________
+void SetTriggerLayerFunction(const std::function<int(int)>& layer) {
+  _trigger_layer = layer ? layer : [](const int) { return 0; };
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Trigger Selects More than Any Hit__________________________________________________
+bool IsTriggerEnabled() {
+  return _trigger_hits > 1UL || _trigger_layers > 1UL || _trigger_deposit > 0.0;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Evaluate Trigger on Hit Buffer______________________________________________________________
+// Only hits above the deposit threshold count. Without a window all of them are counted, with a
+// window the hits and distinct layers must all fall within one window of the earliest of them.
+bool Trigger(const HitBuffer& buffer) {
+  static G4ThreadLocal std::vector<_trigger_hit>* _hits = nullptr;
+  static G4ThreadLocal std::vector<std::pair<int, std::size_t>>* _layers = nullptr;
+  if (!_hits) {
+    _hits = new std::vector<_trigger_hit>;
+    _layers = new std::vector<std::pair<int, std::size_t>>;
+  }
+  auto& hits = *_hits;
+  auto& layers = *_layers;
+  hits.clear();
+  layers.clear();
+
+  const auto threshold = _trigger_deposit / Units::Energy;
+  const auto size = buffer.GetSize();
+  for (std::size_t i{}; i < size; ++i)
+    if (buffer.GetDeposit(i) >= threshold)
+      hits.push_back({buffer.GetTime(i), _trigger_layer(buffer.GetDetector(i))});
+  if (hits.size() < _trigger_hits)
+    return false;
+
+  if (_trigger_window <= 0.0) {
+    std::size_t layer_count{};
+    for (const auto& hit : hits)
+      layer_count = _add_layer(layers, hit.layer, 1);
+    return layer_count >= _trigger_layers;
+  }
+
+  std::sort(hits.begin(), hits.end(),
+    [](const auto& left, const auto& right) { return left.time < right.time; });
+  const auto window = _trigger_window / Units::Time;
+  std::size_t first{};
+  for (std::size_t last{}; last < hits.size(); ++last) {
+    auto layer_count = _add_layer(layers, hits[last].layer, 1);
+    while (hits[last].time - hits[first].time > window)
+      layer_count = _add_layer(layers, hits[first++].layer, -1);
+    if (last + 1UL - first >= _trigger_hits && layer_count >= _trigger_layers)
+      return true;
+  }
+  return false;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Convert G4Event to Analysis Form____________________________________________________________
+std::size_t ConvertToAnalysis(const G4Event* event,
+                              const std::string& name,
+                              const std::size_t first_column) {
+  Perf::Scope scope(Perf::Conversion);
+  auto pdg    = Analysis::ROOT::GetIntegerColumn(name, first_column);
+  auto track  = Analysis::ROOT::GetIntegerColumn(name, first_column + 1UL);
+  auto parent = Analysis::ROOT::GetIntegerColumn(name, first_column + 2UL);
+  auto t      = Analysis::ROOT::GetRealColumn(name, first_column + 3UL);
+  auto x      = Analysis::ROOT::GetRealColumn(name, first_column + 4UL);
+  auto y      = Analysis::ROOT::GetRealColumn(name, first_column + 5UL);
+  auto z      = Analysis::ROOT::GetRealColumn(name, first_column + 6UL);
+  auto e      = Analysis::ROOT::GetRealColumn(name, first_column + 7UL);
+  auto px     = Analysis::ROOT::GetRealColumn(name, first_column + 8UL);
+  auto py     = Analysis::ROOT::GetRealColumn(name, first_column + 9UL);
+  auto pz     = Analysis::ROOT::GetRealColumn(name, first_column + 10UL);
+  auto weight = Analysis::ROOT::GetRealColumn(name, first_column + 11UL);
 
   std::size_t size{};
   const auto vertex_count = event->GetNumberOfPrimaryVertex();
   for (auto i = 0; i < vertex_count; ++i)
     size += event->GetPrimaryVertex(i)->GetNumberOfParticle();
 
-  for (std::size_t i{}; i < column_count; ++i) {
-    Analysis::ROOT::DataEntry entry;
-    entry.reserve(size);
-    out.push_back(entry);
-  }
+  for (auto column : {&t, &x, &y, &z, &e, &px, &py, &pz, &weight})
+    column->reserve(size);
+  for (auto column : {pdg, track, parent})
+    _reserve(column, size);
 
   for (auto i = 0; i < vertex_count; ++i) {
     const auto vertex = event->GetPrimaryVertex(i);
@@ -246,83 +955,87 @@ const Analysis::ROOT::DataEntryList ConvertToAnalysis(const G4Event* event) {
     for (auto j = 0; j < vertex_size; ++j) {
       const auto primary = vertex->GetPrimary(j);
 
-      out[0].push_back(primary->GetPDGcode());
-      out[1].push_back(primary->GetTrackID());
-      out[2].push_back(0);
+      _push_back(pdg, primary->GetPDGcode());
+      _push_back(track, primary->GetTrackID());
+      _push_back(parent, 0);
 
-      out[3].push_back(vertex->GetT0() / Units::Time);
-      out[4].push_back(vertex->GetX0() / Units::Length);
-      out[5].push_back(vertex->GetY0() / Units::Length);
-      out[6].push_back(vertex->GetZ0() / Units::Length);
-      out[7].push_back(primary->GetTotalEnergy() / Units::Energy);
+      t.push_back(vertex->GetT0() / Units::Time);
+      x.push_back(vertex->GetX0() / Units::Length);
+      y.push_back(vertex->GetY0() / Units::Length);
+      z.push_back(vertex->GetZ0() / Units::Length);
+      e.push_back(primary->GetTotalEnergy() / Units::Energy);
 
       const auto momentum = primary->GetMomentum();
-      out[8].push_back(momentum.x() / Units::Momentum);
-      out[9].push_back(momentum.y() / Units::Momentum);
-      out[10].push_back(momentum.z() / Units::Momentum);
-      out[11].push_back(1);
-
+      px.push_back(momentum.x() / Units::Momentum);
+      py.push_back(momentum.y() / Units::Momentum);
+      pz.push_back(momentum.z() / Units::Momentum);
+      weight.push_back(primary->GetWeight());
     }
   }
 
-  return out;
+  return size;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Convert ParticleVector to Analysis Form_____________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const Physics::ParticleVector& particles) {
-  constexpr const std::size_t column_count = 12UL;
-
-  Analysis::ROOT::DataEntryList out;
-  out.reserve(column_count);
+std::size_t ConvertToAnalysis(const Physics::ParticleView particles,
+                              const std::string& name,
+                              const std::size_t first_column) {
+  Perf::Scope scope(Perf::Conversion);
+  auto pdg    = Analysis::ROOT::GetIntegerColumn(name, first_column);
+  auto track  = Analysis::ROOT::GetIntegerColumn(name, first_column + 1UL);
+  auto parent = Analysis::ROOT::GetIntegerColumn(name, first_column + 2UL);
+  auto t      = Analysis::ROOT::GetRealColumn(name, first_column + 3UL);
+  auto x      = Analysis::ROOT::GetRealColumn(name, first_column + 4UL);
+  auto y      = Analysis::ROOT::GetRealColumn(name, first_column + 5UL);
+  auto z      = Analysis::ROOT::GetRealColumn(name, first_column + 6UL);
+  auto e      = Analysis::ROOT::GetRealColumn(name, first_column + 7UL);
+  auto px     = Analysis::ROOT::GetRealColumn(name, first_column + 8UL);
+  auto py     = Analysis::ROOT::GetRealColumn(name, first_column + 9UL);
+  auto pz     = Analysis::ROOT::GetRealColumn(name, first_column + 10UL);
+  auto weight = Analysis::ROOT::GetRealColumn(name, first_column + 11UL);
 
   const auto size = particles.size();
 
-  for (std::size_t i{}; i < column_count; ++i) {
-    Analysis::ROOT::DataEntry entry;
-    entry.reserve(size);
-    out.push_back(entry);
-  }
+  for (auto column : {&t, &x, &y, &z, &e, &px, &py, &pz, &weight})
+    column->reserve(size);
+  for (auto column : {pdg, track, parent})
+    _reserve(column, size);
 
   for (std::size_t index{}; index < size; ++index) {
     const auto& particle = particles[index];
-    out[0].push_back(particle.id);
-    out[1].push_back(index);
-    out[2].push_back(0);
-    out[3].push_back(particle.t / Units::Time);
-    out[4].push_back(particle.x / Units::Length);
-    out[5].push_back(particle.y / Units::Length);
-    out[6].push_back(particle.z / Units::Length);
-    out[7].push_back(particle.e() / Units::Energy);
-    out[8].push_back(particle.px / Units::Momentum);
-    out[9].push_back(particle.py / Units::Momentum);
-    out[10].push_back(particle.pz / Units::Momentum);
-    out[11].push_back(1);
+    _push_back(pdg, particle.id);
+    _push_back(track, static_cast<int>(index));
+    _push_back(parent, 0);
+    t.push_back(particle.t / Units::Time);
+    x.push_back(particle.x / Units::Length);
+    y.push_back(particle.y / Units::Length);
+    z.push_back(particle.z / Units::Length);
+    e.push_back(particle.e() / Units::Energy);
+    px.push_back(particle.px / Units::Momentum);
+    py.push_back(particle.py / Units::Momentum);
+    pz.push_back(particle.pz / Units::Momentum);
+    weight.push_back(particle.weight);
   }
 
-  return out;
+  return size;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Convert Extra to Analysis Form______________________________________________________________
-const Analysis::ROOT::DataEntryList ConvertToAnalysis(const std::vector<std::vector<double>>& extra) {
+std::size_t ConvertToAnalysis(const std::vector<std::vector<double>>& extra,
+                              const std::string& name,
+                              const std::size_t first_column) {
+  Perf::Scope scope(Perf::Conversion);
   constexpr const std::size_t column_count = 16UL;
-  Analysis::ROOT::DataEntryList out;
-  out.reserve(column_count);
+  const auto size = std::min(column_count, extra.size());
 
-  for (std::size_t i{}; i < column_count; ++i) {
-    Analysis::ROOT::DataEntry entry;
-    entry.reserve(extra[i].size());
-    out.push_back(entry);
+  for (std::size_t i{}; i < size; ++i) {
+    const auto& extra_i = extra[i];
+    Analysis::ROOT::GetRealColumn(name, first_column + i).append(extra_i.cbegin(), extra_i.cend());
   }
 
-  for (std::size_t i{}; i < column_count; ++i) {
-    const auto extra_i = extra[i];
-    for (std::size_t index{}; index < extra_i.size(); ++index)
-      out[i].push_back(extra_i[index]);
-  }
-
-  return out;
+  return size;
 }
 //----------------------------------------------------------------------------------------------
 